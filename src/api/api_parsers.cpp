@@ -24,6 +24,7 @@ Revision History:
 #include "cmd_context/cmd_context.h"
 #include "smt/smt_solver.h"
 #include "parsers/smt2/smt2parser.h"
+#include "parsers/smt2/marshal.h"
 #include "solver/solver_na2as.h"
 
 
@@ -170,4 +171,38 @@ extern "C" {
         RETURN_Z3(mk_c(c)->mk_external_string(ous.str()));
         Z3_CATCH_RETURN(mk_c(c)->mk_external_string(ous.str()));
     }
+
+    Z3_char_ptr Z3_API Z3_marshal_ast(Z3_context c, Z3_ast a, unsigned* length) {
+        Z3_TRY;
+        LOG_Z3_marshal_ast(c, a, length);
+        RESET_ERROR_CODE();
+        if (!length) {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "length argument is null");
+            return "";
+        }
+        CHECK_IS_EXPR(a, "");
+        ast_manager& m = mk_c(c)->m();
+        std::string s = marshal(expr_ref(to_expr(a), m), m);
+        auto& buffer = mk_c(c)->m_char_buffer;
+        buffer.reset();
+        buffer.append(static_cast<unsigned>(s.size()), s.data());
+        *length = buffer.size();
+        return buffer.data();
+        Z3_CATCH_RETURN("");
+    }
+
+    Z3_ast Z3_API Z3_unmarshal_ast(Z3_context c, unsigned length, Z3_string s) {
+        Z3_TRY;
+        LOG_Z3_unmarshal_ast(c, length, s);
+        RESET_ERROR_CODE();
+        ast_manager& m = mk_c(c)->m();
+        expr_ref e = unmarshal(std::string(s, length), m);
+        if (!e) {
+            SET_ERROR_CODE(Z3_PARSER_ERROR, "invalid marshaled expression");
+            RETURN_Z3(nullptr);
+        }
+        mk_c(c)->save_ast_trail(e);
+        RETURN_Z3(of_ast(e));
+        Z3_CATCH_RETURN(nullptr);
+    }
 };
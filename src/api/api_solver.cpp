@@ -704,6 +704,22 @@ extern "C" {
         Z3_CATCH_RETURN(nullptr);
     }
 
+    Z3_string Z3_API Z3_solver_get_qi_profile(Z3_context c, Z3_solver s, Z3_string format) {
+        Z3_TRY;
+        LOG_Z3_solver_get_qi_profile(c, s, format);
+        RESET_ERROR_CODE();
+        init_solver(c, s);
+        std::string fmt = format ? format : "json";
+        if (fmt != "json" && fmt != "csv") {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "format must be \"json\" or \"csv\"");
+            return "";
+        }
+        std::ostringstream buffer;
+        to_solver_ref(s)->display_qi_profile(buffer, fmt == "csv");
+        return mk_c(c)->mk_external_string(buffer.str());
+        Z3_CATCH_RETURN("");
+    }
+
     Z3_string Z3_API Z3_solver_to_string(Z3_context c, Z3_solver s) {
         Z3_TRY;
         LOG_Z3_solver_to_string(c, s);
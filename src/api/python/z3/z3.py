@@ -6886,6 +6886,12 @@ class Solver(Z3PPObject):
         """
         return Statistics(Z3_solver_get_statistics(self.ctx.ref(), self.solver), self.ctx)
 
+    def qi_profile(self, format="json"):
+        """Return the profile of quantifier instantiation as a string in JSON or CSV format.
+        The profile is collected when the parameter `smt.qi.profile` is enabled.
+        """
+        return Z3_solver_get_qi_profile(self.ctx.ref(), self.solver, format)
+
     def reason_unknown(self):
         """Return a string describing why the last `check()` returned `unknown`.
 
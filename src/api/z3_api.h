@@ -5588,6 +5588,33 @@ extern "C" {
 
     Z3_string Z3_API Z3_eval_smtlib2_string(Z3_context, Z3_string str);
 
+    /**
+       \brief Serialize the expression \c a into a compact binary format.
+       The encoding preserves sharing of sub-expressions and can be loaded
+       into another context using #Z3_unmarshal_ast.
+
+       The result is not null-terminated and may contain null characters.
+       Its size is stored in \c length. The buffer is valid until the next
+       call to this function or #Z3_get_lstring.
+
+       \sa Z3_unmarshal_ast
+
+       def_API('Z3_marshal_ast', CHAR_PTR, (_in(CONTEXT), _in(AST), _out(UINT)))
+    */
+    Z3_char_ptr Z3_API Z3_marshal_ast(Z3_context c, Z3_ast a, unsigned* length);
+
+    /**
+       \brief Load an expression produced by #Z3_marshal_ast.
+       The first \c length characters of \c s are used.
+       SMT-LIB2 text containing assertions is also accepted;
+       the result is then the conjunction of the assertions.
+
+       \sa Z3_marshal_ast
+
+       def_API('Z3_unmarshal_ast', AST, (_in(CONTEXT), _in(UINT), _in(STRING)))
+    */
+    Z3_ast Z3_API Z3_unmarshal_ast(Z3_context c, unsigned length, Z3_string s);
+
     /*@}*/
 
     /** @name Error Handling */
@@ -6711,6 +6738,24 @@ extern "C" {
     */
     Z3_stats Z3_API Z3_solver_get_statistics(Z3_context c, Z3_solver s);
 
+    /**
+       \brief Return the profile of quantifier instantiation of the given solver.
+
+       The profile is collected when the parameter \c smt.qi.profile is enabled.
+       It lists for every quantifier and each of its patterns the number of matches,
+       instances, redundant instances, conflicts the quantifier took part in,
+       the distribution of the generation and cost of its instances, and the time
+       spent in E-matching per function symbol.
+
+       \c format is either \c "json" or \c "csv". The string is empty if the profile
+       was not collected.
+
+       \sa Z3_solver_get_statistics
+
+       def_API('Z3_solver_get_qi_profile', STRING, (_in(CONTEXT), _in(SOLVER), _in(STRING)))
+    */
+    Z3_string Z3_API Z3_solver_get_qi_profile(Z3_context c, Z3_solver s, Z3_string format);
+
     /**
        \brief Convert a solver into a string.
 
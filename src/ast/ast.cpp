@@ -601,7 +601,7 @@ unsigned get_node_hash(ast const * n) {
     return 0;
 }
 
-void ast_table::push_erase(ast * n) {
+void ast_table::shard::erase_node(ast * n) {
     // It uses two important properties:
     // 1. n is known to be in the table.
     // 2. operator== can be used instead of compare_nodes (big savings)
@@ -618,19 +618,17 @@ void ast_table::push_erase(ast * n) {
             if (prev == nullptr) {
                 if (next == nullptr) {
                     m_used_slots--;
-                    push_recycle_cell(c);
                     c->mark_free();
                     SASSERT(c->is_free());
                 }
                 else {
                     *c = *next;
-                    next->m_data = n;
-                    push_recycle_cell(next);
+                    recycle_cell(next);
                 }
             }
             else {
                 prev->m_next = next;
-                push_recycle_cell(c);
+                recycle_cell(c);
             }
             return;
         }
@@ -641,26 +639,35 @@ void ast_table::push_erase(ast * n) {
     }
 }
 
-ast* ast_table::pop_erase() {
-    cell* c = m_tofree_cell;
-    if (c == nullptr) {
-        return nullptr;
-    }
-    if (c->is_free()) {
-        // cell was marked free, should not be recycled.
-        c->unmark_free();
-        m_tofree_cell = c->m_next;
-        c->mark_free();
-    }
-    else {
-        // cell should be recycled with m_free_cell
-        m_tofree_cell = c->m_next;
-        recycle_cell(c);
-    }        
-    return c->m_data;
+unsigned ast_table::size() const {
+    unsigned r = 0;
+    for (shard const& s : m_shards)
+        r += s.size();
+    return r;
 }
 
+unsigned ast_table::capacity() const {
+    unsigned r = 0;
+    for (shard const& s : m_shards)
+        r += s.capacity();
+    return r;
+}
+
+void ast_table::finalize() {
+    for (shard& s : m_shards)
+        s.finalize();
+}
 
+void ast_table::compact() {
+    for (shard& s : m_shards) {
+        if (s.capacity() <= 4 * s.size())
+            continue;
+        shard new_shard;
+        for (ast* curr : s)
+            new_shard.insert(curr);
+        s.swap(new_shard);
+    }
+}
 
 // -----------------------------------
 //
@@ -1370,7 +1377,7 @@ ast_manager::ast_manager(ast_manager const & src, bool disable_proofs):
 }
 
 void ast_manager::update_fresh_id(ast_manager const& m) {
-    m_fresh_id = std::max(m_fresh_id, m.m_fresh_id);
+    m_fresh_id = std::max<unsigned>(m_fresh_id, m.m_fresh_id);
 }
 
 
@@ -1425,6 +1432,7 @@ static void mark_array_ref(ast_mark& mark, unsigned sz, parameter const * a) {
 ast_manager::~ast_manager() {
     SASSERT(is_format_manager() || !m_family_manager.has_family(symbol("format")));
 
+    set_concurrent(false);
     dec_ref(m_bool_sort);
     dec_ref(m_proof_sort);
     dec_ref(m_true);
@@ -1492,7 +1500,7 @@ ast_manager::~ast_manager() {
                 else {
                     std::cout << mk_ll_pp(a, *this, false) << "id: " << a->get_id() << "\n";
                 });
-            a->m_ref_count = 0;
+            a->set_ref_count(0);
             delete_node(a);
         }
     }
@@ -1511,10 +1519,7 @@ void ast_manager::compact_memory() {
     m_alloc.consolidate();
     unsigned capacity = m_ast_table.capacity();
     if (capacity > 4*m_ast_table.size()) {
-        ast_table new_ast_table;
-        for (ast* curr : m_ast_table)
-            new_ast_table.insert(curr);
-        m_ast_table.swap(new_ast_table);
+        m_ast_table.compact();
         IF_VERBOSE(10, verbose_stream() << "(ast-table :prev-capacity " << capacity
                    << " :capacity " << m_ast_table.capacity() << " :size " << m_ast_table.size() << ")\n";);
     }
@@ -1707,8 +1712,13 @@ bool ast_manager::is_bool(expr const * n) const {
 
 #ifdef Z3DEBUG
 bool ast_manager::slow_not_contains(ast const * n) {
+    // in concurrent mode only the shard of n is locked by the caller,
+    // and only that shard is scanned.
+    auto it  = m_concurrent ? m_ast_table.shard_begin(n->hash()) : m_ast_table.begin();
+    auto end = m_concurrent ? m_ast_table.shard_end(n->hash()) : m_ast_table.end();
     unsigned num = 0;
-    for (ast * curr : m_ast_table) {
+    for (; it != end; ++it) {
+        ast * curr = *it;
         if (compare_nodes(curr, n)) {
             TRACE("nondet_bug",
                   tout << "id1:   " << curr->get_id() << ", id2: " << n->get_id() << "\n";
@@ -1721,7 +1731,7 @@ bool ast_manager::slow_not_contains(ast const * n) {
                   to_app(curr)->get_num_args() == 0));
         num++;
     }
-    SASSERT(num == m_ast_table.size());
+    SASSERT(m_concurrent || num == m_ast_table.size());
     return true;
 }
 #endif
@@ -1740,6 +1750,7 @@ static void track_id(ast_manager& m, ast* n, unsigned id) {
 ast * ast_manager::register_node_core(ast * n) {
     unsigned h = get_node_hash(n);
     n->m_hash = h;
+    concurrent_guard<mutex> _lock(m_concurrent, m_ast_table.get_lock(h));
 #ifdef Z3DEBUG
     bool contains = m_ast_table.contains(n);
     CASSERT("nondet_bug", contains || slow_not_contains(n));
@@ -1765,7 +1776,10 @@ ast * ast_manager::register_node_core(ast * n) {
         SASSERT(m_ast_table.contains(n));
     }
 
-    n->m_id = is_decl(n) ? m_decl_id_gen.mk() : m_expr_id_gen.mk();        
+    {
+        concurrent_guard<mutex> _id_lock(m_concurrent, m_node_mux);
+        n->m_id = is_decl(n) ? m_decl_id_gen.mk() : m_expr_id_gen.mk();        
+    }
 
 //    track_id(*this, n, 77);
     
@@ -1856,16 +1870,50 @@ ast * ast_manager::register_node_core(ast * n) {
 }
 
 
+void ast_manager::set_concurrent(bool f) {
+    if (m_concurrent == f)
+        return;
+    m_concurrent = f;
+    if (f)
+        return;
+    // reclaim nodes whose reference count dropped to zero while in concurrent mode.
+    // Nodes that were found again by hash-consing have a positive reference count.
+    // delete_node removes the nodes it deletes from m_deferred, so a node of
+    // the snapshot that was already deleted as a child of another one is skipped.
+    ptr_vector<ast> deferred;
+    for (ast * n : m_deferred)
+        deferred.push_back(n);
+    for (ast * n : deferred) {
+        if (!m_deferred.contains(n))
+            continue;
+        m_deferred.erase(n);
+        if (n->get_ref_count() == 0)
+            delete_node(n);
+    }
+    SASSERT(m_deferred.empty());
+}
+
+void ast_manager::defer_delete(ast * n) {
+    lock_guard lock(m_node_mux);
+    m_deferred.insert(n);
+}
+
 void ast_manager::delete_node(ast * n) {
     TRACE("delete_node_bug", tout << mk_ll_pp(n, *this) << "\n";);
 
     SASSERT(m_ast_table.contains(n));
-    m_ast_table.push_erase(n);
+    SASSERT(m_delete_todo.empty());
+    m_ast_table.erase_node(n);
+    m_delete_todo.push_back(n);
 
-    while ((n = m_ast_table.pop_erase())) {
+    while (!m_delete_todo.empty()) {
+        n = m_delete_todo.back();
+        m_delete_todo.pop_back();
+        if (!m_deferred.empty())
+            m_deferred.erase(n);
 
         CTRACE("del_quantifier", is_quantifier(n), tout << "deleting quantifier " << n->m_id << " " << n << "\n";);
-        TRACE("mk_var_bug", tout << "del_ast: " << " " << n->m_ref_count << "\n";);
+        TRACE("mk_var_bug", tout << "del_ast: " << " " << n->get_ref_count() << "\n";);
         TRACE("ast_delete_node", tout << mk_bounded_pp(n, *this) << "\n";);
 
         SASSERT(!m_debug_ref_count || !m_debug_free_indices.contains(n->m_id));
@@ -1931,6 +1979,7 @@ void ast_manager::delete_node(ast * n) {
 
 
 sort * ast_manager::mk_sort(family_id fid, decl_kind k, unsigned num_parameters, parameter const * parameters) {
+    concurrent_guard<recursive_mutex> _lock(m_concurrent, m_plugin_mux);
     decl_plugin * p = get_plugin(fid);
     if (p)
         return p->mk_sort(k, num_parameters, parameters);
@@ -1939,6 +1988,7 @@ sort * ast_manager::mk_sort(family_id fid, decl_kind k, unsigned num_parameters,
 
 func_decl * ast_manager::mk_func_decl(family_id fid, decl_kind k, unsigned num_parameters, parameter const * parameters,
                                       unsigned arity, sort * const * domain, sort * range) {
+    concurrent_guard<recursive_mutex> _lock(m_concurrent, m_plugin_mux);
     decl_plugin * p = get_plugin(fid);
     if (p)
         return p->mk_func_decl(k, num_parameters, parameters, arity, domain, range);
@@ -1947,6 +1997,7 @@ func_decl * ast_manager::mk_func_decl(family_id fid, decl_kind k, unsigned num_p
 
 func_decl * ast_manager::mk_func_decl(family_id fid, decl_kind k, unsigned num_parameters, parameter const * parameters,
                                       unsigned num_args, expr * const * args, sort * range) {
+    concurrent_guard<recursive_mutex> _lock(m_concurrent, m_plugin_mux);
     decl_plugin * p = get_plugin(fid);
     if (p)
         return p->mk_func_decl(k, num_parameters, parameters, num_args, args, range);
@@ -2015,6 +2066,7 @@ sort * ast_manager::substitute(sort* s, unsigned n, sort * const * src, sort * c
 
 
 sort * ast_manager::mk_uninterpreted_sort(symbol const & name, unsigned num_parameters, parameter const * parameters) {
+    concurrent_guard<recursive_mutex> _lock(m_concurrent, m_plugin_mux);
     user_sort_plugin * plugin = get_user_sort_plugin();
     decl_kind kind = plugin->register_name(name);
     return plugin->mk_sort(kind, num_parameters, parameters);
@@ -2295,8 +2347,9 @@ func_decl * ast_manager::mk_fresh_func_decl(symbol const & prefix, symbol const
     info.m_skolem = skolem;
     SASSERT(skolem == info.is_skolem());
     func_decl * d;
+    unsigned id = m_fresh_id++;
     if (prefix == symbol::null && suffix == symbol::null) {
-        d = mk_func_decl(symbol(m_fresh_id), arity, domain, range, &info);
+        d = mk_func_decl(symbol(id), arity, domain, range, &info);
     }
     else {
         string_buffer<64> buffer;
@@ -2307,10 +2360,9 @@ func_decl * ast_manager::mk_fresh_func_decl(symbol const & prefix, symbol const
         buffer << "!";
         if (suffix != symbol::null)
             buffer << suffix << "!";
-        buffer << m_fresh_id;
+        buffer << id;
         d = mk_func_decl(symbol(buffer.c_str()), arity, domain, range, &info);
     }
-    m_fresh_id++;
     SASSERT(d->get_info());
     SASSERT(skolem == d->is_skolem());
     return d;
@@ -2318,15 +2370,13 @@ func_decl * ast_manager::mk_fresh_func_decl(symbol const & prefix, symbol const
 
 sort * ast_manager::mk_fresh_sort(char const * prefix) {
     string_buffer<32> buffer;
-    buffer << prefix << "!" << m_fresh_id;
-    m_fresh_id++;
+    buffer << prefix << "!" << m_fresh_id++;
     return mk_uninterpreted_sort(symbol(buffer.c_str()));
 }
 
 symbol ast_manager::mk_fresh_var_name(char const * prefix) {
     string_buffer<32> buffer;
-    buffer << (prefix ? prefix : "var") << "!" << m_fresh_id;
-    m_fresh_id++;
+    buffer << (prefix ? prefix : "var") << "!" << m_fresh_id++;
     return symbol(buffer.c_str());
 }
 
@@ -46,6 +46,7 @@ Revision History:
 #include "util/z3_exception.h"
 #include "util/dependency.h"
 #include "util/rlimit.h"
+#include "util/mutex.h"
 
 #define RECYCLE_FREE_AST_INDICES
 
@@ -478,7 +479,9 @@ protected:
     void mark_so(bool flag) { m_mark_shared_occs = flag; }
     void reset_mark_so() { m_mark_shared_occs = false; }
     bool is_marked_so() const { return m_mark_shared_occs; }
-    unsigned m_ref_count;
+    // Reference counts are only updated atomically when the owning
+    // manager is in concurrent mode, see ast_manager::set_concurrent.
+    atomic<unsigned> m_ref_count;
     unsigned m_hash;
 #ifdef Z3DEBUG
     // In debug mode, we store who is the owner of the mark.
@@ -486,14 +489,24 @@ protected:
     void *   m_mark2_owner;
 #endif
 
+#ifdef SINGLE_THREAD
+    void set_ref_count(unsigned rc) { m_ref_count = rc; }
+    void inc_ref_atomic() { inc_ref(); }
+    unsigned dec_ref_atomic() { dec_ref(); return m_ref_count; }
+#else
+    void set_ref_count(unsigned rc) { m_ref_count.store(rc, std::memory_order_relaxed); }
+    void inc_ref_atomic() { m_ref_count.fetch_add(1, std::memory_order_relaxed); }
+    unsigned dec_ref_atomic() { return m_ref_count.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+#endif
+
     void inc_ref() {
-        SASSERT(m_ref_count < UINT_MAX);
-        m_ref_count ++;
+        SASSERT(get_ref_count() < UINT_MAX);
+        set_ref_count(get_ref_count() + 1);
     }
 
     void dec_ref() {
-        SASSERT(m_ref_count > 0);
-        --m_ref_count;
+        SASSERT(get_ref_count() > 0);
+        set_ref_count(get_ref_count() - 1);
     }
 
     ast(ast_kind k):m_id(UINT_MAX), m_kind(k), m_mark1(false), m_mark2(false), m_mark_shared_occs(false), m_ref_count(0) {
@@ -504,7 +517,11 @@ protected:
     }
 public:
     unsigned get_id() const { return m_id; }
+#ifdef SINGLE_THREAD
     unsigned get_ref_count() const { return m_ref_count; }
+#else
+    unsigned get_ref_count() const { return m_ref_count.load(std::memory_order_relaxed); }
+#endif
     ast_kind get_kind() const { return static_cast<ast_kind>(m_kind); }
     unsigned hash() const { return m_hash; }
 
@@ -972,11 +989,87 @@ struct ast_eq_proc {
 
 class ast_translation;
 
-class ast_table : public chashtable<ast*, obj_ptr_hash<ast>, ast_eq_proc> {
+/**
+   \brief Hash-consing table for AST nodes.
+   
+   The table is split into shards selected by the high bits of the node hash.
+   In concurrent mode each shard is protected by its own lock, so threads
+   creating unrelated terms rarely contend.
+*/
+class ast_table {
+    class shard : public chashtable<ast*, obj_ptr_hash<ast>, ast_eq_proc> {
+    public:
+        shard() : chashtable({}, {}, 32 * 1024, 512) {}
+        // remove n using pointer equality, n must be in the table.
+        void erase_node(ast * n);
+    };
+
+    static const unsigned c_log_num_shards = 4;
+    static const unsigned c_num_shards     = 1 << c_log_num_shards;
+
+    shard m_shards[c_num_shards];
+    mutex m_locks[c_num_shards];
+
+    static unsigned shard_idx(unsigned h) { return h >> (32 - c_log_num_shards); }
+
 public:
-    ast_table() : chashtable({}, {}, 512 * 1024, 8 * 1024) {}
-    void push_erase(ast * n);
-    ast* pop_erase();
+    class iterator {
+        shard const *     m_curr;
+        shard const *     m_end;
+        shard::iterator   m_it;
+        void move_to_used() {
+            while (m_curr != m_end && !(m_it != m_curr->end())) {
+                ++m_curr;
+                if (m_curr != m_end)
+                    m_it = m_curr->begin();
+            }
+        }
+    public:
+        iterator(shard const * begin, shard const * end): m_curr(begin), m_end(end) {
+            if (m_curr != m_end) {
+                m_it = m_curr->begin();
+                move_to_used();
+            }
+        }
+        ast * operator*() const { return *m_it; }
+        iterator & operator++() { ++m_it; move_to_used(); return *this; }
+        bool operator==(iterator const & other) const { return m_curr == other.m_curr && (m_curr == m_end || !(m_it != other.m_it)); }
+        bool operator!=(iterator const & other) const { return !(*this == other); }
+    };
+
+    iterator begin() const { return iterator(m_shards, m_shards + c_num_shards); }
+    iterator end() const { return iterator(m_shards + c_num_shards, m_shards + c_num_shards); }
+    // the nodes of the shard of hash h, they are protected by get_lock(h).
+    iterator shard_begin(unsigned h) const { return iterator(m_shards + shard_idx(h), m_shards + shard_idx(h) + 1); }
+    iterator shard_end(unsigned h) const { return iterator(m_shards + shard_idx(h) + 1, m_shards + shard_idx(h) + 1); }
+
+    ast * insert_if_not_there(ast * n) { return m_shards[shard_idx(n->hash())].insert_if_not_there(n); }
+    void insert(ast * n) { m_shards[shard_idx(n->hash())].insert(n); }
+    bool contains(ast * n) const { return m_shards[shard_idx(n->hash())].contains(n); }
+    void erase_node(ast * n) { m_shards[shard_idx(n->hash())].erase_node(n); }
+    mutex & get_lock(unsigned h) { return m_locks[shard_idx(h)]; }
+
+    unsigned size() const;
+    unsigned capacity() const;
+    bool empty() const { return size() == 0; }
+    void finalize();
+    // shrink shards whose capacity is much larger than their size.
+    void compact();
+};
+
+/**
+   \brief Lock the given mutex only if concurrent is true.
+*/
+template<typename Mutex>
+class concurrent_guard {
+    Mutex * m_mux;
+public:
+    concurrent_guard(bool concurrent, Mutex & mux): m_mux(concurrent ? &mux : nullptr) {
+        if (m_mux) m_mux->lock();
+    }
+    ~concurrent_guard() {
+        if (m_mux) m_mux->unlock();
+    }
 };
 
 // -----------------------------------
@@ -1487,6 +1580,7 @@ protected:
     proof_gen_mode            m_proof_mode;
     bool                      m_int_real_coercions; // If true, use hack that automatically introduces to_int/to_real when needed.
     ast_table                 m_ast_table;
+    ptr_vector<ast>           m_delete_todo;
     obj_map<func_decl, quantifier*> m_lambda_defs;
     id_gen                    m_expr_id_gen;
     id_gen                    m_decl_id_gen;
@@ -1495,7 +1589,11 @@ protected:
     app *                     m_true;
     app *                     m_false;
     proof *                   m_undef_proof;
-    unsigned                  m_fresh_id;
+    atomic<unsigned>          m_fresh_id;
+    bool                      m_concurrent { false };
+    recursive_mutex           m_plugin_mux;  // serializes plugins in concurrent mode
+    mutex                     m_node_mux;    // protects the allocator, id generators and m_deferred
+    obj_hashtable<ast>        m_deferred;    // nodes whose reference count reached zero in concurrent mode
     bool                      m_debug_ref_count;
     u_map<unsigned>           m_debug_free_indices;
     std::fstream*             m_trace_stream;
@@ -1628,18 +1726,45 @@ public:
     void debug_ref_count() { m_debug_ref_count = true; }
 
     void inc_ref(ast* n) {
-        if (n) 
+        if (!n) 
+            return;
+        if (m_concurrent)
+            n->inc_ref_atomic();
+        else
             n->inc_ref();
     }
     
     void dec_ref(ast* n) {
-        if (n) {
+        if (!n)
+            return;
+        if (m_concurrent) {
+            if (n->dec_ref_atomic() == 0)
+                defer_delete(n);
+        }
+        else {
             n->dec_ref();
             if (n->get_ref_count() == 0)
                 delete_node(n);
         }
     }
 
+    /**
+       \brief Enable or disable concurrent mode.
+
+       In concurrent mode several threads may create, look up, and reference
+       count terms of this manager at the same time. Reference counts are
+       updated atomically, the hash-consing table is locked per shard, and
+       calls into decl plugins are serialized. Nodes whose reference count
+       drops to zero are reclaimed when concurrent mode is disabled.
+
+       The mode may only be changed while no other thread uses the manager.
+       Marks, trace streams, proofs and expression dependencies are not
+       thread-safe.
+    */
+    void set_concurrent(bool f);
+
+    bool is_concurrent() const { return m_concurrent; }
+
     template<typename T>
     void inc_array_ref(unsigned sz, T * const * a) {
         for(unsigned i = 0; i < sz; i++) {
@@ -1672,11 +1797,15 @@ protected:
 
     void delete_node(ast * n);
 
+    void defer_delete(ast * n);
+
     void * allocate_node(unsigned size) {
+        concurrent_guard<mutex> _lock(m_concurrent, m_node_mux);
         return m_alloc.allocate(size);
     }
 
     void deallocate_node(ast * n, unsigned sz) {
+        concurrent_guard<mutex> _lock(m_concurrent, m_node_mux);
         m_alloc.deallocate(sz, n);
     }
 
@@ -2354,7 +2483,8 @@ private:
     void push_dec_ref(ast * n) {
         n->dec_ref();
         if (n->get_ref_count() == 0) {
-            m_ast_table.push_erase(n);
+            m_ast_table.erase_node(n);
+            m_delete_todo.push_back(n);
         }
     }
 
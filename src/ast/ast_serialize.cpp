@@ -0,0 +1,724 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    ast_serialize.cpp
+
+Abstract:
+
+    Binary serialization of expressions.
+
+    Expressions are serialized in a compact binary format that
+    preserves sharing. The format is a sequence of records:
+
+      header   "Z3AST" followed by a version byte
+      SYMBOL   interned symbols, referenced by table index
+      FAMILY   interned family names, referenced by table index
+      SORT, FUNC_DECL, FPA_NUM, APP, VAR, QUANTIFIER
+               one record per distinct AST node, children first.
+               Children are referenced by the distance to the
+               current node index (varint encoded).
+      ROOT     index of the serialized expression
+
+    All integers are LEB128 varints (signed values are zig-zag
+    encoded). Loading is linear in the size of the DAG.
+    The encoding only depends on the structure of the expression,
+    not on node ids, so it is stable across processes.
+
+--*/
+#include <cstring>
+#include <climits>
+
+#include "util/vector.h"
+#include "util/map.h"
+#include "ast/ast_serialize.h"
+#include "ast/fpa_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+
+static const char   MARSHAL_MAGIC[]   = { 'Z', '3', 'A', 'S', 'T' };
+static const unsigned MARSHAL_MAGIC_SIZE = sizeof(MARSHAL_MAGIC);
+static const unsigned char MARSHAL_VERSION = 1;
+
+enum marshal_tag {
+    MT_ROOT = 0,
+    MT_SYMBOL_STR,
+    MT_SYMBOL_NUM,
+    MT_FAMILY,
+    MT_SORT,
+    MT_FUNC_DECL,
+    MT_FPA_NUM,
+    MT_APP,
+    MT_VAR,
+    MT_QUANTIFIER
+};
+
+enum marshal_sort_kind {
+    MS_UNINTERP = 0,
+    MS_INFO
+};
+
+// flags for func_decl_info
+enum marshal_decl_flag {
+    MF_LEFT_ASSOC  = 1 << 0,
+    MF_RIGHT_ASSOC = 1 << 1,
+    MF_FLAT_ASSOC  = 1 << 2,
+    MF_COMMUTATIVE = 1 << 3,
+    MF_CHAINABLE   = 1 << 4,
+    MF_PAIRWISE    = 1 << 5,
+    MF_INJECTIVE   = 1 << 6,
+    MF_IDEMPOTENT  = 1 << 7,
+    MF_SKOLEM      = 1 << 8
+};
+
+class binary_marshaller {
+    ast_manager &                                          m;
+    std::string &                                          m_out;
+    obj_map<ast, unsigned>                                 m_ids;
+    map<symbol, unsigned, symbol_hash_proc, symbol_eq_proc> m_symbols;
+    unsigned_vector                                        m_families; // family_id -> index + 1
+    unsigned                                               m_num_families;
+    ptr_vector<ast>                                        m_todo;
+    fpa_util                                               m_fpa;
+
+    bool is_fpa_numeral(func_decl * f) const {
+        return f->get_family_id() == m_fpa.get_fid() && f->get_decl_kind() == OP_FPA_NUM;
+    }
+
+    void put_byte(unsigned char b) { m_out.push_back(static_cast<char>(b)); }
+
+    void put_uint(uint64_t v) {
+        while (v >= 0x80) {
+            put_byte(static_cast<unsigned char>(v | 0x80));
+            v >>= 7;
+        }
+        put_byte(static_cast<unsigned char>(v));
+    }
+
+    void put_int(int64_t v) {
+        put_uint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    void put_string(std::string const & s) {
+        put_uint(s.size());
+        m_out.append(s);
+    }
+
+    void put_ref(ast * n) {
+        SASSERT(m_ids.contains(n));
+        put_uint(m_ids.size() - m_ids[n]);
+    }
+
+    unsigned symbol_idx(symbol const & s) {
+        if (s.is_null())
+            return 0;
+        unsigned idx = 0;
+        if (m_symbols.find(s, idx))
+            return idx;
+        if (s.is_numerical()) {
+            put_byte(MT_SYMBOL_NUM);
+            put_uint(s.get_num());
+        }
+        else {
+            put_byte(MT_SYMBOL_STR);
+            put_string(s.str());
+        }
+        idx = m_symbols.size() + 1;
+        m_symbols.insert(s, idx);
+        return idx;
+    }
+
+    unsigned family_idx(family_id fid) {
+        if (fid == null_family_id)
+            return 0;
+        m_families.reserve(fid + 1, 0);
+        if (m_families[fid] == 0) {
+            unsigned s = symbol_idx(m.get_family_name(fid));
+            put_byte(MT_FAMILY);
+            put_uint(s);
+            m_families[fid] = ++m_num_families;
+        }
+        return m_families[fid];
+    }
+
+    // Symbols and families referenced by a node must be emitted before the node record.
+    void intern_params(decl_info const * info) {
+        for (unsigned i = 0; i < info->get_num_parameters(); ++i) {
+            parameter const & p = info->get_parameter(i);
+            if (p.is_symbol())
+                symbol_idx(p.get_symbol());
+            else if (p.is_external())
+                throw default_exception("marshal: unsupported external parameter");
+        }
+    }
+
+    void put_params(decl_info const * info) {
+        put_uint(info->get_num_parameters());
+        for (unsigned i = 0; i < info->get_num_parameters(); ++i) {
+            parameter const & p = info->get_parameter(i);
+            put_byte(static_cast<unsigned char>(p.get_kind()));
+            switch (p.get_kind()) {
+            case parameter::PARAM_INT:
+                put_int(p.get_int());
+                break;
+            case parameter::PARAM_AST:
+                put_ref(p.get_ast());
+                break;
+            case parameter::PARAM_SYMBOL:
+                put_uint(symbol_idx(p.get_symbol()));
+                break;
+            case parameter::PARAM_RATIONAL: {
+                rational const & r = p.get_rational();
+                if (r.is_int64()) {
+                    put_byte(0);
+                    put_int(r.get_int64());
+                }
+                else {
+                    put_byte(1);
+                    put_string(r.to_string());
+                }
+                break;
+            }
+            case parameter::PARAM_DOUBLE: {
+                double d = p.get_double();
+                uint64_t bits;
+                memcpy(&bits, &d, sizeof(d));
+                put_uint(bits);
+                break;
+            }
+            default:
+                UNREACHABLE();
+                break;
+            }
+        }
+    }
+
+    void push_params(decl_info const * info) {
+        if (!info)
+            return;
+        for (unsigned i = 0; i < info->get_num_parameters(); ++i) {
+            parameter const & p = info->get_parameter(i);
+            if (p.is_ast() && !m_ids.contains(p.get_ast()))
+                m_todo.push_back(p.get_ast());
+        }
+    }
+
+    void push(ast * n) {
+        if (!m_ids.contains(n))
+            m_todo.push_back(n);
+    }
+
+    void push_children(ast * n) {
+        switch (n->get_kind()) {
+        case AST_SORT:
+            push_params(to_sort(n)->get_info());
+            break;
+        case AST_FUNC_DECL: {
+            func_decl * f = to_func_decl(n);
+            if (is_fpa_numeral(f))
+                break;
+            push_params(f->get_info());
+            for (sort * s : *f)
+                push(s);
+            push(f->get_range());
+            break;
+        }
+        case AST_APP:
+            push(to_app(n)->get_decl());
+            for (expr * arg : *to_app(n))
+                push(arg);
+            break;
+        case AST_VAR:
+            push(to_var(n)->get_sort());
+            break;
+        case AST_QUANTIFIER: {
+            quantifier * q = to_quantifier(n);
+            for (unsigned i = 0; i < q->get_num_decls(); ++i)
+                push(q->get_decl_sort(i));
+            push(q->get_expr());
+            for (unsigned i = 0; i < q->get_num_patterns(); ++i)
+                push(q->get_pattern(i));
+            for (unsigned i = 0; i < q->get_num_no_patterns(); ++i)
+                push(q->get_no_pattern(i));
+            break;
+        }
+        default:
+            UNREACHABLE();
+            break;
+        }
+    }
+
+    void write_sort(sort * s) {
+        sort_info * info = s->get_info();
+        unsigned name = symbol_idx(s->get_name());
+        unsigned fam = 0;
+        if (info) {
+            if (!m.is_uninterp(s))
+                fam = family_idx(info->get_family_id());
+            intern_params(info);
+        }
+        put_byte(MT_SORT);
+        put_uint(name);
+        if (m.is_uninterp(s)) {
+            // decl kinds of user sorts depend on the registration order in the manager.
+            put_byte(MS_UNINTERP);
+            if (info)
+                put_params(info);
+            else
+                put_uint(0);
+            return;
+        }
+        put_byte(MS_INFO);
+        put_uint(fam);
+        put_int(info->get_decl_kind());
+        sort_size const & sz = info->get_num_elements();
+        if (sz.is_finite()) {
+            put_byte(0);
+            put_uint(sz.size());
+        }
+        else
+            put_byte(sz.is_very_big() ? 1 : 2);
+        put_byte(s->private_parameters());
+        put_params(info);
+    }
+
+    void write_fpa_numeral(func_decl * f) {
+        app_ref c(m.mk_const(f), m);
+        scoped_mpf v(m_fpa.fm());
+        VERIFY(m_fpa.is_numeral(c, v));
+        put_byte(MT_FPA_NUM);
+        put_uint(v.get().get_ebits());
+        put_uint(v.get().get_sbits());
+        put_byte(m_fpa.fm().sgn(v));
+        put_int(m_fpa.fm().exp(v));
+        put_string(m_fpa.fm().mpz_manager().to_string(m_fpa.fm().sig(v)));
+    }
+
+    void write_func_decl(func_decl * f) {
+        if (is_fpa_numeral(f)) {
+            write_fpa_numeral(f);
+            return;
+        }
+        func_decl_info * info = f->get_info();
+        unsigned name = symbol_idx(f->get_name());
+        unsigned fam = 0;
+        if (info) {
+            fam = family_idx(info->get_family_id());
+            intern_params(info);
+            if (info->is_lambda())
+                throw default_exception("marshal: lambda definitions are not supported");
+        }
+        put_byte(MT_FUNC_DECL);
+        put_uint(name);
+        put_uint(f->get_arity());
+        for (sort * s : *f)
+            put_ref(s);
+        put_ref(f->get_range());
+        put_byte(info != nullptr);
+        if (!info)
+            return;
+        unsigned flags = 0;
+        if (info->is_left_associative())  flags |= MF_LEFT_ASSOC;
+        if (info->is_right_associative()) flags |= MF_RIGHT_ASSOC;
+        if (info->is_flat_associative())  flags |= MF_FLAT_ASSOC;
+        if (info->is_commutative())       flags |= MF_COMMUTATIVE;
+        if (info->is_chainable())         flags |= MF_CHAINABLE;
+        if (info->is_pairwise())          flags |= MF_PAIRWISE;
+        if (info->is_injective())         flags |= MF_INJECTIVE;
+        if (info->is_idempotent())        flags |= MF_IDEMPOTENT;
+        if (info->is_skolem())            flags |= MF_SKOLEM;
+        put_uint(fam);
+        put_int(info->get_decl_kind());
+        put_uint(flags);
+        put_params(info);
+    }
+
+    void write_quantifier(quantifier * q) {
+        unsigned_vector names;
+        for (unsigned i = 0; i < q->get_num_decls(); ++i)
+            names.push_back(symbol_idx(q->get_decl_name(i)));
+        unsigned qid = symbol_idx(q->get_qid());
+        unsigned skid = symbol_idx(q->get_skid());
+        put_byte(MT_QUANTIFIER);
+        put_byte(static_cast<unsigned char>(q->get_kind()));
+        put_uint(q->get_num_decls());
+        for (unsigned i = 0; i < q->get_num_decls(); ++i) {
+            put_uint(names[i]);
+            put_ref(q->get_decl_sort(i));
+        }
+        put_ref(q->get_expr());
+        put_int(q->get_weight());
+        put_uint(qid);
+        put_uint(skid);
+        put_uint(q->get_num_patterns());
+        for (unsigned i = 0; i < q->get_num_patterns(); ++i)
+            put_ref(q->get_pattern(i));
+        put_uint(q->get_num_no_patterns());
+        for (unsigned i = 0; i < q->get_num_no_patterns(); ++i)
+            put_ref(q->get_no_pattern(i));
+    }
+
+    void write(ast * n) {
+        switch (n->get_kind()) {
+        case AST_SORT:
+            write_sort(to_sort(n));
+            break;
+        case AST_FUNC_DECL:
+            write_func_decl(to_func_decl(n));
+            break;
+        case AST_APP:
+            put_byte(MT_APP);
+            put_ref(to_app(n)->get_decl());
+            put_uint(to_app(n)->get_num_args());
+            for (expr * arg : *to_app(n))
+                put_ref(arg);
+            break;
+        case AST_VAR:
+            put_byte(MT_VAR);
+            put_uint(to_var(n)->get_idx());
+            put_ref(to_var(n)->get_sort());
+            break;
+        case AST_QUANTIFIER:
+            write_quantifier(to_quantifier(n));
+            break;
+        default:
+            UNREACHABLE();
+            break;
+        }
+        m_ids.insert(n, m_ids.size());
+    }
+
+public:
+    binary_marshaller(ast_manager & m, std::string & out): m(m), m_out(out), m_num_families(0), m_fpa(m) {}
+
+    void operator()(expr * e) {
+        m_out.append(MARSHAL_MAGIC, MARSHAL_MAGIC_SIZE);
+        put_byte(MARSHAL_VERSION);
+        m_todo.push_back(e);
+        while (!m_todo.empty()) {
+            ast * n = m_todo.back();
+            if (m_ids.contains(n)) {
+                m_todo.pop_back();
+                continue;
+            }
+            unsigned sz = m_todo.size();
+            push_children(n);
+            if (sz < m_todo.size())
+                continue;
+            m_todo.pop_back();
+            write(n);
+        }
+        put_byte(MT_ROOT);
+        put_uint(m_ids[e]);
+    }
+};
+
+class binary_unmarshaller {
+    ast_manager &     m;
+    char const *      m_curr;
+    char const *      m_end;
+    ast_ref_vector    m_asts;
+    svector<symbol>   m_symbols;
+    svector<family_id> m_families;
+    scoped_ptr<fpa_util> m_fpa;
+
+    struct failure {};
+
+    void fail() { throw failure(); }
+
+    unsigned char get_byte() {
+        if (m_curr == m_end)
+            fail();
+        return static_cast<unsigned char>(*m_curr++);
+    }
+
+    uint64_t get_uint64() {
+        uint64_t r = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            unsigned char b = get_byte();
+            r |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+                return r;
+        }
+        fail();
+        return 0;
+    }
+
+    unsigned get_uint() {
+        uint64_t r = get_uint64();
+        if (r > UINT_MAX)
+            fail();
+        return static_cast<unsigned>(r);
+    }
+
+    int64_t get_int64() {
+        uint64_t r = get_uint64();
+        return static_cast<int64_t>(r >> 1) ^ -static_cast<int64_t>(r & 1);
+    }
+
+    int get_int() {
+        int64_t r = get_int64();
+        if (r < INT_MIN || r > INT_MAX)
+            fail();
+        return static_cast<int>(r);
+    }
+
+    std::string get_string() {
+        unsigned sz = get_uint();
+        if (static_cast<size_t>(m_end - m_curr) < sz)
+            fail();
+        std::string r(m_curr, sz);
+        m_curr += sz;
+        return r;
+    }
+
+    symbol get_symbol() {
+        unsigned idx = get_uint();
+        if (idx > m_symbols.size())
+            fail();
+        return idx == 0 ? symbol::null : m_symbols[idx - 1];
+    }
+
+    family_id get_family() {
+        unsigned idx = get_uint();
+        if (idx > m_families.size())
+            fail();
+        return idx == 0 ? null_family_id : m_families[idx - 1];
+    }
+
+    ast * get_ref() {
+        unsigned delta = get_uint();
+        if (delta == 0 || delta > m_asts.size())
+            fail();
+        return m_asts.get(m_asts.size() - delta);
+    }
+
+    sort * get_sort() {
+        ast * n = get_ref();
+        if (!is_sort(n))
+            fail();
+        return to_sort(n);
+    }
+
+    expr * get_expr() {
+        ast * n = get_ref();
+        if (!is_expr(n))
+            fail();
+        return to_expr(n);
+    }
+
+    void get_params(buffer<parameter> & ps) {
+        unsigned n = get_uint();
+        for (unsigned i = 0; i < n; ++i) {
+            switch (get_byte()) {
+            case parameter::PARAM_INT:
+                ps.push_back(parameter(get_int()));
+                break;
+            case parameter::PARAM_AST:
+                ps.push_back(parameter(get_ref()));
+                break;
+            case parameter::PARAM_SYMBOL:
+                ps.push_back(parameter(get_symbol()));
+                break;
+            case parameter::PARAM_RATIONAL:
+                if (get_byte() == 0)
+                    ps.push_back(parameter(rational(get_int64(), rational::i64())));
+                else
+                    ps.push_back(parameter(rational(get_string().c_str())));
+                break;
+            case parameter::PARAM_DOUBLE: {
+                uint64_t bits = get_uint64();
+                double d;
+                memcpy(&d, &bits, sizeof(d));
+                ps.push_back(parameter(d));
+                break;
+            }
+            default:
+                fail();
+            }
+        }
+    }
+
+    void read_family() {
+        symbol name = get_symbol();
+        if (!m.has_plugin(name))
+            reg_decl_plugins(m);
+        m_families.push_back(m.mk_family_id(name));
+    }
+
+    void read_sort() {
+        symbol name = get_symbol();
+        unsigned char k0 = get_byte();
+        if (k0 == MS_UNINTERP) {
+            buffer<parameter> ps;
+            get_params(ps);
+            m_asts.push_back(m.mk_uninterpreted_sort(name, ps.size(), ps.data()));
+            return;
+        }
+        if (k0 != MS_INFO)
+            fail();
+        family_id fid = get_family();
+        decl_kind k = get_int();
+        sort_size sz;
+        switch (get_byte()) {
+        case 0: sz = sort_size::mk_finite(get_uint64()); break;
+        case 1: sz = sort_size::mk_very_big(); break;
+        case 2: sz = sort_size::mk_infinite(); break;
+        default: fail();
+        }
+        bool private_params = get_byte() != 0;
+        buffer<parameter> ps;
+        get_params(ps);
+        m_asts.push_back(m.mk_sort(name, sort_info(fid, k, sz, ps.size(), ps.data(), private_params)));
+    }
+
+    void read_func_decl() {
+        symbol name = get_symbol();
+        unsigned arity = get_uint();
+        ptr_buffer<sort> domain;
+        for (unsigned i = 0; i < arity; ++i)
+            domain.push_back(get_sort());
+        sort * range = get_sort();
+        if (get_byte() == 0) {
+            m_asts.push_back(m.mk_func_decl(name, arity, domain.data(), range));
+            return;
+        }
+        family_id fid = get_family();
+        decl_kind k = get_int();
+        unsigned flags = get_uint();
+        buffer<parameter> ps;
+        get_params(ps);
+        func_decl_info info(fid, k, ps.size(), ps.data());
+        info.set_left_associative((flags & MF_LEFT_ASSOC) != 0);
+        info.set_right_associative((flags & MF_RIGHT_ASSOC) != 0);
+        info.set_flat_associative((flags & MF_FLAT_ASSOC) != 0);
+        info.set_commutative((flags & MF_COMMUTATIVE) != 0);
+        info.set_chainable((flags & MF_CHAINABLE) != 0);
+        info.set_pairwise((flags & MF_PAIRWISE) != 0);
+        info.set_injective((flags & MF_INJECTIVE) != 0);
+        info.set_idempotent((flags & MF_IDEMPOTENT) != 0);
+        info.set_skolem((flags & MF_SKOLEM) != 0);
+        m_asts.push_back(m.mk_func_decl(name, arity, domain.data(), range, info));
+    }
+
+    void read_fpa_numeral() {
+        unsigned ebits = get_uint();
+        unsigned sbits = get_uint();
+        bool sign = get_byte() != 0;
+        mpf_exp_t exp = get_int64();
+        std::string sig_str = get_string();
+        if (!m_fpa) {
+            if (!m.has_plugin(symbol("fpa")))
+                reg_decl_plugins(m);
+            m_fpa = alloc(fpa_util, m);
+        }
+        unsynch_mpz_manager & zm = m_fpa->fm().mpz_manager();
+        scoped_mpz sig(zm);
+        zm.set(sig, sig_str.c_str());
+        scoped_mpf v(m_fpa->fm());
+        m_fpa->fm().set(v, ebits, sbits, sign, exp, sig);
+        m_asts.push_back(m_fpa->mk_value(v)->get_decl());
+    }
+
+    void read_app() {
+        ast * d = get_ref();
+        if (!is_func_decl(d))
+            fail();
+        unsigned n = get_uint();
+        ptr_buffer<expr> args;
+        for (unsigned i = 0; i < n; ++i)
+            args.push_back(get_expr());
+        m_asts.push_back(m.mk_app(to_func_decl(d), n, args.data()));
+    }
+
+    void read_var() {
+        unsigned idx = get_uint();
+        m_asts.push_back(m.mk_var(idx, get_sort()));
+    }
+
+    void read_quantifier() {
+        unsigned char k = get_byte();
+        if (k > lambda_k)
+            fail();
+        unsigned num_decls = get_uint();
+        ptr_buffer<sort> sorts;
+        buffer<symbol> names;
+        for (unsigned i = 0; i < num_decls; ++i) {
+            names.push_back(get_symbol());
+            sorts.push_back(get_sort());
+        }
+        expr * body = get_expr();
+        int weight = get_int();
+        symbol qid = get_symbol();
+        symbol skid = get_symbol();
+        ptr_buffer<expr> pats, no_pats;
+        unsigned num_pats = get_uint();
+        for (unsigned i = 0; i < num_pats; ++i)
+            pats.push_back(get_expr());
+        unsigned num_no_pats = get_uint();
+        for (unsigned i = 0; i < num_no_pats; ++i)
+            no_pats.push_back(get_expr());
+        quantifier * q;
+        if (k == lambda_k)
+            q = m.mk_lambda(num_decls, sorts.data(), names.data(), body);
+        else
+            q = m.mk_quantifier(static_cast<quantifier_kind>(k), num_decls, sorts.data(), names.data(), body,
+                                weight, qid, skid, num_pats, pats.data(), num_no_pats, no_pats.data());
+        m_asts.push_back(q);
+    }
+
+public:
+    binary_unmarshaller(ast_manager & m, char const * data, size_t sz):
+        m(m), m_curr(data), m_end(data + sz), m_asts(m) {}
+
+    expr_ref operator()() {
+        try {
+            m_curr += MARSHAL_MAGIC_SIZE;
+            if (get_byte() != MARSHAL_VERSION)
+                fail();
+            while (true) {
+                switch (get_byte()) {
+                case MT_ROOT: {
+                    unsigned idx = get_uint();
+                    if (idx >= m_asts.size() || !is_expr(m_asts.get(idx)))
+                        fail();
+                    return expr_ref(to_expr(m_asts.get(idx)), m);
+                }
+                case MT_SYMBOL_STR:
+                    m_symbols.push_back(symbol(get_string()));
+                    break;
+                case MT_SYMBOL_NUM:
+                    m_symbols.push_back(symbol(get_uint()));
+                    break;
+                case MT_FAMILY:      read_family(); break;
+                case MT_SORT:        read_sort(); break;
+                case MT_FUNC_DECL:   read_func_decl(); break;
+                case MT_FPA_NUM:     read_fpa_numeral(); break;
+                case MT_APP:         read_app(); break;
+                case MT_VAR:         read_var(); break;
+                case MT_QUANTIFIER:  read_quantifier(); break;
+                default:             fail();
+                }
+            }
+        }
+        catch (failure &) {
+            return expr_ref(nullptr, m);
+        }
+    }
+};
+
+bool is_ast_serialization(char const * data, size_t sz) {
+    return sz > MARSHAL_MAGIC_SIZE && memcmp(data, MARSHAL_MAGIC, MARSHAL_MAGIC_SIZE) == 0;
+}
+
+void ast_serialize(ast_manager & m, expr * e, std::string & out) {
+    binary_marshaller bm(m, out);
+    bm(e);
+}
+
+expr_ref ast_deserialize(ast_manager & m, char const * data, size_t sz) {
+    if (!is_ast_serialization(data, sz))
+        return expr_ref(nullptr, m);
+    binary_unmarshaller bu(m, data, sz);
+    return bu();
+}
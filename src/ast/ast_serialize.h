@@ -0,0 +1,32 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    ast_serialize.h
+
+Abstract:
+
+    Compact binary serialization of expressions that preserves
+    sharing in the expression DAG. The encoding is independent of
+    node ids and can be exchanged between managers and processes.
+
+--*/
+#pragma once
+
+#include <string>
+
+#include "ast/ast.h"
+
+/**
+   \brief Append the serialization of e to out.
+*/
+void ast_serialize(ast_manager & m, expr * e, std::string & out);
+
+/**
+   \brief Rebuild an expression from its serialization.
+   Return a null expression if the input is malformed.
+*/
+expr_ref ast_deserialize(ast_manager & m, char const * data, size_t sz);
+
+bool is_ast_serialization(char const * data, size_t sz);
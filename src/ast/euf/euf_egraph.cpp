@@ -376,6 +376,12 @@ namespace euf {
             case update_record::tag_t::is_lbl_set:
                 p.r1->m_lbls.set(p.m_lbls);
                 break;
+            case update_record::tag_t::is_new_explain_entry:
+                undo_explain_cache();
+                break;
+            case update_record::tag_t::is_new_explain_edge:
+                undo_explain_edge();
+                break;
             default:
                 UNREACHABLE();
                 break;
@@ -400,8 +406,11 @@ namespace euf {
         SASSERT(n1->get_sort() == n2->get_sort());
         enode* r1 = n1->get_root();
         enode* r2 = n2->get_root();
-        if (r1 == r2)
+        if (r1 == r2) {
+            if (m_explain_shortest && n1 != n2)
+                add_explain_edge(n1, n2, j);
             return;
+        }
 
         TRACE("euf", j.display(tout << "merge: " << bpp(n1) << " == " << bpp(n2) << " ", m_display_justification) << "\n";);
         IF_VERBOSE(20, j.display(verbose_stream() << "merge: " << bpp(n1) << " == " << bpp(n2) << " ", m_display_justification) << "\n";);
@@ -672,14 +681,161 @@ namespace euf {
     template <typename T>
     void egraph::explain_eq(ptr_vector<T>& justifications, enode* a, enode* b) {
         SASSERT(a->get_root() == b->get_root());
-        
-        enode* lca = find_lca(a, b);
-        TRACE("euf_verbose", tout << "explain-eq: " << bpp(a) << " == " << bpp(b) << " lca: " << bpp(lca) << "\n";);
-        push_to_lca(a, lca);
-        push_to_lca(b, lca);
-        if (m_used_eq)
-            m_used_eq(a->get_expr(), b->get_expr(), lca->get_expr());
+        ++m_stats.m_num_explain;
+        unsigned sz = justifications.size();
+        // the explanation is complete only if nothing was explained before.
+        bool use_cache = m_explain_cache && m_todo.empty() && !m_used_eq && !m_used_cc;
+        if (use_cache && explain_cached(justifications, a, b)) {
+            m_stats.m_explain_length += justifications.size() - sz;
+            return;
+        }
+        if (m_explain_shortest && !m_used_eq) {
+            push_shortest(a, b);
+            for (unsigned i = 0; i < m_explain_todo_edges.size(); ++i) {
+                explain_edge const& e = m_explain_edges[m_explain_todo_edges[i]];
+                explain_eq(justifications, e.a, e.b, e.j);
+            }
+            m_explain_todo_edges.reset();
+        }
+        else {
+            enode* lca = find_lca(a, b);
+            TRACE("euf_verbose", tout << "explain-eq: " << bpp(a) << " == " << bpp(b) << " lca: " << bpp(lca) << "\n";);
+            push_to_lca(a, lca);
+            push_to_lca(b, lca);
+            if (m_used_eq)
+                m_used_eq(a->get_expr(), b->get_expr(), lca->get_expr());
+        }
         explain_todo(justifications);
+        if (use_cache)
+            insert_explain(justifications, sz, a, b);
+        m_stats.m_explain_length += justifications.size() - sz;
+    }
+
+    template <typename T>
+    bool egraph::explain_cached(ptr_vector<T>& justifications, enode* a, enode* b) {
+        if (a->get_expr_id() > b->get_expr_id())
+            std::swap(a, b);
+        unsigned idx;
+        if (!m_explain2entry.find(a, b, idx))
+            return false;
+        ++m_stats.m_num_explain_hits;
+        explain_entry const& e = m_explain_entries[idx];
+        bool is_last = idx + 1 == m_explain_entries.size();
+        unsigned end_j = is_last ? m_explain_justifications.size() : m_explain_entries[idx + 1].m_justifications;
+        unsigned end_n = is_last ? m_explain_nodes.size() : m_explain_entries[idx + 1].m_nodes;
+        for (unsigned i = e.m_justifications; i < end_j; ++i)
+            justifications.push_back(static_cast<T*>(m_explain_justifications[i]));
+        // mark the nodes as if they were explained, so that later explanations skip them.
+        for (unsigned i = e.m_nodes; i < end_n; ++i) {
+            enode* n = m_explain_nodes[i];
+            if (!n->is_marked1()) {
+                n->mark1();
+                m_todo.push_back(n);
+            }
+        }
+        m_uses_congruence |= e.m_uses_congruence;
+        return true;
+    }
+
+    template <typename T>
+    void egraph::insert_explain(ptr_vector<T>& justifications, unsigned sz, enode* a, enode* b) {
+        if (a->get_expr_id() > b->get_expr_id())
+            std::swap(a, b);
+        if (a == b || m_explain2entry.contains(a, b))
+            return;
+        m_explain2entry.insert(a, b, m_explain_entries.size());
+        m_explain_entries.push_back({ a, b, m_explain_justifications.size(), m_explain_nodes.size(), m_uses_congruence });
+        for (unsigned i = sz; i < justifications.size(); ++i)
+            m_explain_justifications.push_back(justifications[i]);
+        for (enode* n : m_todo)
+            if (n->is_marked1())
+                m_explain_nodes.push_back(n);
+        m_updates.push_back(update_record(update_record::new_explain_entry()));
+    }
+
+    void egraph::undo_explain_cache() {
+        explain_entry const& e = m_explain_entries.back();
+        m_explain2entry.erase(e.a, e.b);
+        m_explain_justifications.shrink(e.m_justifications);
+        m_explain_nodes.shrink(e.m_nodes);
+        m_explain_entries.pop_back();
+    }
+
+    void egraph::add_explain_edge(enode* a, enode* b, justification j) {
+        force_push();
+        unsigned idx = m_explain_edges.size();
+        unsigned ia = a->get_expr_id(), ib = b->get_expr_id();
+        m_explain_edge_head.reserve(std::max(ia, ib) + 1, UINT_MAX);
+        m_explain_edges.push_back({ a, b, j, m_explain_edge_head[ia], m_explain_edge_head[ib] });
+        m_explain_edge_head[ia] = idx;
+        m_explain_edge_head[ib] = idx;
+        m_updates.push_back(update_record(update_record::new_explain_edge()));
+    }
+
+    void egraph::undo_explain_edge() {
+        explain_edge const& e = m_explain_edges.back();
+        m_explain_edge_head[e.a->get_expr_id()] = e.m_next_a;
+        m_explain_edge_head[e.b->get_expr_id()] = e.m_next_b;
+        m_explain_edges.pop_back();
+    }
+
+    /**
+       \brief find a path with fewest edges from a to b in the class of a.
+       Edges of the proof forest are pushed to m_todo, other edges to m_explain_todo_edges.
+    */
+    void egraph::push_shortest(enode* a, enode* b) {
+        unsigned sz = m_expr2enode.size();
+        m_explain_via.reserve(sz, UINT_MAX);
+        m_explain_parent.reserve(sz, nullptr);
+        m_explain_child.reserve(sz, nullptr);
+        m_explain_sibling.reserve(sz, nullptr);
+        m_explain_edge_head.reserve(sz, UINT_MAX);
+        for (enode* c : enode_class(a))
+            m_explain_child[c->get_expr_id()] = nullptr;
+        for (enode* c : enode_class(a)) {
+            if (!c->m_target)
+                continue;
+            unsigned t = c->m_target->get_expr_id();
+            m_explain_sibling[c->get_expr_id()] = m_explain_child[t];
+            m_explain_child[t] = c;
+        }
+        enode_vector& queue = m_explain_nodes_tmp;
+        queue.reset();
+        auto visit = [&](enode* n, enode* parent, unsigned via) {
+            if (n->is_marked2())
+                return;
+            n->mark2();
+            m_explain_parent[n->get_expr_id()] = parent;
+            m_explain_via[n->get_expr_id()] = via;
+            queue.push_back(n);
+        };
+        visit(a, nullptr, UINT_MAX);
+        for (unsigned qhead = 0; qhead < queue.size() && !b->is_marked2(); ++qhead) {
+            enode* n = queue[qhead];
+            unsigned id = n->get_expr_id();
+            if (n->m_target)
+                visit(n->m_target, n, UINT_MAX);
+            for (enode* c = m_explain_child[id]; c; c = m_explain_sibling[c->get_expr_id()])
+                visit(c, n, UINT_MAX);
+            for (unsigned e = m_explain_edge_head[id]; e != UINT_MAX; ) {
+                explain_edge const& edge = m_explain_edges[e];
+                visit(edge.a == n ? edge.b : edge.a, n, e);
+                e = edge.a == n ? edge.m_next_a : edge.m_next_b;
+            }
+        }
+        VERIFY(b->is_marked2());
+        for (enode* n : queue)
+            n->unmark2();
+        for (enode* n = b; n != a; ) {
+            enode* p = m_explain_parent[n->get_expr_id()];
+            unsigned via = m_explain_via[n->get_expr_id()];
+            if (via != UINT_MAX)
+                m_explain_todo_edges.push_back(via);
+            else
+                m_todo.push_back(p->m_target == n ? p : n);
+            n = p;
+        }
+        TRACE("euf_verbose", tout << "explain-shortest: " << bpp(a) << " == " << bpp(b) << " path " << m_todo.size() + m_explain_todo_edges.size() << "\n";);
     }
 
     template <typename T>
@@ -780,6 +936,9 @@ namespace euf {
         st.update("euf propagations theory eqs", m_stats.m_num_th_eqs);
         st.update("euf propagations theory diseqs", m_stats.m_num_th_diseqs);
         st.update("euf propagations literal", m_stats.m_num_lits);
+        st.update("euf explain", m_stats.m_num_explain);
+        st.update("euf explain cache hits", m_stats.m_num_explain_hits);
+        st.update("euf explain length", m_stats.m_explain_length);
     }
 
     void egraph::copy_from(egraph const& src, std::function<void*(void*)>& copy_justification) {
@@ -22,6 +22,18 @@ Notes:
     NB. The worklist is in reality inheritied from the legacy SMT solver. 
     It is claimed to have the same effect as delayed congruence table reconstruction from egg.
     Similar to the legacy solver, parents are partially deduplicated.
+
+    Explanations of equalities are cached. The cached explanation of a == b
+    stays valid as long as the merges it uses are on the trail, and it is
+    recorded on the trail after them, so backtracking removes it first.
+    The cache is only used for the first equality explained between
+    begin_explain() and end_explain(), since later explanations skip
+    the parts already explained.
+
+    Explanations follow the proof forest by default. Merges of nodes that
+    are already equal are not part of the forest. With shortest explanations
+    they are retained and an explanation takes a path with fewest
+    equalities through both kinds of edges.
     
 --*/
 
@@ -29,6 +41,7 @@ Notes:
 #include "util/statistics.h"
 #include "util/trail.h"
 #include "util/lbool.h"
+#include "util/obj_pair_hashtable.h"
 #include "ast/euf/euf_enode.h"
 #include "ast/euf/euf_etable.h"
 #include "ast/ast_ll_pp.h"
@@ -89,6 +102,9 @@ namespace euf {
             unsigned m_num_lits;
             unsigned m_num_eqs;
             unsigned m_num_conflicts;
+            unsigned m_num_explain;
+            unsigned m_num_explain_hits;
+            unsigned m_explain_length;
             stats() { reset(); }
             void reset() { memset(this, 0, sizeof(*this)); }
         };
@@ -104,10 +120,13 @@ namespace euf {
             struct value_assignment {};
             struct lbl_hash {};
             struct lbl_set {};
+            struct new_explain_entry {};
+            struct new_explain_edge {};
             enum class tag_t { is_set_parent, is_add_node, is_toggle_merge, 
                     is_add_th_var, is_replace_th_var, is_new_lit, is_new_th_eq,
                     is_lbl_hash, is_new_th_eq_qhead, is_new_lits_qhead, 
-                    is_inconsistent, is_value_assignment, is_lbl_set };
+                    is_inconsistent, is_value_assignment, is_lbl_set,
+                    is_new_explain_entry, is_new_explain_edge };
             tag_t  tag;
             enode* r1;
             enode* n1;
@@ -148,7 +167,37 @@ namespace euf {
                 tag(tag_t::is_lbl_hash), r1(n), n1(nullptr), m_lbl_hash(n->m_lbl_hash) {}
             update_record(enode* n, lbl_set):
                 tag(tag_t::is_lbl_set), r1(n), n1(nullptr), m_lbls(n->m_lbls.get()) {}    
+            update_record(new_explain_entry):
+                tag(tag_t::is_new_explain_entry), r1(nullptr), n1(nullptr), qhead(0) {}
+            update_record(new_explain_edge):
+                tag(tag_t::is_new_explain_edge), r1(nullptr), n1(nullptr), qhead(0) {}
+        };
+
+        /**
+           \brief cached explanation of a == b.
+           The justifications and the nodes marked by the explanation are stored
+           from offsets m_justifications and m_nodes up to the offsets of the next entry.
+        */
+        struct explain_entry {
+            enode*   a;
+            enode*   b;
+            unsigned m_justifications;
+            unsigned m_nodes;
+            bool     m_uses_congruence;
+        };
+
+        /**
+           \brief merge of nodes that were already equal.
+           Edges adjacent to a node are linked through m_next_a, m_next_b.
+        */
+        struct explain_edge {
+            enode*        a;
+            enode*        b;
+            justification j;
+            unsigned      m_next_a;
+            unsigned      m_next_b;
         };
+
         ast_manager&           m;
         svector<to_merge>      m_to_merge;
         etable                 m_table;
@@ -182,6 +231,22 @@ namespace euf {
         std::function<void(app*,app*)>         m_used_cc;  
         std::function<void(std::ostream&, void*)>   m_display_justification;
 
+        bool                   m_explain_cache { true };
+        obj_pair_map<enode, enode, unsigned> m_explain2entry;
+        svector<explain_entry> m_explain_entries;
+        ptr_vector<void>       m_explain_justifications;
+        enode_vector           m_explain_nodes;
+
+        bool                   m_explain_shortest { false };
+        svector<explain_edge>  m_explain_edges;
+        unsigned_vector        m_explain_edge_head;  // first edge adjacent to node, indexed by expression id
+        unsigned_vector        m_explain_via;        // edge used to reach node in search for a shortest path
+        enode_vector           m_explain_parent;     // predecessor of node in search for a shortest path
+        enode_vector           m_explain_child;      // proof forest in reverse
+        enode_vector           m_explain_sibling;
+        unsigned_vector        m_explain_todo_edges;
+        enode_vector           m_explain_nodes_tmp;
+
         void push_eq(enode* r1, enode* n1, unsigned r2_num_parents) {
             m_updates.push_back(update_record(r1, n1, r2_num_parents));
         }
@@ -212,6 +277,15 @@ namespace euf {
         void push_todo(enode* n);
         void toggle_merge_enabled(enode* n);
 
+        void add_explain_edge(enode* a, enode* b, justification j);
+        void undo_explain_edge();
+        void push_shortest(enode* a, enode* b);
+        template <typename T>
+        bool explain_cached(ptr_vector<T>& justifications, enode* a, enode* b);
+        template <typename T>
+        void insert_explain(ptr_vector<T>& justifications, unsigned sz, enode* a, enode* b);
+        void undo_explain_cache();
+
         enode_bool_pair insert_table(enode* p);
         void erase_from_table(enode* p);
 
@@ -291,6 +365,8 @@ namespace euf {
         void set_used_eq(std::function<void(expr*,expr*,expr*)>& used_eq) { m_used_eq = used_eq; }
         void set_used_cc(std::function<void(app*,app*)>& used_cc) { m_used_cc = used_cc; }
         void set_display_justification(std::function<void (std::ostream&, void*)> & d) { m_display_justification = d; }
+        void set_explain_cache(bool f) { m_explain_cache = f; }
+        void set_explain_shortest(bool f) { m_explain_shortest = f; }
         
         void begin_explain();
         void end_explain();
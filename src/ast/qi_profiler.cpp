@@ -0,0 +1,292 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    qi_profiler.cpp
+
+Abstract:
+
+    Machine readable profile of quantifier instantiation.
+
+--*/
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include "ast/qi_profiler.h"
+#include "ast/ast_pp.h"
+
+namespace q {
+
+    static unsigned bucket(double v) {
+        unsigned i = 0;
+        for (double limit = 1; i + 1 < qi_profiler::num_buckets && v >= limit; limit *= 2)
+            ++i;
+        return i;
+    }
+
+    static std::ostream & json_string(std::ostream & out, std::string const & s) {
+        out << "\"";
+        for (char c : s) {
+            switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    out << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xf] << "0123456789abcdef"[c & 0xf];
+                else
+                    out << c;
+            }
+        }
+        return out << "\"";
+    }
+
+    static std::ostream & csv_string(std::ostream & out, std::string const & s) {
+        out << "\"";
+        for (char c : s) {
+            if (c == '"')
+                out << "\"";
+            out << c;
+        }
+        return out << "\"";
+    }
+
+    static std::ostream & json_histogram(std::ostream & out, unsigned const * h) {
+        out << "[";
+        for (unsigned i = 0; i < qi_profiler::num_buckets; ++i)
+            out << (i > 0 ? ", " : "") << h[i];
+        return out << "]";
+    }
+
+    static std::ostream & csv_histogram(std::ostream & out, unsigned const * h) {
+        for (unsigned i = 0; i < qi_profiler::num_buckets; ++i)
+            out << (i > 0 ? " " : "") << h[i];
+        return out;
+    }
+
+    static double share(unsigned n, unsigned total) {
+        return total == 0 ? 0.0 : static_cast<double>(n) / total;
+    }
+
+    qi_profiler::quantifier_profile::quantifier_profile(quantifier * q):
+        m_quantifier(q) {
+        memset(m_generations, 0, sizeof(m_generations));
+        memset(m_costs, 0, sizeof(m_costs));
+    }
+
+    qi_profiler::qi_profiler(ast_manager & m):
+        m(m),
+        m_pinned(m) {
+    }
+
+    qi_profiler::quantifier_profile & qi_profiler::get_profile(quantifier * q) {
+        unsigned idx;
+        if (m_q2profile.find(q, idx))
+            return *m_profiles[idx];
+        idx = m_profiles.size();
+        m_pinned.push_back(q);
+        m_profiles.push_back(alloc(quantifier_profile, q));
+        m_q2profile.insert(q, idx);
+        return *m_profiles[idx];
+    }
+
+    qi_profiler::pattern_profile * qi_profiler::get_pattern(quantifier_profile & p, app * pat) {
+        if (!pat)
+            return nullptr;
+        for (pattern_profile & pp : p.m_patterns)
+            if (pp.m_pattern == pat)
+                return &pp;
+        m_pinned.push_back(pat);
+        p.m_patterns.push_back(pattern_profile(pat));
+        return &p.m_patterns.back();
+    }
+
+    void qi_profiler::add_match(quantifier * q, app * pat) {
+        quantifier_profile & p = get_profile(q);
+        p.m_matches++;
+        if (pattern_profile * pp = get_pattern(p, pat))
+            pp->m_matches++;
+    }
+
+    void qi_profiler::add_instance(quantifier * q, app * pat, unsigned generation) {
+        quantifier_profile & p = get_profile(q);
+        p.m_instances++;
+        p.m_generations[bucket(generation)]++;
+        p.m_max_generation = std::max(p.m_max_generation, generation);
+        if (pattern_profile * pp = get_pattern(p, pat))
+            pp->m_instances++;
+    }
+
+    void qi_profiler::add_cost(quantifier * q, float cost) {
+        quantifier_profile & p = get_profile(q);
+        p.m_costs[bucket(cost)]++;
+        p.m_max_cost = std::max(p.m_max_cost, cost);
+    }
+
+    void qi_profiler::add_redundant(quantifier * q) {
+        get_profile(q).m_redundant++;
+    }
+
+    void qi_profiler::add_mam_time(func_decl * head, double seconds) {
+        unsigned idx;
+        if (!m_head2tree.find(head, idx)) {
+            idx = m_trees.size();
+            m_pinned.push_back(head);
+            m_trees.push_back(code_tree_profile(head));
+            m_head2tree.insert(head, idx);
+        }
+        m_trees[idx].m_executions++;
+        m_trees[idx].m_seconds += seconds;
+    }
+
+    void qi_profiler::add_conflict(quantifier_profile & p) {
+        if (p.m_last_conflict == m_num_conflicts)
+            return;
+        p.m_last_conflict = m_num_conflicts;
+        p.m_conflicts++;
+    }
+
+    void qi_profiler::add_conflict(quantifier * q) {
+        add_conflict(get_profile(q));
+    }
+
+    void qi_profiler::set_var_origin(unsigned v, quantifier * q) {
+        get_profile(q);
+        m_var2profile.reserve(v + 1, UINT_MAX);
+        m_var2profile[v] = m_q2profile.find(q);
+    }
+
+    void qi_profiler::add_conflict_var(unsigned v) {
+        if (v < m_var2profile.size() && m_var2profile[v] != UINT_MAX)
+            add_conflict(*m_profiles[m_var2profile[v]]);
+    }
+
+    void qi_profiler::shrink_var_origins(unsigned num_vars) {
+        if (num_vars < m_var2profile.size())
+            m_var2profile.shrink(num_vars);
+    }
+
+    std::string qi_profiler::pattern2string(quantifier * q, app * pat) const {
+        std::ostringstream strm;
+        unsigned num_vars = q->get_num_decls();
+        if (m.is_pattern(pat)) {
+            strm << "{";
+            for (unsigned i = 0; i < pat->get_num_args(); ++i)
+                strm << (i > 0 ? " " : "") << mk_ismt2_pp(pat->get_arg(i), m, 0, num_vars, "x");
+            strm << "}";
+        }
+        else
+            strm << mk_ismt2_pp(pat, m, 0, num_vars, "x");
+        // keep one pattern per line of CSV output.
+        std::string r;
+        for (char c : strm.str()) {
+            bool ws = c == ' ' || c == '\n' || c == '\t';
+            if (ws && (r.empty() || r.back() == ' '))
+                continue;
+            r.push_back(ws ? ' ' : c);
+        }
+        return r;
+    }
+
+    std::string qi_profiler::heads2string(app * pat) const {
+        std::ostringstream strm;
+        if (m.is_pattern(pat)) {
+            for (unsigned i = 0; i < pat->get_num_args(); ++i) {
+                expr * arg = pat->get_arg(i);
+                strm << (i > 0 ? " " : "");
+                if (is_app(arg))
+                    strm << to_app(arg)->get_decl()->get_name();
+            }
+        }
+        else
+            strm << pat->get_decl()->get_name();
+        return strm.str();
+    }
+
+    std::ostream & qi_profiler::display_json(std::ostream & out) const {
+        out << "{\n  \"conflicts\": " << m_num_conflicts << ",\n  \"bucket_limits\": [";
+        for (unsigned i = 0, limit = 1; i + 1 < num_buckets; ++i, limit *= 2)
+            out << (i > 0 ? ", " : "") << limit;
+        out << "],\n  \"quantifiers\": [";
+        bool first = true;
+        for (quantifier_profile const * p : m_profiles) {
+            out << (first ? "\n" : ",\n") << "    {\"qid\": ";
+            first = false;
+            json_string(out, p->m_quantifier->get_qid().str());
+            out << ", \"matches\": " << p->m_matches
+                << ", \"instances\": " << p->m_instances
+                << ", \"redundant\": " << p->m_redundant
+                << ", \"conflicts\": " << p->m_conflicts
+                << ", \"conflict_share\": " << share(p->m_conflicts, m_num_conflicts)
+                << ", \"max_generation\": " << p->m_max_generation
+                << ", \"max_cost\": " << p->m_max_cost
+                << ",\n     \"generations\": ";
+            json_histogram(out, p->m_generations);
+            out << ", \"costs\": ";
+            json_histogram(out, p->m_costs);
+            out << ",\n     \"patterns\": [";
+            bool first_pattern = true;
+            for (pattern_profile const & pp : p->m_patterns) {
+                out << (first_pattern ? "\n" : ",\n") << "       {\"pattern\": ";
+                first_pattern = false;
+                json_string(out, pattern2string(p->m_quantifier, pp.m_pattern));
+                out << ", \"heads\": ";
+                json_string(out, heads2string(pp.m_pattern));
+                out << ", \"matches\": " << pp.m_matches << ", \"instances\": " << pp.m_instances << "}";
+            }
+            out << "]}";
+        }
+        out << "],\n  \"mam\": [";
+        first = true;
+        for (code_tree_profile const & t : m_trees) {
+            out << (first ? "\n" : ",\n") << "    {\"head\": ";
+            first = false;
+            json_string(out, t.m_head->get_name().str());
+            out << ", \"executions\": " << t.m_executions << ", \"seconds\": " << t.m_seconds << "}";
+        }
+        return out << "]\n}\n";
+    }
+
+    std::ostream & qi_profiler::display_csv(std::ostream & out) const {
+        out << "kind,name,pattern,matches,instances,redundant,conflicts,conflict_share,max_generation,max_cost,generations,costs,executions,seconds\n";
+        for (quantifier_profile const * p : m_profiles) {
+            std::string qid = p->m_quantifier->get_qid().str();
+            out << "quantifier,";
+            csv_string(out, qid);
+            out << ",," << p->m_matches << "," << p->m_instances << "," << p->m_redundant
+                << "," << p->m_conflicts << "," << share(p->m_conflicts, m_num_conflicts)
+                << "," << p->m_max_generation << "," << p->m_max_cost << ",";
+            csv_histogram(out, p->m_generations) << ",";
+            csv_histogram(out, p->m_costs) << ",,\n";
+            for (pattern_profile const & pp : p->m_patterns) {
+                out << "pattern,";
+                csv_string(out, qid) << ",";
+                csv_string(out, pattern2string(p->m_quantifier, pp.m_pattern));
+                out << "," << pp.m_matches << "," << pp.m_instances << ",,,,,,,,,\n";
+            }
+        }
+        for (code_tree_profile const & t : m_trees) {
+            out << "mam,";
+            csv_string(out, t.m_head->get_name().str());
+            out << ",,,,,,,,,,," << t.m_executions << "," << t.m_seconds << "\n";
+        }
+        return out;
+    }
+
+    void qi_profiler::write(char const * file) const {
+        std::ofstream out(file);
+        if (!out) {
+            IF_VERBOSE(1, verbose_stream() << "(qi-profile :could-not-write " << file << ")\n";);
+            return;
+        }
+        size_t len = strlen(file);
+        if (len >= 4 && strcmp(file + len - 4, ".csv") == 0)
+            display_csv(out);
+        else
+            display_json(out);
+    }
+
+}
@@ -0,0 +1,152 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    qi_profiler.h
+
+Abstract:
+
+    Machine readable profile of quantifier instantiation.
+
+    For every quantifier and each of its patterns the profile records
+    the matches found by E-matching, the instances produced from them,
+    the distribution of their generation and cost, and the conflicts
+    the quantifier took part in. The time spent in the matching abstract
+    machine is recorded per code tree. Code trees are indexed by the head
+    symbol of a pattern, so patterns with the same head share their time.
+
+    The profile is shared by the E-matching engines of the legacy core
+    (smt::qi_queue) and of the new core (q::ematch). It is enabled by
+    smt.qi.profile and can be displayed as JSON or CSV.
+
+--*/
+#pragma once
+
+#include <string>
+#include "ast/ast.h"
+#include "util/obj_hashtable.h"
+#include "util/scoped_ptr_vector.h"
+#include "util/stopwatch.h"
+
+namespace q {
+
+    class qi_profiler {
+    public:
+        /**
+           \brief Generations and costs are collected in logarithmic buckets.
+           Bucket 0 holds values below 1, bucket i values in [2^(i-1), 2^i),
+           and the last bucket all values above.
+        */
+        static const unsigned num_buckets = 10;
+
+        struct pattern_profile {
+            app *    m_pattern;
+            unsigned m_matches { 0 };
+            unsigned m_instances { 0 };
+            pattern_profile(app * p): m_pattern(p) {}
+        };
+
+        struct quantifier_profile {
+            quantifier *            m_quantifier;
+            unsigned                m_matches { 0 };
+            unsigned                m_instances { 0 };
+            unsigned                m_redundant { 0 };     // instances that were already satisfied or simplified to true
+            unsigned                m_conflicts { 0 };
+            unsigned                m_last_conflict { UINT_MAX };
+            unsigned                m_max_generation { 0 };
+            float                   m_max_cost { 0 };
+            unsigned                m_generations[num_buckets];
+            unsigned                m_costs[num_buckets];  // only for instances that were ranked by the cost function
+            vector<pattern_profile> m_patterns;
+            quantifier_profile(quantifier * q);
+        };
+
+        struct code_tree_profile {
+            func_decl * m_head;
+            unsigned    m_executions { 0 };
+            double      m_seconds { 0 };
+            code_tree_profile(func_decl * h): m_head(h) {}
+        };
+
+    private:
+        ast_manager &                          m;
+        ast_ref_vector                         m_pinned;
+        obj_map<quantifier, unsigned>          m_q2profile;
+        scoped_ptr_vector<quantifier_profile>  m_profiles;
+        obj_map<func_decl, unsigned>           m_head2tree;
+        svector<code_tree_profile>             m_trees;
+        unsigned_vector                        m_var2profile;   // Boolean variables introduced by instances
+        unsigned                               m_num_conflicts { 0 };
+
+        quantifier_profile & get_profile(quantifier * q);
+        pattern_profile * get_pattern(quantifier_profile & p, app * pat);
+        void add_conflict(quantifier_profile & p);
+        std::string pattern2string(quantifier * q, app * pat) const;
+        std::string heads2string(app * pat) const;
+
+    public:
+        qi_profiler(ast_manager & m);
+
+        void add_match(quantifier * q, app * pat);
+        void add_instance(quantifier * q, app * pat, unsigned generation);
+        void add_cost(quantifier * q, float cost);
+        void add_redundant(quantifier * q);
+        void add_mam_time(func_decl * head, double seconds);
+
+        /**
+           \brief Conflicts are identified by the number of conflicts so far.
+           The engine updates the number before analyzing a new conflict.
+        */
+        void set_num_conflicts(unsigned n) { m_num_conflicts = n; }
+        unsigned num_conflicts() const { return m_num_conflicts; }
+
+        /**
+           \brief Record that q took part in the current conflict.
+           A quantifier is counted at most once per conflict.
+        */
+        void add_conflict(quantifier * q);
+
+        /**
+           \brief The legacy core does not track which instance produced a clause.
+           It attributes conflicts through the Boolean variables that were
+           introduced by the instances of a quantifier.
+           Origins of variables with index num_vars or above are dropped
+           by shrink_var_origins when the variables are deleted.
+        */
+        void set_var_origin(unsigned v, quantifier * q);
+        void add_conflict_var(unsigned v);
+        void shrink_var_origins(unsigned num_vars);
+
+        std::ostream & display_json(std::ostream & out) const;
+        std::ostream & display_csv(std::ostream & out) const;
+
+        /**
+           \brief Write the profile to file, as CSV if the name ends with .csv
+           and as JSON otherwise.
+        */
+        void write(char const * file) const;
+    };
+
+    /**
+       \brief Record the time spent executing the code tree of head
+       if quantifier instantiation is profiled.
+    */
+    class scoped_mam_timer {
+        qi_profiler * m_profiler;
+        func_decl *   m_head;
+        stopwatch     m_watch;
+    public:
+        scoped_mam_timer(qi_profiler * p, func_decl * head): m_profiler(p), m_head(head) {
+            if (m_profiler)
+                m_watch.start();
+        }
+        ~scoped_mam_timer() {
+            if (m_profiler) {
+                m_watch.stop();
+                m_profiler->add_mam_time(m_head, m_watch.get_seconds());
+            }
+        }
+    };
+
+}
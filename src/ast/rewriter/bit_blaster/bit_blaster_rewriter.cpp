@@ -24,30 +24,115 @@ Notes:
 #include "util/ref_util.h"
 #include "ast/ast_smt2_pp.h"
 
+/**
+   \brief Gates of the bit-blaster.
+
+   By default gates are built by the Boolean rewriter, which shares
+   syntactically equal gates through hash-consing.
+
+   In AIG mode (blast_aig) gates are normalized structurally, in the
+   spirit of And-Inverter graphs: conjunctions are binary with ordered
+   arguments and simplified by the two-level rules of aig_manager,
+   negations are moved out of xor and majority gates, and their
+   arguments are ordered. So gates that differ only by commutativity or
+   by the polarity of their inputs are shared across terms. Xor gates are
+   kept as equivalences since they have a smaller CNF than three and gates.
+*/
 struct blaster_cfg {
     typedef rational numeral;
 
     bool_rewriter & m_rewriter;
     bv_util &       m_util;
+    bool            m_aig { false };
     blaster_cfg(bool_rewriter & r, bv_util & u):m_rewriter(r), m_util(u) {}
 
     ast_manager & m() const { return m_util.get_manager(); }
     numeral power(unsigned n) const { return rational::power_of_two(n); }
-    void mk_xor(expr * a, expr * b, expr_ref & r) { m_rewriter.mk_xor(a, b, r); }
+    void mk_xor(expr * a, expr * b, expr_ref & r) {
+        if (m_aig)
+            mk_aig_iff(a, b, true, r);
+        else
+            m_rewriter.mk_xor(a, b, r);
+    }
     void mk_xor3(expr * a, expr * b, expr * c, expr_ref & r) {
         expr_ref tmp(m());
+        if (m_aig) {
+            bool sign = false;
+            expr * args[3] = { strip(a, sign), strip(b, sign), strip(c, sign) };
+            std::sort(args, args + 3, ast_lt_proc());
+            mk_aig_iff(args[1], args[2], true, tmp);
+            mk_aig_iff(args[0], tmp, !sign, r);
+            return;
+        }
         mk_xor(b, c, tmp);
         mk_xor(a, tmp, r);
     }
-    void mk_iff(expr * a, expr * b, expr_ref & r) { m_rewriter.mk_iff(a, b, r); }
-    void mk_and(expr * a, expr * b, expr_ref & r) { m_rewriter.mk_and(a, b, r); }
-    void mk_and(expr * a, expr * b, expr * c, expr_ref & r) { m_rewriter.mk_and(a, b, c, r); }
-    void mk_and(unsigned sz, expr * const * args, expr_ref & r) { m_rewriter.mk_and(sz, args, r); }
-    void mk_or(expr * a, expr * b, expr_ref & r) { m_rewriter.mk_or(a, b, r); }
-    void mk_or(expr * a, expr * b, expr * c, expr_ref & r) { m_rewriter.mk_or(a, b, c, r); }
-    void mk_or(unsigned sz, expr * const * args, expr_ref & r) { m_rewriter.mk_or(sz, args, r); }
+    void mk_iff(expr * a, expr * b, expr_ref & r) {
+        if (m_aig)
+            mk_aig_iff(a, b, false, r);
+        else
+            m_rewriter.mk_iff(a, b, r);
+    }
+    void mk_and(expr * a, expr * b, expr_ref & r) {
+        if (m_aig)
+            mk_aig_and(a, b, r);
+        else
+            m_rewriter.mk_and(a, b, r);
+    }
+    void mk_and(expr * a, expr * b, expr * c, expr_ref & r) {
+        expr * args[3] = { a, b, c };
+        mk_and(3, args, r);
+    }
+    void mk_and(unsigned sz, expr * const * args, expr_ref & r) {
+        if (!m_aig) {
+            m_rewriter.mk_and(sz, args, r);
+            return;
+        }
+        ptr_buffer<expr> sorted;
+        sorted.append(sz, args);
+        std::sort(sorted.begin(), sorted.end(), ast_lt_proc());
+        r = m().mk_true();
+        for (expr * arg : sorted)
+            mk_aig_and(r, arg, r);
+    }
+    void mk_or(expr * a, expr * b, expr_ref & r) {
+        if (!m_aig) {
+            m_rewriter.mk_or(a, b, r);
+            return;
+        }
+        expr_ref na(m()), nb(m());
+        mk_not(a, na);
+        mk_not(b, nb);
+        mk_aig_and(na, nb, r);
+        negate(r);
+    }
+    void mk_or(expr * a, expr * b, expr * c, expr_ref & r) {
+        expr * args[3] = { a, b, c };
+        mk_or(3, args, r);
+    }
+    void mk_or(unsigned sz, expr * const * args, expr_ref & r) {
+        if (!m_aig) {
+            m_rewriter.mk_or(sz, args, r);
+            return;
+        }
+        expr_ref_vector nargs(m());
+        for (unsigned i = 0; i < sz; ++i) {
+            mk_not(args[i], r);
+            nargs.push_back(r);
+        }
+        mk_and(sz, nargs.data(), r);
+        negate(r);
+    }
     void mk_not(expr * a, expr_ref & r) { m_rewriter.mk_not(a, r); }
+    void negate(expr_ref & r) {
+        expr_ref tmp(r);
+        mk_not(tmp, r);
+    }
     void mk_carry(expr * a, expr * b, expr * c, expr_ref & r) {
+        if (m_aig) {
+            mk_aig_carry(a, b, c, r);
+            return;
+        }
         expr_ref t1(m()), t2(m()), t3(m());
 #if 1
         mk_and(a, b, t1);
@@ -61,10 +146,191 @@ struct blaster_cfg {
         mk_and(t1, t2, t3, r);
 #endif
     }
-    void mk_ite(expr * c, expr * t, expr * e, expr_ref & r) { m_rewriter.mk_ite(c, t, e, r); }
-    void mk_nand(expr * a, expr * b, expr_ref & r) { m_rewriter.mk_nand(a, b, r); }
-    void mk_nor(expr * a, expr * b, expr_ref & r) { m_rewriter.mk_nor(a, b, r); }
-    void mk_ge2(expr * a, expr * b, expr * c, expr_ref& r) { m_rewriter.mk_ge2(a, b, c, r); }
+    void mk_ite(expr * c, expr * t, expr * e, expr_ref & r) {
+        if (!m_aig) {
+            m_rewriter.mk_ite(c, t, e, r);
+            return;
+        }
+        if (t == e) {
+            r = t;
+            return;
+        }
+        expr_ref nc(m()), t1(m()), t2(m());
+        mk_not(c, nc);
+        mk_aig_and(c, t, t1);
+        mk_aig_and(nc, e, t2);
+        mk_or(t1, t2, r);
+    }
+    void mk_nand(expr * a, expr * b, expr_ref & r) {
+        if (!m_aig) {
+            m_rewriter.mk_nand(a, b, r);
+            return;
+        }
+        mk_aig_and(a, b, r);
+        negate(r);
+    }
+    void mk_nor(expr * a, expr * b, expr_ref & r) {
+        if (!m_aig) {
+            m_rewriter.mk_nor(a, b, r);
+            return;
+        }
+        mk_or(a, b, r);
+        negate(r);
+    }
+    void mk_ge2(expr * a, expr * b, expr * c, expr_ref& r) {
+        if (m_aig)
+            mk_aig_carry(a, b, c, r);
+        else
+            m_rewriter.mk_ge2(a, b, c, r);
+    }
+
+    // AIG mode
+
+    expr * strip(expr * a, bool & sign) const {
+        expr * x;
+        while (m().is_not(a, x)) {
+            a = x;
+            sign = !sign;
+        }
+        if (m().is_false(a)) {
+            a = m().mk_true();
+            sign = !sign;
+        }
+        return a;
+    }
+
+    bool is_complement(expr * a, expr * b) const {
+        expr * x;
+        return (m().is_not(a, x) && x == b) || (m().is_not(b, x) && x == a);
+    }
+
+    /**
+       \brief r := (a = b) if sign is false and r := (a xor b) otherwise.
+    */
+    void mk_aig_iff(expr * a, expr * b, bool sign, expr_ref & r) {
+        a = strip(a, sign);
+        b = strip(b, sign);
+        if (a->get_id() > b->get_id())
+            std::swap(a, b);
+        expr_ref tmp(m());
+        if (a == b)
+            tmp = m().mk_true();
+        else if (m().is_true(a))
+            tmp = b;
+        else if (m().is_true(b))
+            tmp = a;
+        else
+            tmp = m().mk_eq(a, b);
+        if (sign)
+            mk_not(tmp, r);
+        else
+            r = tmp;
+    }
+
+    /**
+       \brief Binary conjunction with the two-level minimization rules of aig_manager::mk_node.
+    */
+    void mk_aig_and(expr * a, expr * b, expr_ref & r) {
+        expr_ref l(a, m()), k(b, m()), n(m());
+        expr * x, * y, * na;
+    start:
+        if (m().is_false(l) || m().is_false(k)) {
+            r = m().mk_false();
+            return;
+        }
+        if (m().is_true(l) || l == k) {
+            r = k;
+            return;
+        }
+        if (m().is_true(k)) {
+            r = l;
+            return;
+        }
+        if (is_complement(l, k)) {
+            r = m().mk_false();
+            return;
+        }
+        for (unsigned i = 0; i < 2; ++i) {
+            expr * u = i == 0 ? l : k;
+            expr * v = i == 0 ? k : l;
+            if (m().is_and(u, x, y)) {
+                // (x and y) and v --> false  IF x = (not v) or y = (not v)
+                if (is_complement(x, v) || is_complement(y, v)) {
+                    r = m().mk_false();
+                    return;
+                }
+                // (x and y) and v --> (x and y)  IF x = v or y = v
+                if (x == v || y == v) {
+                    r = u;
+                    return;
+                }
+            }
+            if (m().is_not(u, na) && m().is_and(na, x, y)) {
+                // not (x and y) and v --> v  IF x = (not v) or y = (not v)
+                if (is_complement(x, v) || is_complement(y, v)) {
+                    r = v;
+                    return;
+                }
+                // not (x and y) and v --> (not y) and v  IF x = v
+                // not (x and y) and v --> (not x) and v  IF y = v
+                if (x == v || y == v) {
+                    mk_not(x == v ? y : x, n);
+                    k = v;
+                    l = n;
+                    goto start;
+                }
+            }
+        }
+        if (l->get_id() > k->get_id())
+            r = m().mk_and(k, l);
+        else
+            r = m().mk_and(l, k);
+    }
+
+    /**
+       \brief Majority of a, b, c. Negations are moved out if at least two
+       inputs are negated, since maj(not a, not b, not c) = not maj(a, b, c).
+    */
+    void mk_aig_carry(expr * a, expr * b, expr * c, expr_ref & r) {
+        expr * args[3] = { a, b, c };
+        expr_ref_vector nargs(m());
+        unsigned num_neg = 0;
+        for (expr * arg : args)
+            if (m().is_not(arg) || m().is_false(arg))
+                ++num_neg;
+        bool sign = num_neg >= 2;
+        if (sign) {
+            for (unsigned i = 0; i < 3; ++i) {
+                expr_ref t(m());
+                mk_not(args[i], t);
+                nargs.push_back(t);
+                args[i] = t;
+            }
+        }
+        std::sort(args, args + 3, ast_lt_proc());
+        expr_ref tmp(m());
+        if (args[0] == args[1] || args[0] == args[2])
+            tmp = args[0];
+        else if (args[1] == args[2])
+            tmp = args[1];
+        else if (is_complement(args[0], args[1]))
+            tmp = args[2];
+        else if (is_complement(args[0], args[2]))
+            tmp = args[1];
+        else if (is_complement(args[1], args[2]))
+            tmp = args[0];
+        else {
+            expr_ref t1(m()), t2(m()), t3(m());
+            mk_aig_and(args[0], args[1], t1);
+            mk_aig_and(args[0], args[2], t2);
+            mk_aig_and(args[1], args[2], t3);
+            mk_or(t1, t2, t3, tmp);
+        }
+        if (sign)
+            mk_not(tmp, r);
+        else
+            r = tmp;
+    }
 };
 
 class blaster : public bit_blaster_tpl<blaster_cfg> {
@@ -80,6 +346,8 @@ public:
     }
 
     bv_util & butil() { return m_util; }
+
+    void set_aig(bool f) { m_aig = f; }
 };
 
 struct blaster_rewriter_cfg : public default_rewriter_cfg {
@@ -135,6 +403,16 @@ struct blaster_rewriter_cfg : public default_rewriter_cfg {
         m_blast_full     = p.get_bool("blast_full", false);
         m_blast_quant    = p.get_bool("blast_quant", false);
         m_blaster.set_max_memory(m_max_memory);
+        m_blaster.set_aig(p.get_bool("blast_aig", false));
+        symbol enc = p.get_sym("blast_mul_encoding", symbol("array"));
+        if (enc == "array")
+            m_blaster.set_mul_encoding(false);
+        else if (enc == "wallace")
+            m_blaster.set_mul_encoding(true);
+        else if (enc == "karatsuba")
+            m_blaster.set_mul_encoding(false, p.get_uint("blast_karatsuba_threshold", 32));
+        else
+            throw default_exception("invalid value for blast_mul_encoding, expected array, wallace or karatsuba");
     }
 
     bool rewrite_patterns() const { return true; }
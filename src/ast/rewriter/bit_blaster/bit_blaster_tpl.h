@@ -37,6 +37,7 @@ protected:
     unsigned long long m_max_memory;
     bool               m_use_wtm; /* Wallace Tree Multiplier */
     bool               m_use_bcm; /* Booth Multiplier for constants */
+    unsigned           m_karatsuba_threshold; /* Karatsuba splitting for multipliers of at least this width */
     void checkpoint();
 
 public:
@@ -44,13 +45,25 @@ public:
         Cfg(cfg),
         m_max_memory(max_memory),
         m_use_wtm(use_wtm),
-        m_use_bcm(use_bcm) {
+        m_use_bcm(use_bcm),
+        m_karatsuba_threshold(UINT_MAX) {
     }
 
     void set_max_memory(unsigned long long max_memory) {
         m_max_memory = max_memory;
     }
 
+    /**
+       \brief Select the encoding of multipliers. Products of width at least
+       karatsuba_threshold are split recursively (Karatsuba), the remaining ones
+       use a Wallace tree if use_wtm is set and an array multiplier otherwise.
+    */
+    void set_mul_encoding(bool use_wtm, unsigned karatsuba_threshold = UINT_MAX) {
+        m_use_wtm = use_wtm;
+        // splitting narrower products does not terminate.
+        m_karatsuba_threshold = std::max(karatsuba_threshold, 8u);
+    }
+
     
     // Cfg required API
     ast_manager & m() const { return Cfg::m(); }
@@ -120,6 +133,8 @@ public:
     void mk_smul_no_underflow(unsigned sz, expr * const * a_bits,  expr * const * b_bits, expr_ref & out);
     void mk_comp(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits);
 
+    void mk_karatsuba_multiplier(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits);
+    void mk_karatsuba_product(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits);
     void mk_carry_save_adder(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr * const * c_bits, expr_ref_vector & sum_bits, expr_ref_vector & carry_bits);
     bool mk_const_multiplier(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits);
     bool mk_const_case_multiplier(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits);
@@ -204,6 +204,11 @@ void bit_blaster_tpl<Cfg>::mk_multiplier(unsigned sz, expr * const * a_bits, exp
         return;
     }
     out_bits.reset();
+    if (sz >= m_karatsuba_threshold) {
+        mk_karatsuba_multiplier(sz, a_bits, b_bits, out_bits);
+        SASSERT(sz == out_bits.size());
+        return;
+    }
     if (!m_use_wtm) {
 #if 0
     static unsigned counter = 0;
@@ -349,6 +354,91 @@ void bit_blaster_tpl<Cfg>::mk_multiplier(unsigned sz, expr * const * a_bits, exp
     }
 }
 
+/**
+   \brief Multiplier modulo 2^sz that splits the operands into halves a = a1*2^lo + a0, b = b1*2^lo + b0
+   where lo >= sz - lo. Only the product a0*b0 is needed in full width, the cross products a1*b0 and a0*b1
+   are truncated to the upper sz - lo bits and a1*b1 vanishes.
+*/
+template<typename Cfg>
+void bit_blaster_tpl<Cfg>::mk_karatsuba_multiplier(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits) {
+    SASSERT(sz >= 2);
+    unsigned lo = (sz + 1) / 2, hi = sz - lo;
+    expr_ref zero(m());
+    zero = m().mk_false();
+    expr_ref_vector p0(m()), p1(m()), p2(m()), cross(m());
+    mk_karatsuba_product(lo, a_bits, b_bits, p0);
+    mk_multiplier(hi, a_bits + lo, b_bits, p1);
+    mk_multiplier(hi, b_bits + lo, a_bits, p2);
+    mk_adder(hi, p1.data(), p2.data(), cross);
+    ptr_buffer<expr, 128> shifted;
+    for (unsigned i = 0; i < lo; i++)
+        shifted.push_back(zero);
+    shifted.append(hi, cross.data());
+    SASSERT(p0.size() >= sz);
+    mk_adder(sz, p0.data(), shifted.data(), out_bits);
+}
+
+/**
+   \brief Full product of width 2*sz of a and b.
+   Wide products are computed by Karatsuba's method using three products of half the width:
+   a*b = z2*2^(2h) + (z1 - z2 - z0)*2^h + z0
+   where z0 = a0*b0, z2 = a1*b1, z1 = (a0 + a1)*(b0 + b1).
+*/
+template<typename Cfg>
+void bit_blaster_tpl<Cfg>::mk_karatsuba_product(unsigned sz, expr * const * a_bits, expr * const * b_bits, expr_ref_vector & out_bits) {
+    checkpoint();
+    expr_ref zero(m());
+    zero = m().mk_false();
+    out_bits.reset();
+    if (sz < m_karatsuba_threshold) {
+        ptr_buffer<expr, 128> a, b;
+        a.append(sz, a_bits);
+        b.append(sz, b_bits);
+        for (unsigned i = 0; i < sz; i++) {
+            a.push_back(zero);
+            b.push_back(zero);
+        }
+        // the upper halves are zero, so the gates for them simplify away.
+        flet<unsigned> _no_split(m_karatsuba_threshold, UINT_MAX);
+        mk_multiplier(2 * sz, a.data(), b.data(), out_bits);
+        return;
+    }
+    unsigned h = sz / 2, k = sz - h;
+    ptr_buffer<expr, 128> a0, b0, a1, b1;
+    a0.append(h, a_bits);
+    b0.append(h, b_bits);
+    a1.append(k, a_bits + h);
+    b1.append(k, b_bits + h);
+    for (unsigned i = h; i <= k; i++) {
+        a0.push_back(zero);
+        b0.push_back(zero);
+    }
+    a1.push_back(zero);
+    b1.push_back(zero);
+    expr_ref_vector z0(m()), z1(m()), z2(m()), sa(m()), sb(m()), t(m()), mid(m());
+    mk_karatsuba_product(h, a_bits, b_bits, z0);
+    mk_karatsuba_product(k, a_bits + h, b_bits + h, z2);
+    mk_adder(k + 1, a0.data(), a1.data(), sa);
+    mk_adder(k + 1, b0.data(), b1.data(), sb);
+    mk_karatsuba_product(k + 1, sa.data(), sb.data(), z1);
+    // z1 - z2 - z0 is non-negative and fits into 2*k + 2 bits.
+    unsigned w = 2 * k + 2;
+    while (z0.size() < w)
+        z0.push_back(zero);
+    while (z2.size() < w)
+        z2.push_back(zero);
+    expr_ref cout(m());
+    mk_subtracter(w, z1.data(), z2.data(), t, cout);
+    mk_subtracter(w, t.data(), z0.data(), mid, cout);
+    // the result fits into 2*sz bits, so all sums are taken modulo 2^(2*sz).
+    ptr_buffer<expr, 128> low, shifted;
+    for (unsigned i = 0; i < 2 * sz; i++) {
+        low.push_back(i < 2 * h ? z0.get(i) : z2.get(i - 2 * h));
+        shifted.push_back(i < h || i - h >= w ? zero.get() : mid.get(i - h));
+    }
+    mk_adder(2 * sz, low.data(), shifted.data(), out_bits);
+}
+
 
 template<typename Cfg>
 void bit_blaster_tpl<Cfg>::mk_umul_no_overflow(unsigned sz, expr * const * a_bits,  expr * const * b_bits, expr_ref & result) {
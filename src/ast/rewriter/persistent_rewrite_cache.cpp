@@ -0,0 +1,352 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    persistent_rewrite_cache.cpp
+
+Abstract:
+
+    On-disk cache of rewriter results that is shared across processes.
+
+    File layout:
+
+      header   "Z3RWC" followed by a version byte
+      record   key         (8 bytes)
+               input size  (4 bytes)
+               result size (4 bytes)
+               checksum    (4 bytes) of the previous fields and the payload
+               input serialization
+               result serialization (empty if the input is unchanged)
+
+    All integers are stored little endian.
+
+--*/
+#include <cstring>
+#include <fstream>
+#include <map>
+#ifndef _WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "util/hash.h"
+#include "util/map.h"
+#include "util/mutex.h"
+#include "util/scoped_ptr_vector.h"
+#include "ast/ast_serialize.h"
+#include "ast/rewriter/persistent_rewrite_cache.h"
+
+static const char          CACHE_MAGIC[]   = { 'Z', '3', 'R', 'W', 'C' };
+static const unsigned      CACHE_MAGIC_SIZE = sizeof(CACHE_MAGIC);
+static const unsigned char CACHE_VERSION   = 1;
+static const unsigned      RECORD_HEADER_SIZE = 20;
+
+static uint64_t read_u64(char const * p) {
+    uint64_t r = 0;
+    for (unsigned i = 8; i-- > 0; )
+        r = (r << 8) | static_cast<unsigned char>(p[i]);
+    return r;
+}
+
+static unsigned read_u32(char const * p) {
+    unsigned r = 0;
+    for (unsigned i = 4; i-- > 0; )
+        r = (r << 8) | static_cast<unsigned char>(p[i]);
+    return r;
+}
+
+static void write_u64(std::string & out, uint64_t v) {
+    for (unsigned i = 0; i < 8; ++i, v >>= 8)
+        out.push_back(static_cast<char>(v & 0xff));
+}
+
+static void write_u32(std::string & out, unsigned v) {
+    for (unsigned i = 0; i < 4; ++i, v >>= 8)
+        out.push_back(static_cast<char>(v & 0xff));
+}
+
+static unsigned record_checksum(char const * record, unsigned payload_size) {
+    unsigned h = string_hash(record, 16, 31);
+    return string_hash(record + RECORD_HEADER_SIZE, payload_size, h);
+}
+
+/**
+   \brief Contents of a cache file. A store is shared by all caches opened
+   on the same file with the same fingerprint, and it does not depend on
+   an ast_manager: entries are serialized terms.
+*/
+class persistent_rewrite_cache::store {
+    struct entry {
+        char const * m_input;
+        unsigned     m_input_size;
+        char const * m_result;
+        unsigned     m_result_size;  // 0 if the input is unchanged by rewriting
+    };
+
+    std::string                    m_file;
+    unsigned                       m_fingerprint;
+    char const *                   m_data { nullptr };   // mapped contents of the cache file
+    size_t                         m_size { 0 };
+    std::string                    m_buffer;             // used when the file cannot be mapped
+    bool                           m_writable { true };
+    bool                           m_need_header { false };
+    u64_map<entry>                 m_index;
+    scoped_ptr_vector<std::string> m_new_records;        // backing storage for entries added by this process
+    std::string                    m_pending;            // records not yet appended to the file
+    mutex                          m_mux;
+
+    void load();
+    void unmap();
+    void flush_core();
+
+public:
+    unsigned m_ref_count { 0 };   // protected by the registry lock
+
+    // appends are written once this many bytes are pending.
+    static const size_t c_flush_size = 1 << 16;
+
+    store(std::string const & file, unsigned fingerprint): m_file(file), m_fingerprint(fingerprint) { load(); }
+    ~store() { flush(); unmap(); }
+
+    uint64_t mk_key(std::string const & input) const;
+    bool find(std::string const & input, char const * & result, unsigned & result_size);
+    void insert(std::string const & input, std::string const & result);
+    void flush() { lock_guard lock(m_mux); flush_core(); }
+    unsigned size() { lock_guard lock(m_mux); return m_index.size(); }
+};
+
+// stores are registered by file and fingerprint, they are freed when the last cache using them is.
+static mutex g_stores_mux;
+static std::map<std::string, persistent_rewrite_cache::store*> g_stores;
+
+static std::string mk_store_key(char const * file, unsigned fingerprint) {
+    return std::to_string(fingerprint) + ":" + file;
+}
+
+persistent_rewrite_cache::persistent_rewrite_cache(ast_manager & m, char const * file, unsigned fingerprint):
+    m(m) {
+    lock_guard lock(g_stores_mux);
+    store * & s = g_stores[mk_store_key(file, fingerprint)];
+    if (!s)
+        s = alloc(store, file, fingerprint);
+    m_store = s;
+    ++m_store->m_ref_count;
+}
+
+persistent_rewrite_cache::~persistent_rewrite_cache() {
+    IF_VERBOSE(10, verbose_stream() << "(rewriter-cache :hits " << m_hits << " :misses " << m_misses << ")\n";);
+    m_store->flush();
+    lock_guard lock(g_stores_mux);
+    if (--m_store->m_ref_count > 0)
+        return;
+    for (auto it = g_stores.begin(); it != g_stores.end(); ++it) {
+        if (it->second == m_store) {
+            g_stores.erase(it);
+            break;
+        }
+    }
+    dealloc(m_store);
+}
+
+unsigned persistent_rewrite_cache::size() const {
+    return m_store->size();
+}
+
+void persistent_rewrite_cache::flush() {
+    m_store->flush();
+}
+
+bool persistent_rewrite_cache::find(expr * t, expr_ref & result) {
+    m_input.clear();
+    m_has_input = false;
+    try {
+        ast_serialize(m, t, m_input);
+    }
+    catch (default_exception & ex) {
+        // terms with lambda definitions or external parameters are not cached.
+        IF_VERBOSE(10, verbose_stream() << "(rewriter-cache :skip \"" << ex.msg() << "\")\n";);
+        return false;
+    }
+    m_has_input = true;
+    char const * r = nullptr;
+    unsigned r_size = 0;
+    if (!m_store->find(m_input, r, r_size)) {
+        ++m_misses;
+        return false;
+    }
+    if (r_size == 0)
+        result = t;
+    else
+        result = ast_deserialize(m, r, r_size);
+    if (!result) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    return true;
+}
+
+void persistent_rewrite_cache::insert(expr * t, expr * r) {
+    if (!m_has_input)
+        return;
+    m_has_input = false;
+    std::string result;
+    if (t != r) {
+        try {
+            ast_serialize(m, r, result);
+        }
+        catch (default_exception & ex) {
+            IF_VERBOSE(10, verbose_stream() << "(rewriter-cache :skip \"" << ex.msg() << "\")\n";);
+            return;
+        }
+    }
+    m_store->insert(m_input, result);
+}
+
+uint64_t persistent_rewrite_cache::store::mk_key(std::string const & input) const {
+    unsigned sz = static_cast<unsigned>(input.size());
+    uint64_t h1 = string_hash(input.data(), sz, m_fingerprint);
+    uint64_t h2 = string_hash(input.data(), sz, ~m_fingerprint);
+    return (h1 << 32) | h2;
+}
+
+void persistent_rewrite_cache::store::unmap() {
+#ifndef _WINDOWS
+    if (m_data && m_buffer.empty())
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_buffer.clear();
+}
+
+void persistent_rewrite_cache::store::load() {
+#ifndef _WINDOWS
+    int fd = open(m_file.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void * p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                m_data = static_cast<char const*>(p);
+                m_size = st.st_size;
+            }
+        }
+        close(fd);
+    }
+#endif
+    if (!m_data) {
+        std::ifstream in(m_file, std::ios::binary);
+        if (in) {
+            m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+        }
+    }
+    if (!m_data || m_size <= CACHE_MAGIC_SIZE ||
+        memcmp(m_data, CACHE_MAGIC, CACHE_MAGIC_SIZE) != 0 ||
+        static_cast<unsigned char>(m_data[CACHE_MAGIC_SIZE]) != CACHE_VERSION) {
+        if (m_data) {
+            // do not append to a file that is not a cache.
+            IF_VERBOSE(2, verbose_stream() << "(rewriter-cache :ignoring " << m_file << ")\n";);
+            m_writable = false;
+        }
+        m_need_header = !m_data;
+        unmap();
+        return;
+    }
+    char const * curr = m_data + CACHE_MAGIC_SIZE + 1;
+    char const * end  = m_data + m_size;
+    while (static_cast<size_t>(end - curr) >= RECORD_HEADER_SIZE) {
+        entry e;
+        uint64_t key      = read_u64(curr);
+        e.m_input_size    = read_u32(curr + 8);
+        e.m_result_size   = read_u32(curr + 12);
+        unsigned checksum = read_u32(curr + 16);
+        size_t payload = static_cast<size_t>(e.m_input_size) + e.m_result_size;
+        if (static_cast<size_t>(end - curr) - RECORD_HEADER_SIZE < payload)
+            break;
+        if (record_checksum(curr, static_cast<unsigned>(payload)) != checksum)
+            break;
+        e.m_input  = curr + RECORD_HEADER_SIZE;
+        e.m_result = e.m_input + e.m_input_size;
+        m_index.insert(key, e);
+        curr += RECORD_HEADER_SIZE + payload;
+    }
+    IF_VERBOSE(10, verbose_stream() << "(rewriter-cache :file " << m_file << " :entries " << m_index.size() << ")\n";);
+}
+
+bool persistent_rewrite_cache::store::find(std::string const & input, char const * & result, unsigned & result_size) {
+    lock_guard lock(m_mux);
+    entry e;
+    if (!m_index.find(mk_key(input), e) ||
+        e.m_input_size != input.size() ||
+        memcmp(e.m_input, input.data(), e.m_input_size) != 0)
+        return false;
+    // entries are never removed, so the result stays valid after the lock is released.
+    result = e.m_result;
+    result_size = e.m_result_size;
+    return true;
+}
+
+void persistent_rewrite_cache::store::insert(std::string const & input, std::string const & result) {
+    lock_guard lock(m_mux);
+    uint64_t key = mk_key(input);
+    if (m_index.contains(key))
+        return;
+
+    std::string * record = alloc(std::string);
+    m_new_records.push_back(record);
+    write_u64(*record, key);
+    write_u32(*record, static_cast<unsigned>(input.size()));
+    write_u32(*record, static_cast<unsigned>(result.size()));
+    write_u32(*record, 0);
+    record->append(input);
+    record->append(result);
+    unsigned checksum = record_checksum(record->data(), static_cast<unsigned>(input.size() + result.size()));
+    for (unsigned i = 0; i < 4; ++i)
+        (*record)[16 + i] = static_cast<char>((checksum >> (8 * i)) & 0xff);
+
+    entry e;
+    e.m_input       = record->data() + RECORD_HEADER_SIZE;
+    e.m_input_size  = static_cast<unsigned>(input.size());
+    e.m_result      = e.m_input + e.m_input_size;
+    e.m_result_size = static_cast<unsigned>(result.size());
+    m_index.insert(key, e);
+
+    if (!m_writable)
+        return;
+    m_pending.append(*record);
+    if (m_pending.size() >= c_flush_size)
+        flush_core();
+}
+
+void persistent_rewrite_cache::store::flush_core() {
+    if (m_pending.empty())
+        return;
+    // Pending records are written with a single call, so concurrent writers
+    // append whole records in the common case. Corrupted records are
+    // detected by the checksum when the file is loaded.
+    if (m_need_header) {
+        // another process may have created the file in the meantime.
+        std::ifstream in(m_file, std::ios::binary | std::ios::ate);
+        m_need_header = !in || in.tellg() <= 0;
+    }
+    std::ofstream out(m_file, std::ios::binary | std::ios::app);
+    if (!out) {
+        IF_VERBOSE(2, verbose_stream() << "(rewriter-cache :could-not-write " << m_file << ")\n";);
+        m_writable = false;
+        m_pending.clear();
+        return;
+    }
+    if (m_need_header) {
+        out.write(CACHE_MAGIC, CACHE_MAGIC_SIZE);
+        out.put(static_cast<char>(CACHE_VERSION));
+        m_need_header = false;
+    }
+    out.write(m_pending.data(), m_pending.size());
+    m_pending.clear();
+}
@@ -0,0 +1,75 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    persistent_rewrite_cache.h
+
+Abstract:
+
+    On-disk cache of rewriter results that is shared across processes.
+
+    Entries are content addressed: the key is a 64 bit hash of the
+    serialization of the input term (see ast_serialize.h) combined with a
+    fingerprint of the rewriter configuration. The input serialization is
+    stored with each entry and compared on lookup, so hash collisions can
+    only cause cache misses.
+
+    The cache file is an append-only log. It is memory mapped when opened,
+    entries added by the current process are kept in memory and appended
+    to the file in batches. Records carry a checksum; loading stops at the
+    first truncated or corrupted record.
+
+    The contents of a file are loaded once per process: all caches opened
+    on the same file with the same fingerprint share one store, also across
+    managers and threads.
+
+--*/
+#pragma once
+
+#include <string>
+#include "ast/ast.h"
+
+class persistent_rewrite_cache {
+public:
+    class store;   // contents of a cache file, shared by the caches opened on it
+
+private:
+    ast_manager & m;
+    store *       m_store;
+    std::string   m_input;       // serialization of the last term looked up
+    bool          m_has_input { false };
+    unsigned      m_hits { 0 };
+    unsigned      m_misses { 0 };
+
+public:
+    /**
+       \brief Open the cache stored in file. The fingerprint identifies the
+       configuration of the rewriter, entries created with a different
+       fingerprint are ignored.
+    */
+    persistent_rewrite_cache(ast_manager & m, char const * file, unsigned fingerprint);
+    ~persistent_rewrite_cache();
+
+    /**
+       \brief Look up the result of rewriting t.
+       Return false if t is not in the cache, or if t cannot be serialized.
+    */
+    bool find(expr * t, expr_ref & result);
+
+    /**
+       \brief Record that t rewrites to r.
+       find(t, _) must have been the last call on this cache.
+    */
+    void insert(expr * t, expr * r);
+
+    /**
+       \brief Append the entries added since the last flush to the file.
+    */
+    void flush();
+
+    unsigned size() const;
+
+    unsigned hits() const { return m_hits; }
+    unsigned misses() const { return m_misses; }
+};
@@ -31,11 +31,14 @@ Notes:
 #include "ast/rewriter/rewriter_def.h"
 #include "ast/rewriter/var_subst.h"
 #include "ast/rewriter/expr_safe_replace.h"
+#include "ast/rewriter/persistent_rewrite_cache.h"
 #include "ast/expr_substitution.h"
 #include "ast/ast_smt2_pp.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
 #include "ast/well_sorted.h"
+#include "util/gparams.h"
+#include "util/z3_version.h"
 
 namespace {
 struct th_rewriter_cfg : public default_rewriter_cfg {
@@ -847,12 +850,61 @@ struct th_rewriter::imp : public rewriter_tpl<th_rewriter_cfg> {
 
     void set_solver(expr_solver* solver) {
         m_cfg.m_seq_rw.set_solver(solver);
+        m_has_solver = solver != nullptr;
     }
+
+    bool m_has_solver { false };
 };
 
 th_rewriter::th_rewriter(ast_manager & m, params_ref const & p):
     m_params(p) {
     m_imp = alloc(imp, m, p);
+    init_persistent_cache();
+}
+
+void th_rewriter::init_persistent_cache() {
+    rewriter_params rp(m_params);
+    char const * file = rp.cache_file();
+    if (!file || !*file) {
+        dealloc(m_persistent_cache);
+        m_persistent_cache = nullptr;
+        return;
+    }
+    // results depend on the rewriter configuration and the version of the rewriter,
+    // but not on the name of the cache file.
+    params_ref p(m_params), g(gparams::get_module("rewriter"));
+    p.set_str("cache_file", "");
+    g.set_str("cache_file", "");
+    std::ostringstream strm;
+    strm << Z3_FULL_VERSION << "\n";
+    p.display(strm);
+    g.display(strm);
+    std::string config = strm.str();
+    unsigned fingerprint = string_hash(config.c_str(), static_cast<unsigned>(config.size()), 0);
+    // the store of the file is shared, open the new cache before closing the old
+    // one so that the file is not loaded again.
+    persistent_rewrite_cache * c = alloc(persistent_rewrite_cache, m(), file, fingerprint);
+    dealloc(m_persistent_cache);
+    m_persistent_cache = c;
+}
+
+bool th_rewriter::use_persistent_cache() const {
+    return
+        m_persistent_cache &&
+        !m().proofs_enabled() &&
+        !m_imp->cfg().m_subst &&
+        !m_imp->m_has_solver;
+}
+
+void th_rewriter::rewrite(expr * t, expr_ref & result) {
+    if (!use_persistent_cache()) {
+        m_imp->operator()(t, result);
+        return;
+    }
+    if (m_persistent_cache->find(t, result))
+        return;
+    m_imp->operator()(t, result);
+    m_persistent_cache->insert(t, result);
 }
 
 ast_manager & th_rewriter::m() const {
@@ -862,6 +914,7 @@ ast_manager & th_rewriter::m() const {
 void th_rewriter::updt_params(params_ref const & p) {
     m_params = p;
     m_imp->cfg().updt_params(p);
+    init_persistent_cache();
 }
 
 void th_rewriter::get_param_descrs(param_descrs & r) {
@@ -873,6 +926,7 @@ void th_rewriter::get_param_descrs(param_descrs & r) {
 }
 
 th_rewriter::~th_rewriter() {
+    dealloc(m_persistent_cache);
     dealloc(m_imp);
 }
 
@@ -898,12 +952,12 @@ void th_rewriter::reset() {
 
 void th_rewriter::operator()(expr_ref & term) {
     expr_ref result(term.get_manager());
-    m_imp->operator()(term, result);
+    rewrite(term, result);
     term = std::move(result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result) {
-    m_imp->operator()(t, result);
+    rewrite(t, result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result, proof_ref & result_pr) {
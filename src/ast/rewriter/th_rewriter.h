@@ -26,10 +26,17 @@ class expr_substitution;
 
 class expr_solver;
 
+class persistent_rewrite_cache;
+
 class th_rewriter {
     struct     imp;
     imp *      m_imp;
     params_ref m_params;
+    persistent_rewrite_cache * m_persistent_cache { nullptr };
+
+    void init_persistent_cache();
+    bool use_persistent_cache() const;
+    void rewrite(expr * t, expr_ref & result);
 public:
     th_rewriter(ast_manager & m, params_ref const & p = params_ref());
     ~th_rewriter();
@@ -128,6 +128,16 @@ public:
 
     void solve();
 
+    bool need_to_presolve_with_doubles_in_tableau() const;
+
+    void init_d_solver_from_tableau();
+
+    void snap_non_basic_columns_to_signature(const lar_solution_signature & signature);
+
+    bool pivot_to_basis(const vector<int> & basis_heading);
+
+    void solve_with_doubles_and_repair();
+
     bool lower_bounds_are_set() const { return true; }
 
     const indexed_vector<mpq> & get_pivot_row() const {
@@ -273,7 +283,7 @@ public:
             case column_type::boxed:
                 if (x > m_r_solver.m_upper_bounds[j]) {
                     delta = m_r_solver.m_upper_bounds[j] - x;
-                    x += m_r_solver.m_upper_bounds[j];
+                    x = m_r_solver.m_upper_bounds[j];
                 } else {
                     delta = m_r_solver.m_lower_bounds[j] - x;
                     x = m_r_solver.m_lower_bounds[j];
@@ -11,6 +11,7 @@ Revision History:
 --*/
 #include <string>
 #include "util/vector.h"
+#include "util/util.h"
 #include "math/lp/lar_core_solver.h"
 #include "math/lp/lar_solution_signature.h"
 namespace lp {
@@ -93,6 +94,142 @@ void lar_core_solver::prefix_d() {
     m_d_solver.resize_inf_set(m_d_solver.m_n());
 }
 
+// The solver in doubles is used on the tableau when the rational solver
+// only searches for a feasible solution.
+bool lar_core_solver::need_to_presolve_with_doubles_in_tableau() const {
+    return settings().simplex_doubles() &&
+        settings().simplex_strategy() == simplex_strategy_enum::tableau_rows &&
+        m_r_solver.m_look_for_feasible_solution_only &&
+        !is_tiny();
+}
+
+// The double copy of the tableau is rebuilt for every call, it is not kept
+// in sync with the rational tableau between calls.
+void lar_core_solver::init_d_solver_from_tableau() {
+    m_d_A.clear();
+    m_d_A.init_empty_matrix(m_m(), m_n());
+    create_double_matrix(m_d_A);
+    m_d_basis = m_r_basis;
+    m_d_nbasis = m_r_nbasis;
+    m_d_heading = m_r_heading;
+    m_d_x.resize(m_n());
+    for (unsigned j = 0; j < m_n(); j++)
+        m_d_x[j] = m_r_x[j].x.get_double();
+    get_bounds_for_double_solver();
+    prefix_d();
+    delete m_d_solver.m_factorization;
+    m_d_solver.m_factorization = nullptr;
+    m_d_solver.init_lu();
+}
+
+// Moves the non-basic columns to the bounds recorded in the signature and
+// every other infeasible non-basic column to its closest bound.
+void lar_core_solver::snap_non_basic_columns_to_signature(const lar_solution_signature & signature) {
+    for (unsigned j : m_r_nbasis) {
+        auto it = signature.find(j);
+        non_basic_column_value_position pos_type;
+        if (it != signature.end())
+            pos_type = it->second;
+        else if (m_r_solver.column_is_feasible(j))
+            continue;
+        else if (lower_bound_is_set(j) && m_r_x[j] < m_r_solver.m_lower_bounds[j])
+            pos_type = at_lower_bound;
+        else
+            pos_type = at_upper_bound;
+        numeric_pair<mpq> delta;
+        if (!update_xj_and_get_delta(j, pos_type, delta))
+            continue;
+        m_r_solver.track_column_feasibility(j);
+        for (const auto & cc : m_r_solver.m_A.m_columns[j]) {
+            unsigned i = cc.var();
+            unsigned jb = m_r_solver.m_basis[i];
+            m_r_solver.add_delta_to_x_and_track_feasibility(jb, - delta * m_r_solver.m_A.get_val(cc));
+        }
+    }
+    CASSERT("A_off", m_r_solver.A_mult_x_is_off() == false);
+    lp_assert(m_r_solver.inf_set_is_correct());
+}
+
+/**
+   Pivots the rational tableau to the basis of basis_heading. Each entering
+   column is pivoted into a row whose basic column has to leave. Such a row
+   exists as long as the target basis is not singular in rationals, so only
+   the net changes of basis are pivoted, whatever path led to the target.
+*/
+bool lar_core_solver::pivot_to_basis(const vector<int> & basis_heading) {
+    lp_assert(r_basis_is_OK());
+    vector<unsigned> entering;
+    for (unsigned j = 0; j < basis_heading.size(); j++)
+        if (basis_heading[j] >= 0 && m_r_heading[j] < 0)
+            entering.push_back(j);
+    for (unsigned j : entering) {
+        // among the rows of leaving columns prefer the shortest one, it causes the least fill-in
+        int leaving = -1;
+        unsigned best_size = UINT_MAX;
+        for (const auto & c : m_r_solver.m_A.m_columns[j]) {
+            unsigned bj = m_r_basis[c.var()];
+            unsigned sz = m_r_solver.m_A.m_rows[c.var()].size();
+            if (basis_heading[bj] < 0 && sz < best_size) {
+                leaving = bj;
+                best_size = sz;
+            }
+        }
+        if (leaving < 0)
+            return false;
+        m_r_solver.change_basis_unconditionally(j, leaving);
+        if (!m_r_solver.pivot_column_tableau(j, m_r_heading[j])) {
+            m_r_solver.change_basis_unconditionally(leaving, j);
+            return false;
+        }
+    }
+    lp_assert(r_basis_is_OK());
+    return true;
+}
+
+/**
+   Runs the primal simplex in doubles on a copy of the tableau, then pivots
+   the rational tableau to the final basis of the double solver and moves the
+   non-basic columns to the bounds it found. The rational solver is started
+   from this basis, so its answer is exact: rounding errors of the double
+   solver only cost additional rational pivots.
+*/
+void lar_core_solver::solve_with_doubles_and_repair() {
+    auto & st = settings().stats();
+    st.m_double_presolve++;
+    lar_solution_signature signature;
+    vector<unsigned> changes_of_basis;
+    {
+        // the solver in doubles pivots with the LU factorization of the basis
+        flet<simplex_strategy_enum> _lu(settings().simplex_strategy(), simplex_strategy_enum::lu);
+        init_d_solver_from_tableau();
+        if (m_d_solver.m_factorization->get_status() == LU_status::OK) {
+            extract_signature_from_lp_core_solver(m_r_solver, signature);
+            prepare_solver_x_with_signature(signature, m_d_solver);
+            m_d_solver.solve_Ax_eq_b();
+            m_d_solver.start_tracing_basis_changes();
+            m_d_solver.find_feasible_solution();
+            m_d_solver.stop_tracing_basis_changes();
+            changes_of_basis = m_d_solver.m_trace_of_basis_change_vector;
+            extract_signature_from_lp_core_solver(m_d_solver, signature);
+        }
+        delete m_d_solver.m_factorization;
+        m_d_solver.m_factorization = nullptr;
+    }
+    m_d_A.clear();
+    if (settings().get_cancel_flag()) {
+        m_r_solver.set_status(lp_status::TIME_EXHAUSTED);
+        return;
+    }
+    TRACE("lar_solver", tout << "double solver: " << lp_status_to_string(m_d_solver.get_status())
+          << ", basis changes: " << changes_of_basis.size() / 2 << "\n";);
+    st.m_double_presolve_pivots += changes_of_basis.size() / 2;
+    if (!pivot_to_basis(m_d_heading))
+        st.m_double_presolve_fallbacks++;  // the basis of the double solver is singular in rationals
+    // a partial change of basis can leave infeasible columns outside of the basis
+    snap_non_basic_columns_to_signature(signature);
+    m_r_solver.find_feasible_solution();
+}
+
 void lar_core_solver::fill_not_improvable_zero_sum_from_inf_row() {
     CASSERT("A_off", m_r_solver.A_mult_x_is_off() == false);
     unsigned bj = m_r_basis[m_r_solver.m_inf_row_index_for_tableau];
@@ -164,6 +301,10 @@ void lar_core_solver::solve() {
             solve_on_signature(solution_signature, changes_of_basis);
 
         lp_assert(!settings().use_tableau() || r_basis_is_OK());
+    } else if (need_to_presolve_with_doubles_in_tableau()) {
+        TRACE("lar_solver", tout << "presolving with doubles\n";);
+        solve_with_doubles_and_repair();
+        lp_assert(r_basis_is_OK());
     } else {
         if (!settings().use_tableau()) {
             TRACE("lar_solver", tout << "no tablau\n";);
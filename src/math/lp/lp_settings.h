@@ -126,6 +126,9 @@ struct statistics {
     unsigned m_grobner_calls;
     unsigned m_grobner_conflicts;
     unsigned m_cheap_eqs;
+    unsigned m_double_presolve;
+    unsigned m_double_presolve_pivots;
+    unsigned m_double_presolve_fallbacks;
     statistics() { reset(); }
     void reset() { memset(this, 0, sizeof(*this)); }
     void collect_statistics(::statistics& st) const {
@@ -146,6 +149,9 @@ struct statistics {
         st.update("arith-grobner-calls", m_grobner_calls);
         st.update("arith-grobner-conflicts", m_grobner_conflicts);
         st.update("arith-cheap-eqs", m_cheap_eqs);
+        st.update("arith-double-presolve", m_double_presolve);
+        st.update("arith-double-presolve-pivots", m_double_presolve_pivots);
+        st.update("arith-double-presolve-fallbacks", m_double_presolve_fallbacks);
 
     }
 };
@@ -241,9 +247,12 @@ private:
     bool             m_enable_hnf { true };
     bool             m_print_external_var_name { false };
     bool             m_cheap_eqs { false };
+    bool             m_simplex_doubles { false };
 public:
     bool print_external_var_name() const { return m_print_external_var_name; }
     bool cheap_eqs() const { return m_cheap_eqs;}
+    bool simplex_doubles() const { return m_simplex_doubles; }
+    void set_simplex_doubles(bool v) { m_simplex_doubles = v; }
     unsigned hnf_cut_period() const { return m_hnf_cut_period; }
     void set_hnf_cut_period(unsigned period) { m_hnf_cut_period = period;  }
     unsigned random_next() { return m_rand(); }
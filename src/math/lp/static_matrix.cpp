@@ -30,6 +30,7 @@ Revision History:
 #include "math/lp/lar_solver.h"
 namespace lp {
 template void static_matrix<double, double>::add_columns_at_the_end(unsigned int);
+template void static_matrix<double, double>::add_new_element(unsigned int, unsigned int, double const&);
 template void static_matrix<double, double>::clear();
 #ifdef Z3DEBUG
 template bool static_matrix<double, double>::is_correct() const;
@@ -22,6 +22,7 @@ Revision History:
 #include "ast/ast_util.h"
 #include "model/func_interp.h"
 #include "ast/array_decl_plugin.h"
+#include "ast/arith_decl_plugin.h"
 
 func_entry::func_entry(ast_manager & m, unsigned arity, expr * const * args, expr * result):
     m_args_are_values(true),
@@ -76,7 +77,8 @@ func_interp::func_interp(ast_manager & m, unsigned arity):
     m_else(nullptr),
     m_args_are_values(true),
     m_interp(nullptr),
-    m_array_interp(nullptr) {
+    m_array_interp(nullptr),
+    m_index_disabled(false) {
 }
 
 func_interp::~func_interp() {
@@ -170,12 +172,78 @@ bool func_interp::is_constant() const {
     return true;
 }
 
+/**
+   \brief Return true if are_equal(e, e') implies e == e'.
+   Irrational algebraic numbers may have several representations.
+*/
+bool func_interp::is_hashable(expr * e) {
+    return !is_app(e) || !to_app(e)->is_app_of(arith_family_id, OP_IRRATIONAL_ALGEBRAIC_NUM);
+}
+
+unsigned func_interp::hash_args(expr * const * args) const {
+    unsigned h = m_arity;
+    for (unsigned i = 0; i < m_arity; i++)
+        h = combine_hash(h, args[i]->get_id());
+    return h;
+}
+
+bool func_interp::insert_index(unsigned idx) const {
+    func_entry * curr = m_entries[idx];
+    for (unsigned i = 0; i < m_arity; i++)
+        if (!is_hashable(curr->get_arg(i)))
+            return false;
+    unsigned b = hash_args(curr->get_args()) & (m_index.size() - 1);
+    m_index_next[idx] = m_index[b];
+    m_index[b] = idx + 1;
+    return true;
+}
+
+void func_interp::build_index() const {
+    unsigned sz = 16;
+    while (sz < 2 * m_entries.size())
+        sz *= 2;
+    m_index.reset();
+    m_index.resize(sz, 0);
+    m_index_next.reset();
+    m_index_next.resize(m_entries.size(), 0);
+    for (unsigned i = 0; i < m_entries.size(); i++) {
+        if (!insert_index(i)) {
+            m_index.reset();
+            m_index_next.reset();
+            m_index_disabled = true;
+            return;
+        }
+    }
+}
+
+void func_interp::reset_index() {
+    m_index.reset();
+    m_index_next.reset();
+    m_index_disabled = false;
+}
+
 /**
    \brief Return a func_entry e such that m().are_equal(e.m_args[i], args[i]) for all i in [0, m_arity).
    If such entry does not exist then return 0, and store set
    args_are_values to true if for all entries e e.args_are_values() is true.
 */
 func_entry * func_interp::get_entry(expr * const * args) const {
+    if (m_index.empty() && !m_index_disabled && m_entries.size() >= index_threshold)
+        build_index();
+    if (!m_index.empty()) {
+        bool hashable = true;
+        for (unsigned i = 0; hashable && i < m_arity; i++)
+            hashable = is_hashable(args[i]);
+        if (hashable) {
+            unsigned b = hash_args(args) & (m_index.size() - 1);
+            for (unsigned i = m_index[b]; i != 0; i = m_index_next[i - 1]) {
+                func_entry * curr = m_entries[i - 1];
+                if (curr->eq_args(m(), m_arity, args))
+                    return curr;
+            }
+            return nullptr;
+        }
+    }
     for (func_entry* curr : m_entries) {
         if (curr->eq_args(m(), m_arity, args))
             return curr;
@@ -213,6 +281,18 @@ void func_interp::insert_new_entry(expr * const * args, expr * r) {
     if (!new_entry->args_are_values())
         m_args_are_values = false;
     m_entries.push_back(new_entry);
+    if (m_index.empty())
+        return;
+    if (m_entries.size() > m_index.size()) {
+        build_index();
+        return;
+    }
+    m_index_next.push_back(0);
+    if (!insert_index(m_entries.size() - 1)) {
+        m_index.reset();
+        m_index_next.reset();
+        m_index_disabled = true;
+    }
 }
 
 void func_interp::del_entry(unsigned idx) {
@@ -220,6 +300,7 @@ void func_interp::del_entry(unsigned idx) {
     m_entries[idx] = m_entries.back();
     m_entries.pop_back();
     e->deallocate(m(), m_arity);
+    reset_index();
 }
 
 bool func_interp::eval_else(expr * const * args, expr_ref & result) const {
@@ -276,6 +357,7 @@ void func_interp::compress() {
     }
     if (j < m_entries.size()) {
         reset_interp_cache();
+        reset_index();
         m_entries.shrink(j);
     }
     // other compression, if else is a default branch.
@@ -286,6 +368,7 @@ void func_interp::compress() {
             curr->deallocate(m(), m_arity);
         }
         m_entries.reset();
+        reset_index();
         reset_interp_cache();
         m().inc_ref(new_else);
         m().dec_ref(m_else);
@@ -296,6 +379,7 @@ void func_interp::compress() {
             curr->deallocate(m(), m_arity);
         }
         m_entries.reset();
+        reset_index();
         reset_interp_cache();
         expr_ref new_else(m().mk_var(0, m_else->get_sort()), m());
         m().inc_ref(new_else);
@@ -74,8 +74,21 @@ class func_interp {
 
     expr *                 m_array_interp; // <! interp with lambda abstraction
 
+    // Hash index over the arguments of m_entries. It is built by get_entry
+    // once the number of entries reaches index_threshold.
+    static const unsigned  index_threshold = 16;
+    mutable unsigned_vector m_index;       // bucket -> 1 + position of first entry in m_entries, 0 if empty
+    mutable unsigned_vector m_index_next;  // 1 + position of next entry in the same bucket, 0 if last
+    mutable bool           m_index_disabled; // there are entries with arguments that cannot be hashed
+
     void reset_interp_cache();
 
+    static bool is_hashable(expr * e);
+    unsigned hash_args(expr * const * args) const;
+    bool insert_index(unsigned idx) const;
+    void build_index() const;
+    void reset_index();
+
     expr * get_interp_core() const;
 
     expr_ref get_array_interp_core(func_decl * f) const;
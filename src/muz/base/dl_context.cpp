@@ -291,6 +291,8 @@ namespace datalog {
     bool context::similarity_compressor() const { return m_params->datalog_similarity_compressor(); }
     unsigned context::similarity_compressor_threshold() const { return m_params->datalog_similarity_compressor_threshold(); }
     unsigned context::initial_restart_timeout() const { return m_params->datalog_initial_restart_timeout(); }
+    unsigned context::threads() const { return m_params->datalog_threads(); }
+    bool context::leapfrog_join() const { return m_params->datalog_leapfrog_join(); }
     bool context::generate_explanations() const { return m_params->datalog_generate_explanations(); }
     bool context::explanations_on_relation_level() const { return m_params->datalog_explanations_on_relation_level(); }
     bool context::magic_sets_for_queries() const { return m_params->datalog_magic_sets_for_queries();  }
@@ -261,6 +261,8 @@ namespace datalog {
         unsigned similarity_compressor_threshold() const;
         unsigned soft_timeout() const;
         unsigned initial_restart_timeout() const;
+        unsigned threads() const;
+        bool leapfrog_join() const;
         bool generate_explanations() const;
         bool explanations_on_relation_level() const;
         bool magic_sets_for_queries() const;
@@ -74,6 +74,42 @@ namespace datalog {
             vars.get_cols2(), removed_cols.size(), removed_cols.data(), result));
     }
 
+    void compiler::make_join_multi(rule * r, const reg_idx * tail_regs, reg_idx & result, instruction_block & acc) {
+        unsigned pt_len = r->get_positive_tail_size();
+        // bind the variables shared by most tails first, they prune the search most.
+        counter occs;
+        unsigned_vector order;
+        for (unsigned i = 0; i < pt_len; i++) {
+            app * t = r->get_tail(i);
+            for (expr * arg : *t) {
+                unsigned v = to_var(arg)->get_idx();
+                if (occs.get(v) == 0)
+                    order.push_back(v);
+                occs.update(v, 1);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(), [&](unsigned v, unsigned w) { return occs.get(v) > occs.get(w); });
+        unsigned_vector var2idx;
+        for (unsigned i = 0; i < order.size(); i++) {
+            var2idx.reserve(order[i] + 1, UINT_MAX);
+            var2idx[order[i]] = i;
+        }
+
+        vector<unsigned_vector> vars;
+        relation_signature res_sig;
+        for (unsigned i = 0; i < pt_len; i++) {
+            app * t = r->get_tail(i);
+            SASSERT(m_reg_signatures[tail_regs[i]].size() == t->get_num_args());
+            vars.push_back(unsigned_vector());
+            for (expr * arg : *t) 
+                vars.back().push_back(var2idx[to_var(arg)->get_idx()]);
+            relation_signature sig(res_sig);
+            relation_signature::from_join(sig, m_reg_signatures[tail_regs[i]], 0, nullptr, nullptr, res_sig);
+        }
+        result = get_fresh_register(res_sig);
+        acc.push_back(instruction::mk_join_multi(pt_len, tail_regs, vars, order.size(), result));
+    }
+
     void compiler::make_filter_interpreted_and_project(reg_idx src, app_ref & cond,
             const unsigned_vector & removed_cols, reg_idx & result, bool reuse, instruction_block & acc) {
         SASSERT(!removed_cols.empty());
@@ -459,7 +495,9 @@ namespace datalog {
         TRACE("dl", r->display(m_context, tout); );
 
         unsigned pt_len = r->get_positive_tail_size();
-        SASSERT(pt_len<=2); //we require rules to be processed by the mk_simple_joins rule transformer plugin
+        //we require rules to be processed by the mk_simple_joins rule transformer plugin,
+        //which only keeps longer tails for multiway joins
+        SASSERT(pt_len<=2 || m_context.leapfrog_join());
 
         reg_idx single_res;
         expr_ref_vector single_res_expr(m);
@@ -471,7 +509,12 @@ namespace datalog {
         // whether to dealloc the previous result
         bool dealloc = true;
 
-        if(pt_len == 2) {
+        if (pt_len > 2) {
+            make_join_multi(r, tail_regs, single_res, acc);
+            for (unsigned i = 0; i < pt_len; i++) 
+                single_res_expr.append(r->get_tail(i)->get_num_args(), r->get_tail(i)->get_args());
+        }
+        else if(pt_len == 2) {
             reg_idx t1_reg=tail_regs[0];
             reg_idx t2_reg=tail_regs[1];
             app * a1 = r->get_tail(0);
@@ -586,6 +629,11 @@ namespace datalog {
                 continue;
             }
             SASSERT(indexes.size()>1);
+            if(pt_len > 2) {
+                //variables are distinct within the tails of a multiway join, 
+                //so the join enforces the equalities
+                continue;
+            }
             if(pt_len==2 && indexes[0]<second_tail_arg_ofs && indexes.back()>=second_tail_arg_ofs) {
                 //If variable appears in multiple tails, the identicity will already be enforced by join.
                 //(If behavior the join changes so that it is not enforced anymore, remove this
@@ -148,6 +148,11 @@ namespace datalog {
             bool reuse_t1, instruction_block & acc);
         void make_min(reg_idx source, reg_idx & target, const unsigned_vector & group_by_cols,
             unsigned min_col, instruction_block & acc);
+        /**
+           \brief Join the positive tails of \c r, which has more than two of them and only distinct
+           variables as arguments of each tail. The result contains the columns of all tails in order.
+        */
+        void make_join_multi(rule * r, const reg_idx * tail_regs, reg_idx & result, instruction_block & acc);
         void make_join_project(reg_idx t1, reg_idx t2, const variable_intersection & vars, 
             const unsigned_vector & removed_cols, reg_idx & result, bool reuse_t1, instruction_block & acc);
         void make_filter_interpreted_and_project(reg_idx src, app_ref & cond,
@@ -23,6 +23,8 @@ Revision History:
 #include "muz/base/dl_util.h"
 #include "muz/rel/dl_instruction.h"
 #include "muz/rel/rel_context.h"
+#include "muz/rel/dl_sparse_table.h"
+#include "muz/rel/dl_table_relation.h"
 #include "util/debug.h"
 #include "util/warning.h"
 
@@ -420,6 +422,128 @@ namespace datalog {
         return alloc(instr_join, rel1, rel2, col_cnt, cols1, cols2, result);
     }
 
+    class instr_join_multi : public instruction {
+        svector<reg_idx>        m_rels;
+        vector<unsigned_vector> m_vars;
+        unsigned                m_num_vars;
+        reg_idx                 m_res;
+
+        /**
+           \brief Join the tables in one step if all relations are sparse tables.
+        */
+        relation_base * leapfrog_join(ptr_vector<relation_base const> const & rels) {
+            ptr_vector<sparse_table const> tables;
+            for (relation_base const * r : rels) {
+                if (!r->from_table())
+                    return nullptr;
+                sparse_table const * t = dynamic_cast<sparse_table const *>(&static_cast<table_relation const *>(r)->get_table());
+                if (!t || !t->can_leapfrog_join())
+                    return nullptr;
+                tables.push_back(t);
+            }
+            relation_signature rsig(rels[0]->get_signature());
+            table_signature tsig(tables[0]->get_signature());
+            for (unsigned i = 1; i < rels.size(); ++i) {
+                relation_signature rsig1(rsig);
+                table_signature tsig1(tsig);
+                relation_signature::from_join(rsig1, rels[i]->get_signature(), 0, nullptr, nullptr, rsig);
+                table_signature::from_join(tsig1, tables[i]->get_signature(), 0, nullptr, nullptr, tsig);
+            }
+            table_plugin & tp = tables[0]->get_plugin();
+            table_base * res = tp.mk_empty(tsig);
+            sparse_table * st = dynamic_cast<sparse_table *>(res);
+            if (!st) {
+                res->deallocate();
+                return nullptr;
+            }
+            sparse_table::leapfrog_join(tables.size(), tables.data(), m_vars, m_num_vars, *st);
+            return rels[0]->get_manager().get_table_relation_plugin(tp).mk_from_table(rsig, res);
+        }
+
+        /**
+           \brief Join the relations pairwise from left to right.
+        */
+        relation_base * binary_joins(ptr_vector<relation_base const> const & rels) {
+            relation_manager & rmgr = rels[0]->get_manager();
+            scoped_rel<relation_base> acc = rels[0]->clone();
+            unsigned_vector acc_vars(m_vars[0]);
+            for (unsigned i = 1; i < rels.size(); ++i) {
+                unsigned_vector cols1, cols2;
+                for (unsigned j = 0; j < m_vars[i].size(); ++j) {
+                    // joining with the first occurrence suffices, the others are equal to it.
+                    for (unsigned k = 0; k < acc_vars.size(); ++k) {
+                        if (acc_vars[k] == m_vars[i][j]) {
+                            cols1.push_back(k);
+                            cols2.push_back(j);
+                            break;
+                        }
+                    }
+                }
+                scoped_ptr<relation_join_fn> fn = rmgr.mk_join_fn(*acc, *rels[i], cols1, cols2);
+                if (!fn) {
+                    throw default_exception(default_exception::fmt(), 
+                                            "trying to perform unsupported join operation on relations of kinds %s and %s",
+                                            acc->get_plugin().get_name().bare_str(), rels[i]->get_plugin().get_name().bare_str());
+                }
+                acc = (*fn)(*acc, *rels[i]);
+                acc_vars.append(m_vars[i]);
+            }
+            return acc.release();
+        }
+
+    public:
+        instr_join_multi(unsigned n, const reg_idx * rels, const vector<unsigned_vector> & vars, 
+            unsigned num_vars, reg_idx result)
+            : m_rels(n, rels), m_vars(vars), m_num_vars(num_vars), m_res(result) {}
+        bool perform(execution_context & ctx) override {
+            log_verbose(ctx);
+            ++ctx.m_stats.m_join;
+            ptr_vector<relation_base const> rels;
+            for (reg_idx r : m_rels) {
+                if (!ctx.reg(r) || ctx.reg(r)->fast_empty()) {
+                    ctx.make_empty(m_res);
+                    return true;
+                }
+                rels.push_back(ctx.reg(r));
+            }
+            relation_base * res = leapfrog_join(rels);
+            if (!res)
+                res = binary_joins(rels);
+            ctx.set_reg(m_res, res);
+
+            TRACE("dl", 
+                ctx.reg(m_res)->get_signature().output(ctx.get_rel_context().get_manager(), tout);
+                tout<<":"<<ctx.reg(m_res)->get_size_estimate_rows()<<"\n";);
+
+            if (ctx.reg(m_res)->fast_empty()) {
+                ctx.make_empty(m_res);
+            }
+            return true;
+        }
+        void make_annotations(execution_context & ctx) override {
+            std::string a = "join";
+            for (reg_idx r : m_rels) {
+                std::string ar = "rel";
+                ctx.get_register_annotation(r, ar);
+                a += " " + ar;
+            }
+            ctx.set_register_annotation(m_res, a);
+        }
+        std::ostream& display_head_impl(execution_context const & ctx, std::ostream & out) const override {
+            out << "join";
+            for (unsigned i = 0; i < m_rels.size(); ++i) {
+                out << (i == 0 ? " " : " and ") << m_rels[i];
+                print_container(m_vars[i], out);
+            }
+            return out << " into " << m_res;
+        }
+    };
+
+    instruction * instruction::mk_join_multi(unsigned n, const reg_idx * rels, const vector<unsigned_vector> & vars,
+            unsigned num_vars, reg_idx result) {
+        return alloc(instr_join_multi, n, rels, vars, num_vars, result);
+    }
+
     class instr_filter_equal : public instruction {
         reg_idx m_reg;
         app_ref m_value;
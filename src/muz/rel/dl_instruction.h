@@ -271,6 +271,16 @@ namespace datalog {
 
         static instruction * mk_join(reg_idx rel1, reg_idx rel2, unsigned col_cnt,
             const unsigned * cols1, const unsigned * cols2, reg_idx result);
+        /**
+           \brief Join the relations \c rels on shared variables. Column \c j of relation \c i
+           holds variable \c vars[i][j], and the variables of a relation are distinct.
+           The result contains the columns of all relations in order.
+
+           Sparse tables are joined in one step by leapfrog triejoin, other relations by
+           a sequence of binary joins.
+        */
+        static instruction * mk_join_multi(unsigned n, const reg_idx * rels, const vector<unsigned_vector> & vars,
+            unsigned num_vars, reg_idx result);
         static instruction * mk_filter_equal(ast_manager & m, reg_idx reg, const relation_element & value, unsigned col);
         static instruction * mk_filter_identical(reg_idx reg, unsigned col_cnt, const unsigned * identical_cols);
         static instruction * mk_filter_interpreted(reg_idx reg, app_ref & condition);
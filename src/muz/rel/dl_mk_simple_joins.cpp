@@ -129,6 +129,7 @@ namespace datalog {
         ptr_vector<app>   m_interpreted;
         rule_pred_map     m_rules_content;
         rule_ref_vector   m_introduced_rules;
+        ptr_vector<rule>  m_multiway_rules;
         bool              m_modified_rules;
         
         ast_ref_vector m_pinned;
@@ -290,6 +291,72 @@ namespace datalog {
             }
         }
 
+        /**
+           \brief Return true if the positive tails of r should be joined in one step:
+           there are more than two of them, they are distinct, the arguments
+           of each tail are distinct variables, and the tails are cyclic.
+           Acyclic bodies, such as chains, have binary plans whose intermediate
+           results are bounded by the output, and the binary plan is kept for them.
+        */
+        bool is_multiway_join(rule * r) const {
+            unsigned pos_tail_size = r->get_positive_tail_size();
+            if (pos_tail_size <= 2)
+                return false;
+            vector<uint_set> edges;
+            for (unsigned i = 0; i < pos_tail_size; i++) {
+                app * t = r->get_tail(i);
+                for (unsigned j = 0; j < i; j++)
+                    if (r->get_tail(j) == t)
+                        return false;
+                uint_set vars;
+                for (expr * arg : *t) {
+                    if (!is_var(arg) || vars.contains(to_var(arg)->get_idx()))
+                        return false;
+                    vars.insert(to_var(arg)->get_idx());
+                }
+                edges.push_back(vars);
+            }
+            return !is_acyclic(edges);
+        }
+
+        /**
+           \brief GYO reduction of the hypergraph whose edges are the variables
+           of the tails: remove variables that occur in a single edge and edges
+           that are contained in another edge. The hypergraph is acyclic if
+           at most one edge remains.
+        */
+        static bool is_acyclic(vector<uint_set> edges) {
+            bool change = true;
+            while (change && edges.size() > 1) {
+                change = false;
+                for (unsigned i = 0; i < edges.size(); i++) {
+                    uint_set unique;
+                    for (unsigned v : edges[i]) {
+                        bool shared = false;
+                        for (unsigned j = 0; !shared && j < edges.size(); j++)
+                            shared = j != i && edges[j].contains(v);
+                        if (!shared)
+                            unique.insert(v);
+                    }
+                    for (unsigned v : unique)
+                        edges[i].remove(v);
+                    change |= !unique.empty();
+                }
+                for (unsigned i = 0; i < edges.size(); i++) {
+                    bool contained = false;
+                    for (unsigned j = 0; !contained && j < edges.size(); j++)
+                        contained = j != i && edges[i].subset_of(edges[j]);
+                    if (contained) {
+                        edges[i] = edges.back();
+                        edges.pop_back();
+                        change = true;
+                        break;
+                    }
+                }
+            }
+            return edges.size() <= 1;
+        }
+
         void register_rule(rule * r) {
             rule_counter counter;
             counter.count_rule_vars(r, 1);
@@ -696,7 +763,10 @@ namespace datalog {
         rule_set * run(rule_set const & source) {
 
             for (rule * r : source) {
-                register_rule(r);
+                if (m_context.leapfrog_join() && is_multiway_join(r))
+                    m_multiway_rules.push_back(r);
+                else
+                    register_rule(r);
             }
 
             app_pair selected;
@@ -733,6 +803,9 @@ namespace datalog {
                 rm.mk_rule_rewrite_proof(*orig_r, *new_rule);
                 result->add_rule(new_rule);
             }
+            for (rule* r : m_multiway_rules) {
+                result->add_rule(r);
+            }
             for (rule* r : m_introduced_rules) {
                 result->add_rule(r);
                 rm.mk_rule_asserted_proof(*r);
@@ -46,6 +46,10 @@ namespace datalog {
        Where the C_i's are interpreted expressions.
 
        We say that a rule containing C_i's is a rule with a "big tail".
+
+       When datalog.leapfrog_join is set, rules whose positive tails have only distinct
+       variables as arguments and share variables in a cycle are kept intact, since the
+       compiler joins their tails in one step.
     */
     class mk_simple_joins : public rule_transformer::plugin {
         context &           m_context;
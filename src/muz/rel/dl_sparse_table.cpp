@@ -18,8 +18,16 @@ Revision History:
 --*/
 
 #include<utility>
+#include<algorithm>
+#include<functional>
+#ifndef SINGLE_THREAD
+#include<atomic>
+#include<mutex>
+#include<thread>
+#endif
 #include "muz/base/dl_context.h"
 #include "muz/base/dl_util.h"
+#include "muz/rel/dl_relation_manager.h"
 #include "muz/rel/dl_sparse_table.h"
 
 namespace datalog {
@@ -426,6 +434,154 @@ namespace datalog {
         }
     };
 
+    class sparse_table::trie_index {
+        unsigned_vector        m_cols;
+        svector<table_element> m_rows;      // rows projected to m_cols, in lexicographic order
+        store_offset           m_indexed_until;
+    public:
+        trie_index(unsigned col_cnt, const unsigned * cols)
+            : m_cols(col_cnt, cols), m_indexed_until(0) {}
+
+        /**
+           \brief Index the rows added to t since the last update. Removing rows
+           resets the indexes of a table, so the rows that are already indexed
+           are unchanged: the new rows are sorted and merged into them.
+        */
+        void update(const sparse_table & t) {
+            store_offset after_last = t.m_data.after_last_offset();
+            if (m_indexed_until == after_last) 
+                return;
+            SASSERT(m_indexed_until < after_last);
+            unsigned k = m_cols.size();
+            svector<store_offset> offsets;
+            for (store_offset ofs = m_indexed_until; ofs != after_last; ofs += t.m_fact_size)
+                offsets.push_back(ofs);
+            std::sort(offsets.begin(), offsets.end(), [&](store_offset a, store_offset b) {
+                for (unsigned c : m_cols) {
+                    table_element va = t.get_cell(a, c), vb = t.get_cell(b, c);
+                    if (va != vb)
+                        return va < vb;
+                }
+                return false;
+            });
+            svector<table_element> added;
+            for (store_offset ofs : offsets)
+                for (unsigned c : m_cols)
+                    added.push_back(t.get_cell(ofs, c));
+            m_indexed_until = after_last;
+            if (m_rows.empty()) {
+                m_rows.swap(added);
+                return;
+            }
+            auto less = [&](table_element const * a, table_element const * b) {
+                for (unsigned l = 0; l < k; ++l)
+                    if (a[l] != b[l])
+                        return a[l] < b[l];
+                return false;
+            };
+            svector<table_element> merged;
+            unsigned i = 0, j = 0;
+            while (i < m_rows.size() || j < added.size()) {
+                table_element const * src;
+                if (j == added.size() || (i < m_rows.size() && !less(added.data() + j, m_rows.data() + i))) {
+                    src = m_rows.data() + i;
+                    i += k;
+                }
+                else {
+                    src = added.data() + j;
+                    j += k;
+                }
+                for (unsigned l = 0; l < k; ++l)
+                    merged.push_back(src[l]);
+            }
+            m_rows.swap(merged);
+        }
+
+        unsigned size() const { return m_cols.empty() ? 0 : m_rows.size() / m_cols.size(); }
+        table_element get(unsigned row, unsigned level) const { return m_rows[row * m_cols.size() + level]; }
+    };
+
+    /**
+       \brief Iterator over the levels of a trie_index.
+
+       The rows below the current node form a range of the sorted rows, and
+       the keys of a level are sorted within the range of the parent node.
+    */
+    class trie_iterator {
+        struct level {
+            unsigned m_pos;
+            unsigned m_end;
+        };
+        sparse_table::trie_index const * m_index { nullptr };
+        svector<level> m_levels;
+
+        unsigned depth() const { return m_levels.size() - 1; }
+
+        // first position in [lo, hi) whose key at the current level is at least v (or above v if strict).
+        unsigned search(unsigned lo, unsigned hi, table_element v, bool strict) const;
+
+    public:
+        void init(sparse_table::trie_index const & index) { m_index = &index; m_levels.reset(); }
+
+        /**
+           \brief Descend to the children of the current node, or to the first level.
+        */
+        void open() {
+            if (m_levels.empty()) {
+                m_levels.push_back({ 0, m_index->size() });
+                return;
+            }
+            unsigned pos = m_levels.back().m_pos;
+            unsigned end = search(pos, m_levels.back().m_end, key(), true);
+            m_levels.push_back({ pos, end });
+        }
+
+        void up() { m_levels.pop_back(); }
+
+        bool at_end() const { return m_levels.back().m_pos == m_levels.back().m_end; }
+
+        table_element key() const { return m_index->get(m_levels.back().m_pos, depth()); }
+
+        void next() {
+            level & l = m_levels.back();
+            l.m_pos = search(l.m_pos, l.m_end, key(), true);
+        }
+
+        /**
+           \brief Move to the first key at least v.
+        */
+        void seek(table_element v) {
+            level & l = m_levels.back();
+            l.m_pos = search(l.m_pos, l.m_end, v, false);
+        }
+    };
+
+    unsigned trie_iterator::search(unsigned lo, unsigned hi, table_element v, bool strict) const {
+        unsigned d = depth();
+        auto below = [&](unsigned i) {
+            table_element k = m_index->get(i, d);
+            return strict ? k <= v : k < v;
+        };
+        // gallop from lo, since the next key is usually close.
+        unsigned step = 1;
+        unsigned prev = lo;
+        while (lo < hi && below(lo)) {
+            prev = lo + 1;
+            lo = hi - lo > step ? lo + step : hi;
+            step *= 2;
+        }
+        hi = lo;
+        lo = prev;
+        while (lo < hi) {
+            unsigned mid = lo + (hi - lo) / 2;
+            if (below(mid))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
     sparse_table::sparse_table(sparse_table_plugin & p, const table_signature & sig, unsigned init_capacity)
             : table_base(p, sig), 
             m_column_layout(sig),
@@ -494,6 +650,20 @@ namespace datalog {
             dealloc((*kmit).m_value);
         }
         m_key_indexes.reset();
+        for (auto & kv : m_trie_indexes) 
+            dealloc(kv.m_value);
+        m_trie_indexes.reset();
+    }
+
+    sparse_table::trie_index& sparse_table::get_trie_index(unsigned col_cnt, const unsigned * cols) const {
+        key_spec kspec;
+        kspec.append(col_cnt, cols);
+        trie_index_map::entry * e = m_trie_indexes.insert_if_not_there3(kspec, nullptr);
+        if (!e->get_data().m_value) 
+            e->get_data().m_value = alloc(trie_index, col_cnt, cols);
+        trie_index & index = *e->get_data().m_value;
+        index.update(*this);
+        return index;
     }
 
     void sparse_table::write_into_reserve(const table_element* f) {
@@ -685,6 +855,13 @@ namespace datalog {
             return;
         }
 
+        unsigned num_threads = result.get_plugin().get_manager().get_context().threads();
+        if (num_threads > 1 && t1.row_count() + t2.row_count() >= parallel_join_min_rows) {
+            parallel_join_project(t1, t2, joined_col_cnt, t1_joined_cols, t2_joined_cols, removed_cols,
+                                  tables_swapped, num_threads, result);
+            return;
+        }
+
         key_value t1_key;
         t1_key.resize(joined_col_cnt);
         key_indexer& t2_indexer = t2.get_key_indexer(joined_col_cnt, t2_joined_cols);
@@ -732,6 +909,238 @@ namespace datalog {
     }
 
 
+    void sparse_table::parallel_join_project(const sparse_table & t1, const sparse_table & t2,
+            unsigned joined_col_cnt, const unsigned * t1_joined_cols, const unsigned * t2_joined_cols,
+            const unsigned * removed_cols, bool tables_swapped, unsigned num_threads, sparse_table & result) {
+
+        verbose_action _va("parallel_join_project", 1);
+        unsigned res_size = result.m_fact_size;
+
+        auto key_hash = [&](sparse_table const & t, store_offset ofs, unsigned const * cols) {
+            unsigned h = 17;
+            for (unsigned i = 0; i < joined_col_cnt; ++i)
+                h = combine_hash(h, hash_ull(t.get_cell(ofs, cols[i])));
+            return h;
+        };
+
+        // partition the rows of both tables by their key.
+        vector<svector<store_offset>> rows1(parallel_join_partitions), rows2(parallel_join_partitions);
+        for (store_offset ofs = 0, end = t1.m_data.after_last_offset(); ofs != end; ofs += t1.m_fact_size)
+            rows1[key_hash(t1, ofs, t1_joined_cols) % parallel_join_partitions].push_back(ofs);
+        for (store_offset ofs = 0, end = t2.m_data.after_last_offset(); ofs != end; ofs += t2.m_fact_size)
+            rows2[key_hash(t2, ofs, t2_joined_cols) % parallel_join_partitions].push_back(ofs);
+
+        // join a partition into a buffer of result rows.
+        // Rows of t1 keep their order, and matching rows of t2 are produced in the order of t2.
+        vector<svector<char>> buffers(parallel_join_partitions);
+        auto join_partition = [&](unsigned p) {
+            svector<store_offset> & r1 = rows1[p];
+            svector<store_offset> & r2 = rows2[p];
+            if (r1.empty() || r2.empty())
+                return;
+            auto t2_less = [&](store_offset a, store_offset b) {
+                for (unsigned i = 0; i < joined_col_cnt; ++i) {
+                    table_element va = t2.get_cell(a, t2_joined_cols[i]);
+                    table_element vb = t2.get_cell(b, t2_joined_cols[i]);
+                    if (va != vb)
+                        return va < vb;
+                }
+                return false;
+            };
+            std::stable_sort(r2.begin(), r2.end(), t2_less);
+            // compare a row of t2 with the key of a row of t1.
+            auto cmp = [&](store_offset o2, store_offset o1) {
+                for (unsigned i = 0; i < joined_col_cnt; ++i) {
+                    table_element v2 = t2.get_cell(o2, t2_joined_cols[i]);
+                    table_element v1 = t1.get_cell(o1, t1_joined_cols[i]);
+                    if (v2 != v1)
+                        return v2 < v1 ? -1 : 1;
+                }
+                return 0;
+            };
+            svector<char> & buffer = buffers[p];
+            for (store_offset o1 : r1) {
+                store_offset const * lo = std::lower_bound(r2.begin(), r2.end(), o1,
+                    [&](store_offset o2, store_offset o) { return cmp(o2, o) < 0; });
+                for (; lo != r2.end() && cmp(*lo, o1) == 0; ++lo) {
+                    // columns are written as 64 bit words, which may extend beyond the last row.
+                    unsigned sz = buffer.size();
+                    buffer.resize(sz + res_size + sizeof(uint64_t), 0);
+                    buffer.shrink(sz + res_size);
+                    char const * t1ptr = t1.get_at_offset(o1);
+                    char const * t2ptr = t2.get_at_offset(*lo);
+                    if (tables_swapped) 
+                        concatenate_rows(t2.m_column_layout, t1.m_column_layout, result.m_column_layout,
+                            t2ptr, t1ptr, buffer.data() + sz, removed_cols);
+                    else 
+                        concatenate_rows(t1.m_column_layout, t2.m_column_layout, result.m_column_layout,
+                            t1ptr, t2ptr, buffer.data() + sz, removed_cols);
+                }
+            }
+        };
+
+#ifdef SINGLE_THREAD
+        for (unsigned p = 0; p < parallel_join_partitions; ++p)
+            join_partition(p);
+#else
+        std::atomic<unsigned> next(0);
+        std::mutex mux;
+        std::exception_ptr ex;
+        auto worker = [&]() {
+            try {
+                for (unsigned p = next++; p < parallel_join_partitions; p = next++)
+                    join_partition(p);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mux);
+                if (!ex)
+                    ex = std::current_exception();
+            }
+        };
+        vector<std::thread> threads;
+        for (unsigned w = 1; w < std::min(num_threads, parallel_join_partitions); ++w)
+            threads.push_back(std::thread(worker));
+        worker();
+        for (auto & th : threads)
+            th.join();
+        if (ex)
+            std::rethrow_exception(ex);
+#endif
+
+        for (svector<char> & buffer : buffers) {
+            for (unsigned ofs = 0; ofs < buffer.size(); ofs += res_size) {
+                result.m_data.ensure_reserve();
+                result.garbage_collect();
+                memcpy(result.m_data.get_reserve_ptr(), buffer.data() + ofs, res_size);
+                result.add_reserve_content();
+            }
+            buffer.finalize();
+        }
+    }
+
+
+    namespace {
+        /**
+           \brief State of a leapfrog triejoin.
+           Every table has a trie whose levels are its variables in increasing order,
+           so the next level of all tables that contain a variable is that variable.
+        */
+        class leapfrog_join_state {
+            unsigned                            m_num_vars;
+            vector<trie_iterator>               m_iterators;
+            vector<unsigned_vector>             m_var2tables;   // tables that contain a variable
+            vector<unsigned_vector> const &     m_vars;
+            svector<table_element>              m_binding;
+            table_fact                          m_fact;
+            ptr_vector<trie_iterator>           m_active;
+            std::function<void(table_fact const &)> m_emit;
+
+            void emit() {
+                unsigned k = 0;
+                for (unsigned_vector const & vs : m_vars)
+                    for (unsigned v : vs)
+                        m_fact[k++] = m_binding[v];
+                m_emit(m_fact);
+            }
+
+            /**
+               \brief Enumerate the keys common to the iterators in m_active[begin, end).
+            */
+            void leapfrog(unsigned var, unsigned begin, unsigned end) {
+                unsigned k = end - begin;
+                for (unsigned i = begin; i < end; ++i) {
+                    m_active[i]->open();
+                    if (m_active[i]->at_end()) {
+                        for (unsigned j = begin; j <= i; ++j)
+                            m_active[j]->up();
+                        return;
+                    }
+                }
+                std::sort(m_active.begin() + begin, m_active.begin() + end, 
+                    [](trie_iterator * a, trie_iterator * b) { return a->key() < b->key(); });
+                unsigned p = 0;
+                table_element max_key = m_active[begin + k - 1]->key();
+                while (true) {
+                    trie_iterator & it = *m_active[begin + p];
+                    table_element x = it.key();
+                    if (x == max_key) {
+                        m_binding[var] = x;
+                        search(var + 1);
+                        it.next();
+                    }
+                    else 
+                        it.seek(max_key);
+                    if (it.at_end())
+                        break;
+                    max_key = it.key();
+                    p = (p + 1) % k;
+                }
+                for (unsigned i = begin; i < end; ++i)
+                    m_active[i]->up();
+            }
+
+            void search(unsigned var) {
+                if (var == m_num_vars) {
+                    emit();
+                    return;
+                }
+                unsigned begin = m_active.size();
+                for (unsigned t : m_var2tables[var])
+                    m_active.push_back(&m_iterators[t]);
+                leapfrog(var, begin, m_active.size());
+                m_active.shrink(begin);
+            }
+
+        public:
+            leapfrog_join_state(unsigned n, sparse_table::trie_index * const * tries, vector<unsigned_vector> const & vars, 
+                                unsigned num_vars, std::function<void(table_fact const &)> const & emit):
+                m_num_vars(num_vars), m_vars(vars), m_emit(emit) {
+                m_iterators.resize(n);
+                m_var2tables.resize(num_vars);
+                m_binding.resize(num_vars, 0);
+                unsigned arity = 0;
+                for (unsigned i = 0; i < n; ++i) {
+                    m_iterators[i].init(*tries[i]);
+                    for (unsigned v : vars[i]) 
+                        m_var2tables[v].push_back(i);
+                    arity += vars[i].size();
+                }
+                m_fact.resize(arity);
+            }
+
+            void operator()() { 
+                for (unsigned_vector const & ts : m_var2tables) 
+                    if (ts.empty())
+                        return;
+                search(0); 
+            }
+        };
+    }
+
+    void sparse_table::leapfrog_join(unsigned n, const sparse_table * const * tables,
+            const vector<unsigned_vector> & vars, unsigned num_vars, sparse_table & result) {
+        verbose_action _va("leapfrog_join", 1);
+        ptr_vector<trie_index> tries;
+        for (unsigned i = 0; i < n; ++i) {
+            SASSERT(tables[i]->can_leapfrog_join());
+            SASSERT(vars[i].size() == tables[i]->get_signature().size());
+            // variables are distinct within a table, the compiler filters repeated variables first.
+            // the levels of the trie are the columns ordered by their variables.
+            unsigned_vector cols;
+            for (unsigned j = 0; j < vars[i].size(); ++j)
+                cols.push_back(j);
+            unsigned_vector const & vs = vars[i];
+            std::sort(cols.begin(), cols.end(), [&](unsigned a, unsigned b) { return vs[a] < vs[b]; });
+            tries.push_back(&tables[i]->get_trie_index(cols.size(), cols.data()));
+        }
+        leapfrog_join_state state(n, tries.data(), vars, num_vars, [&](table_fact const & f) {
+            result.garbage_collect();
+            result.add_fact(f);
+        });
+        state();
+    }
+
+
     // -----------------------------------
     //
     // sparse_table_plugin
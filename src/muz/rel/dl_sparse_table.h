@@ -301,6 +301,9 @@ namespace datalog {
     };
 
     class sparse_table : public table_base {
+    public:
+        class trie_index;
+    private:
         friend class sparse_table_plugin;
         friend class sparse_table_plugin::join_project_fn;
         friend class sparse_table_plugin::union_fn;
@@ -381,13 +384,22 @@ namespace datalog {
         typedef svector<table_element> key_value;  //values of key columns
         typedef map<key_spec, key_indexer*, svector_hash_proc<unsigned_hash>,
             vector_eq_proc<key_spec> > key_index_map;
+        typedef map<key_spec, trie_index*, svector_hash_proc<unsigned_hash>,
+            vector_eq_proc<key_spec> > trie_index_map;
 
         static const store_offset NO_RESERVE = UINT_MAX;
 
+        /**
+           Joins of tables with fewer rows in total are not split between threads.
+        */
+        static constexpr unsigned parallel_join_min_rows = 4096;
+        static constexpr unsigned parallel_join_partitions = 64;
+
         column_layout m_column_layout;
         unsigned m_fact_size;
         entry_storage m_data;
         mutable key_index_map m_key_indexes;
+        mutable trie_index_map m_trie_indexes;
 
 
         const char * get_at_offset(store_offset i) const {
@@ -418,6 +430,15 @@ namespace datalog {
         */
         key_indexer& get_key_indexer(unsigned key_len, const unsigned * key_cols) const;
 
+        /**
+           \brief Return reference to a trie over the rows of the table whose levels are the
+           columns \c cols. The columns must contain every column of the table exactly once.
+
+           A trie is the sequence of rows sorted lexicographically by \c cols. It is rebuilt
+           when facts were added since it was built, and destroyed with the key indexers.
+        */
+        trie_index& get_trie_index(unsigned col_cnt, const unsigned * cols) const;
+
         void reset_indexes();
 
         static void copy_columns(const column_layout & src_layout, const column_layout & dest_layout, 
@@ -452,6 +473,19 @@ namespace datalog {
             unsigned joined_col_cnt, const unsigned * t1_joined_cols, const unsigned * t2_joined_cols,
             const unsigned * removed_cols, bool tables_swapped, sparse_table & result);
 
+        /**
+           \brief Perform join-project between t1 and t2 as \c self_agnostic_join_project,
+           using \c num_threads threads.
+
+           The rows of both tables are partitioned by a hash of their joined columns, and the
+           partitions are joined independently into buffers without using the key indexes of t2.
+           The buffers are added to the result in the order of the partitions, which does not
+           depend on the number of threads, so the result is the same for every number of threads.
+        */
+        static void parallel_join_project(const sparse_table & t1, const sparse_table & t2,
+            unsigned joined_col_cnt, const unsigned * t1_joined_cols, const unsigned * t2_joined_cols,
+            const unsigned * removed_cols, bool tables_swapped, unsigned num_threads, sparse_table & result);
+
 
         /**
            If the fact at \c data (in table's native representation) is not in the table,
@@ -493,6 +527,25 @@ namespace datalog {
         unsigned get_size_estimate_rows() const override { return row_count(); }
         unsigned get_size_estimate_bytes() const override;
         bool knows_exact_size() const override { return true; }
+
+        /**
+           \brief Return true if \c leapfrog_join can join the table.
+        */
+        bool can_leapfrog_join() const { return get_signature().functional_columns() == 0; }
+
+        /**
+           \brief Join \c n tables on shared variables using leapfrog triejoin.
+
+           Column \c j of table \c i holds variable \c vars[i][j]. Variables range over
+           [0, num_vars), a table contains each variable at most once, and variables are
+           bound in increasing order. The result contains the columns of all tables in
+           order, as the pairwise join of the tables would.
+
+           Unlike pairwise joins, the join does not materialize intermediate tables. Its
+           running time is bounded by the largest possible result of the join.
+        */
+        static void leapfrog_join(unsigned n, const sparse_table * const * tables,
+            const vector<unsigned_vector> & vars, unsigned num_vars, sparse_table & result);
     };
 
  };
@@ -1230,6 +1230,70 @@ void pred_transformer::propagate_to_infinity (unsigned level) {
     m_frames.propagate_to_infinity (level);
 }
 
+void pred_transformer::export_lemmas(expr_ref_vector &lemmas, expr_ref_vector &rfs) const
+{
+    // replace local constants by free variables, argument i by variable i.
+    expr_ref_vector bound(m);
+    for (unsigned i = sig_size(); i-- > 0; ) {
+        bound.push_back(m.mk_const(pm.o2n(sig(i), 0)));
+    }
+    for (lemma *lem : m_frames.lemmas()) {
+        lemmas.push_back(expr_abstract(bound, lem->get_expr()));
+    }
+    for (reach_fact *rf : m_reach_facts) {
+        if (!rf->is_init()) { rfs.push_back(expr_abstract(bound, rf->get())); }
+    }
+}
+
+unsigned pred_transformer::import_lemmas(expr_ref_vector const &lemmas,
+                                         expr_ref_vector const &rfs,
+                                         unsigned &num_refuted)
+{
+    expr_ref_vector sig_consts(m);
+    for (unsigned i = 0; i < sig_size(); ++i) {
+        sig_consts.push_back(m.mk_const(pm.o2n(sig(i), 0)));
+    }
+    var_subst vs(m, false);
+
+    // a candidate that is false in a reach fact of the previous run is
+    // dropped without a call to the frame solver.
+    sref_vector<model> rf_models;
+    if (!rfs.empty()) {
+        ref<solver> s = mk_smt_solver(m, params_ref::get_empty(), symbol::null);
+        for (expr *rf : rfs) {
+            s->push();
+            s->assert_expr(vs(rf, sig_consts));
+            if (s->check_sat(0, nullptr) == l_true) {
+                model_ref mdl;
+                s->get_model(mdl);
+                rf_models.push_back(mdl.get());
+            }
+            s->pop(1);
+        }
+    }
+
+    ensure_level(0);
+    unsigned num_added = 0;
+    for (expr *e : lemmas) {
+        expr_ref fml = vs(e, sig_consts);
+        bool refuted = false;
+        if (is_ground(fml)) {
+            for (model *mdl : rf_models) {
+                if (mdl->is_false(fml)) { refuted = true; break; }
+            }
+        }
+        if (refuted) { ++num_refuted; continue; }
+        lemma_ref lem = alloc(lemma, m, fml, 0);
+        lem->set_external(true);
+        unsigned solver_level;
+        if (is_invariant(0, lem.get(), solver_level)) {
+            lem->set_level(solver_level);
+            if (m_frames.add_lemma(lem.get())) { ++num_added; }
+        }
+    }
+    return num_added;
+}
+
 // compute a conjunction of all background facts
 void pred_transformer::get_pred_bg_invs(expr_ref_vector& out) {
     expr_ref inv(m), tmp1(m), tmp2(m);
@@ -2369,6 +2433,7 @@ void context::reset()
     m_query = nullptr;
     m_last_result = l_undef;
     m_inductive_lvl = 0;
+    m_lemma_db = nullptr;
 }
 
 void context::init_rules(datalog::rule_set& rules, decl2rel& rels)
@@ -2709,6 +2774,7 @@ lbool context::solve(unsigned from_lvl)
 {
     m_last_result = l_undef;
     try {
+        load_lemma_db();
         if (m_use_gpdr) {
             SASSERT(from_lvl == 0);
             m_last_result = gpdr_solve_core();
@@ -2737,6 +2803,7 @@ lbool context::solve(unsigned from_lvl)
             //   }
             // }
         }
+        save_lemma_db();
         VERIFY (validate ());
     } catch (const unknown_exception &)
     {}
@@ -3145,6 +3212,7 @@ bool context::check_reachability ()
     while (m_pob_queue.top()) {
         pob_ref node;
         checkpoint ();
+        import_lemmas_eh();
 
         while (last_reachable) {
             checkpoint ();
@@ -3336,6 +3404,74 @@ void context::dump_json()
     }
 }
 
+void context::load_lemma_db()
+{
+    symbol file = m_params.spacer_lemma_db();
+    if (!file.is_non_empty_string() || m_lemma_db) { return; }
+
+    m_lemma_db = alloc(lemma_db, m);
+    if (!m_lemma_db->load(file.bare_str())) { return; }
+
+    unsigned num_seeded = 0;
+    for (auto &kv : m_rels) {
+        expr_ref_vector const *lemmas = m_lemma_db->lemmas(kv.m_key);
+        if (!lemmas || lemmas->empty()) { continue; }
+        checkpoint();
+        m_stats.m_num_db_candidates += lemmas->size();
+        num_seeded += kv.m_value->import_lemmas(*lemmas, *m_lemma_db->reach_facts(kv.m_key),
+                                                m_stats.m_num_db_refuted);
+    }
+
+    // push the seeded lemmas as far as they go. The frames only grow up to
+    // the number of seeded lemmas, and when no lemma is left at a level the
+    // lemmas above it are inductive and move to the infinite level.
+    for (unsigned lvl = 0; num_seeded > 0; ++lvl) {
+        checkpoint();
+        bool all_propagated = true;
+        for (auto &kv : m_rels) {
+            all_propagated = kv.m_value->propagate_to_next_level(lvl) && all_propagated;
+        }
+        if (all_propagated) {
+            for (auto &kv : m_rels) { kv.m_value->propagate_to_infinity(lvl); }
+            break;
+        }
+    }
+    m_stats.m_num_db_seeded += num_seeded;
+    IF_VERBOSE(1, verbose_stream() << "(spacer.lemma-db :candidates " << m_stats.m_num_db_candidates
+               << " :refuted " << m_stats.m_num_db_refuted
+               << " :seeded " << num_seeded << ")\n";);
+}
+
+void context::save_lemma_db()
+{
+    if (!m_lemma_db) { return; }
+    for (auto &kv : m_rels) {
+        expr_ref_vector lemmas(m), rfs(m);
+        kv.m_value->export_lemmas(lemmas, rfs);
+        m_lemma_db->set(kv.m_key, lemmas, rfs);
+    }
+    bool saved = false;
+    try {
+        saved = m_lemma_db->save(m_params.spacer_lemma_db().bare_str());
+    }
+    catch (const z3_exception & ex) {
+        // lemmas with lambdas or external parameters cannot be serialized
+        IF_VERBOSE(1, verbose_stream() << "(spacer.lemma-db :error \"" << ex.msg() << "\")\n";);
+    }
+    if (!saved) {
+        IF_VERBOSE(1, verbose_stream() << "(spacer.lemma-db :error \"could not write "
+                   << m_params.spacer_lemma_db() << "\")\n";);
+    }
+}
+
+void context::import_lemmas_eh()
+{
+    for (unsigned i = 0; i < m_callbacks.size(); i++) {
+        if (m_callbacks[i]->import_lemmas())
+            m_callbacks[i]->import_lemmas_eh();
+    }
+}
+
 void context::predecessor_eh()
 {
     for (unsigned i = 0; i < m_callbacks.size(); i++) {
@@ -3987,6 +4123,12 @@ void context::collect_statistics(statistics& st) const
                m_create_children_watch.get_seconds ());
     st.update("spacer.lemmas_imported", m_stats.m_num_lemmas_imported);
     st.update("spacer.lemmas_discarded", m_stats.m_num_lemmas_discarded);
+    // -- lemmas read from the lemma database
+    st.update("SPACER lemma db candidates", m_stats.m_num_db_candidates);
+    // -- candidates refuted by a reach fact of the database
+    st.update("SPACER lemma db refuted", m_stats.m_num_db_refuted);
+    // -- candidates that hold in the initial states
+    st.update("SPACER lemma db seeded", m_stats.m_num_db_seeded);
 
     for (unsigned i = 0; i < m_lemma_generalizers.size(); ++i) {
         m_lemma_generalizers[i]->collect_statistics(st);
@@ -4101,8 +4243,10 @@ void context::new_lemma_eh(pred_transformer &pt, lemma *lem) {
     }
     if (!handle)
         return;
-    if ((is_infty_level(lem->level()) && m_params.spacer_p3_share_invariants()) ||
-        (!is_infty_level(lem->level()) && m_params.spacer_p3_share_lemmas())) {
+    // parallel workers share all lemmas.
+    bool share_all = m_params.spacer_threads() > 1;
+    if ((is_infty_level(lem->level()) && (share_all || m_params.spacer_p3_share_invariants())) ||
+        (!is_infty_level(lem->level()) && (share_all || m_params.spacer_p3_share_lemmas()))) {
         expr_ref_vector args(m);
         for (unsigned i = 0; i < pt.sig_size(); ++i) {
             args.push_back(m.mk_const(pt.get_manager().o2n(pt.sig(i), 0)));
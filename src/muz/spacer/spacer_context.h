@@ -30,6 +30,7 @@ Notes:
 #include "muz/spacer/spacer_manager.h"
 #include "muz/spacer/spacer_prop_solver.h"
 #include "muz/spacer/spacer_json.h"
+#include "muz/spacer/spacer_lemma_db.h"
 
 #include "muz/base/fp_params.hpp"
 
@@ -506,6 +507,13 @@ public:
 
     bool propagate_to_next_level(unsigned level);
     void propagate_to_infinity(unsigned level);
+    /// \brief Collect the lemmas and the reach facts that are not initial
+    /// over the free variables of the signature, see lemma_db.
+    void export_lemmas(expr_ref_vector &lemmas, expr_ref_vector &rfs) const;
+    /// \brief Add the candidate lemmas that are not refuted by a reach fact
+    /// and that hold in the initial states. Return the number of added lemmas.
+    unsigned import_lemmas(expr_ref_vector const &lemmas, expr_ref_vector const &rfs,
+                           unsigned &num_refuted);
     /// \brief  Add a lemma to the current context and all users
     bool add_lemma(expr * e, unsigned lvl, bool bg);
     bool add_lemma(lemma* lem) {return m_frames.add_lemma(lem);}
@@ -895,6 +903,14 @@ public:
 
     virtual void propagate_eh() {}
 
+    /**
+       \brief Called between proof obligations. Lemmas found elsewhere
+       can be added with context::add_constraint.
+    */
+    virtual inline bool import_lemmas() { return false; }
+
+    virtual void import_lemmas_eh() {}
+
 };
 
 // order in which children are processed
@@ -917,6 +933,9 @@ class context {
         unsigned m_num_restarts;
         unsigned m_num_lemmas_imported;
         unsigned m_num_lemmas_discarded;
+        unsigned m_num_db_candidates;
+        unsigned m_num_db_refuted;
+        unsigned m_num_db_seeded;
         stats() { reset(); }
         void reset() { memset(this, 0, sizeof(*this)); }
     };
@@ -988,6 +1007,7 @@ class context {
     unsigned             m_blast_term_ite_inflation;
     scoped_ptr_vector<spacer_callback> m_callbacks;
     json_marshaller      m_json_marshaller;
+    scoped_ptr<lemma_db> m_lemma_db;
     std::fstream*        m_trace_stream;
 
     // Solve using gpdr strategy
@@ -1052,9 +1072,14 @@ class context {
 
     void dump_json();
 
+    // warm start from the lemma database given by spacer.lemma_db
+    void load_lemma_db();
+    void save_lemma_db();
+
     void predecessor_eh();
 
     void updt_params();
+    void import_lemmas_eh();
     lbool handle_unknown(pob &n, const datalog::rule *r, model &model);
     bool mk_mdl_rf_consistent(model &mdl);
 
@@ -1118,6 +1143,7 @@ public:
     pob& get_root() const {return m_pob_queue.get_root();}
     void set_query(func_decl* q) {m_query_pred = q;}
     void set_unsat() {m_last_result = l_false;}
+    unsigned get_inductive_lvl() const {return m_inductive_lvl;}
     void set_model_converter(model_converter_ref& mc) {m_mc = mc;}
     model_converter_ref get_model_converter() { return m_mc; }
     void set_proof_converter(proof_converter_ref& pc) { m_pc = pc; }
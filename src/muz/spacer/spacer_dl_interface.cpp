@@ -35,6 +35,7 @@ Revision History:
 #include "ast/scoped_proof.h"
 #include "muz/transforms/dl_transforms.h"
 #include "muz/spacer/spacer_callback.h"
+#include "muz/spacer/spacer_parallel.h"
 
 using namespace spacer;
 
@@ -164,6 +165,8 @@ lbool dl_interface::query(expr * query)
         return l_false;
     }
 
+    if (m_ctx.get_params().spacer_threads() > 1)
+        return spacer::parallel(*m_context, m_spacer_rules, query_pred)(m_ctx.get_params().spacer_min_level());
     return m_context->solve(m_ctx.get_params().spacer_min_level());
 
 }
@@ -257,6 +260,8 @@ lbool dl_interface::query_from_lvl(expr * query, unsigned lvl)
         return l_false;
     }
 
+    if (m_ctx.get_params().spacer_threads() > 1)
+        return spacer::parallel(*m_context, m_spacer_rules, query_pred)(lvl);
     return m_context->solve(lvl);
 
 }
@@ -0,0 +1,231 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    spacer_lemma_db.cpp
+
+Abstract:
+
+    Persistent database of spacer lemmas and reach facts.
+
+    File layout:
+
+      header   "Z3LDB" followed by a version byte
+      record   key size           (4 bytes)
+               number of lemmas   (4 bytes)
+               number of reach facts (4 bytes)
+               payload size       (4 bytes)
+               checksum           (4 bytes) of the previous fields, the key and the payload
+               key                signature of the predicate
+               payload            serialization of the conjunction of the lemmas
+                                  followed by the reach facts
+
+    The formulas of a predicate are serialized together, so that they share
+    their common sub-terms. All integers are stored little endian.
+
+--*/
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#ifdef _WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "util/hash.h"
+#include "util/mutex.h"
+#include "ast/ast_pp.h"
+#include "ast/ast_serialize.h"
+#include "muz/spacer/spacer_lemma_db.h"
+
+namespace spacer {
+
+    static const char          DB_MAGIC[]         = { 'Z', '3', 'L', 'D', 'B' };
+    static const unsigned      DB_MAGIC_SIZE      = sizeof(DB_MAGIC);
+    static const unsigned char DB_VERSION         = 1;
+    static const unsigned      RECORD_HEADER_SIZE = 20;
+
+    static unsigned read_u32(char const * p) {
+        unsigned r = 0;
+        for (unsigned i = 4; i-- > 0; )
+            r = (r << 8) | static_cast<unsigned char>(p[i]);
+        return r;
+    }
+
+    static void write_u32(std::string & out, unsigned v) {
+        for (unsigned i = 0; i < 4; ++i, v >>= 8)
+            out.push_back(static_cast<char>(v & 0xff));
+    }
+
+    static unsigned record_checksum(char const * record, unsigned body_size) {
+        unsigned h = string_hash(record, 16, 17);
+        return string_hash(record + RECORD_HEADER_SIZE, body_size, h);
+    }
+
+    std::string lemma_db::mk_key(func_decl * p) const {
+        std::ostringstream strm;
+        strm << p->get_name() << "(";
+        for (unsigned i = 0; i < p->get_arity(); ++i) {
+            if (i > 0)
+                strm << " ";
+            strm << mk_pp(p->get_domain(i), m);
+        }
+        strm << ")";
+        return strm.str();
+    }
+
+    lemma_db::pred_entry * lemma_db::find(func_decl * p) const {
+        auto it = m_key2idx.find(mk_key(p));
+        return it == m_key2idx.end() ? nullptr : m_entries[it->second];
+    }
+
+    lemma_db::pred_entry & lemma_db::mk_entry(std::string const & key) {
+        auto it = m_key2idx.find(key);
+        if (it != m_key2idx.end())
+            return *m_entries[it->second];
+        m_key2idx[key] = m_entries.size();
+        m_entries.push_back(alloc(pred_entry, m, key));
+        return *m_entries.back();
+    }
+
+    expr_ref_vector const * lemma_db::lemmas(func_decl * p) const {
+        pred_entry * e = find(p);
+        return e ? &e->m_lemmas : nullptr;
+    }
+
+    expr_ref_vector const * lemma_db::reach_facts(func_decl * p) const {
+        pred_entry * e = find(p);
+        return e ? &e->m_reach_facts : nullptr;
+    }
+
+    void lemma_db::set(func_decl * p, expr_ref_vector const & lemmas, expr_ref_vector const & reach_facts) {
+        pred_entry & e = mk_entry(mk_key(p));
+        e.m_lemmas.reset();
+        e.m_lemmas.append(lemmas);
+        e.m_reach_facts.reset();
+        e.m_reach_facts.append(reach_facts);
+    }
+
+    bool lemma_db::load(char const * file) {
+        std::ifstream in(file, std::ios::binary);
+        if (!in)
+            return false;
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() <= DB_MAGIC_SIZE ||
+            memcmp(data.data(), DB_MAGIC, DB_MAGIC_SIZE) != 0 ||
+            static_cast<unsigned char>(data[DB_MAGIC_SIZE]) != DB_VERSION)
+            return false;
+
+        char const * curr = data.data() + DB_MAGIC_SIZE + 1;
+        char const * end  = data.data() + data.size();
+        unsigned num_skipped = 0;
+        while (static_cast<size_t>(end - curr) >= RECORD_HEADER_SIZE) {
+            unsigned key_size     = read_u32(curr);
+            unsigned num_lemmas   = read_u32(curr + 4);
+            unsigned num_rfs      = read_u32(curr + 8);
+            unsigned payload_size = read_u32(curr + 12);
+            unsigned checksum     = read_u32(curr + 16);
+            size_t body = static_cast<size_t>(key_size) + payload_size;
+            if (static_cast<size_t>(end - curr) - RECORD_HEADER_SIZE < body)
+                break;
+            char const * key     = curr + RECORD_HEADER_SIZE;
+            char const * payload = key + key_size;
+            curr += RECORD_HEADER_SIZE + body;
+            if (record_checksum(key - RECORD_HEADER_SIZE, static_cast<unsigned>(body)) != checksum) {
+                ++num_skipped;
+                continue;
+            }
+
+            expr_ref_vector fmls(m);
+            unsigned num_fmls = num_lemmas + num_rfs;
+            if (num_fmls > 0) {
+                expr_ref e = ast_deserialize(m, payload, payload_size);
+                if (!e) {
+                    ++num_skipped;
+                    continue;
+                }
+                if (num_fmls == 1)
+                    fmls.push_back(e);
+                else if (m.is_and(e) && to_app(e)->get_num_args() == num_fmls)
+                    fmls.append(num_fmls, to_app(e)->get_args());
+                else {
+                    ++num_skipped;
+                    continue;
+                }
+            }
+            pred_entry & pe = mk_entry(std::string(key, key_size));
+            pe.m_lemmas.reset();
+            pe.m_lemmas.append(num_lemmas, fmls.data());
+            pe.m_reach_facts.reset();
+            pe.m_reach_facts.append(num_rfs, fmls.data() + num_lemmas);
+        }
+        IF_VERBOSE(2, verbose_stream() << "(spacer.lemma-db :file " << file << " :predicates " << m_entries.size()
+                   << " :skipped " << num_skipped << ")\n";);
+        return true;
+    }
+
+    // name of a temporary file next to file that no other process or thread uses.
+    static std::string mk_tmp_name(char const * file) {
+        static atomic<unsigned> s_counter(0);
+#ifdef _WINDOWS
+        unsigned pid = static_cast<unsigned>(_getpid());
+#else
+        unsigned pid = static_cast<unsigned>(getpid());
+#endif
+        std::ostringstream strm;
+        strm << file << ".tmp." << pid << "." << s_counter++;
+        return strm.str();
+    }
+
+    bool lemma_db::save(char const * file) const {
+        std::string out(DB_MAGIC, DB_MAGIC_SIZE);
+        out.push_back(static_cast<char>(DB_VERSION));
+        std::string payload;
+        for (pred_entry * e : m_entries) {
+            expr_ref_vector fmls(m);
+            fmls.append(e->m_lemmas);
+            fmls.append(e->m_reach_facts);
+            payload.clear();
+            if (fmls.size() == 1)
+                ast_serialize(m, fmls.get(0), payload);
+            else if (fmls.size() > 1)
+                ast_serialize(m, m.mk_app(basic_family_id, OP_AND, fmls.size(), fmls.data()), payload);
+
+            size_t start = out.size();
+            write_u32(out, static_cast<unsigned>(e->m_key.size()));
+            write_u32(out, e->m_lemmas.size());
+            write_u32(out, e->m_reach_facts.size());
+            write_u32(out, static_cast<unsigned>(payload.size()));
+            write_u32(out, 0);
+            out.append(e->m_key);
+            out.append(payload);
+            unsigned checksum = record_checksum(out.data() + start, static_cast<unsigned>(e->m_key.size() + payload.size()));
+            for (unsigned i = 0; i < 4; ++i)
+                out[start + 16 + i] = static_cast<char>((checksum >> (8 * i)) & 0xff);
+        }
+
+        // write a temporary file first, so that concurrent readers never see
+        // a partially written database.
+        std::string tmp = mk_tmp_name(file);
+        {
+            std::ofstream of(tmp, std::ios::binary | std::ios::trunc);
+            if (!of)
+                return false;
+            of.write(out.data(), out.size());
+            if (!of)
+                return false;
+        }
+#ifdef _WINDOWS
+        std::remove(file);
+#endif
+        if (std::rename(tmp.c_str(), file) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,77 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    spacer_lemma_db.h
+
+Abstract:
+
+    Persistent database of spacer lemmas and reach facts.
+
+    The database keeps the lemmas and reach facts of predicates between
+    runs so that a query can be warm-started with the lemmas of a previous
+    run on a similar set of rules. Entries are keyed by the signature of a
+    predicate, its name and the sorts of its arguments. Formulas are stored
+    over free variables: variable i stands for argument i of the predicate.
+
+    Nothing in the database is trusted. The lemmas are candidates that the
+    context validates before adding them to the frames, and the reach facts
+    are only used to refute candidates.
+
+--*/
+#pragma once
+
+#include <map>
+#include <string>
+#include "ast/ast.h"
+#include "util/scoped_ptr_vector.h"
+
+namespace spacer {
+
+    class lemma_db {
+        struct pred_entry {
+            std::string     m_key;
+            expr_ref_vector m_lemmas;
+            expr_ref_vector m_reach_facts;
+            pred_entry(ast_manager & m, std::string const & key):
+                m_key(key), m_lemmas(m), m_reach_facts(m) {}
+        };
+
+        ast_manager &                   m;
+        scoped_ptr_vector<pred_entry>   m_entries;
+        std::map<std::string, unsigned> m_key2idx;
+
+        pred_entry * find(func_decl * p) const;
+        pred_entry & mk_entry(std::string const & key);
+
+    public:
+        lemma_db(ast_manager & m): m(m) {}
+
+        std::string mk_key(func_decl * p) const;
+
+        /**
+           \brief Read the database from file.
+           Return false if the file does not exist or is not a lemma database.
+           Records with an invalid checksum are skipped.
+        */
+        bool load(char const * file);
+
+        /**
+           \brief Write the database to file. The file is replaced atomically
+           where the platform supports it.
+        */
+        bool save(char const * file) const;
+
+        /**
+           \brief Replace the entry of p.
+        */
+        void set(func_decl * p, expr_ref_vector const & lemmas, expr_ref_vector const & reach_facts);
+
+        expr_ref_vector const * lemmas(func_decl * p) const;
+        expr_ref_vector const * reach_facts(func_decl * p) const;
+
+        unsigned size() const { return m_entries.size(); }
+    };
+
+}
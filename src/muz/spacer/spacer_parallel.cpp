@@ -0,0 +1,328 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    spacer_parallel.cpp
+
+Abstract:
+
+    Parallel SPACER with lemmas shared between workers.
+
+--*/
+
+#include "muz/spacer/spacer_parallel.h"
+
+#ifdef SINGLE_THREAD
+
+namespace spacer {
+
+    lbool parallel::operator()(unsigned from_lvl) {
+        return m_ctx.solve(from_lvl);
+    }
+
+}
+
+#else
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "ast/ast_translation.h"
+#include "ast/ast_util.h"
+#include "muz/base/dl_context.h"
+#include "muz/spacer/spacer_util.h"
+#include "smt/params/smt_params.h"
+
+namespace spacer {
+
+    /**
+       \brief Lemmas published by the workers.
+
+       Lemmas are implications P(x) => C as produced by context::new_lemma_eh,
+       where C is a clause over the signature constants of P, and they are imported
+       with context::add_constraint. The store translates them to its own manager.
+
+       The lemmas of a predicate are indexed by level. A lemma subsumes another
+       lemma of the same predicate if its level is at least the other level and its
+       literals are a subset of the other literals. Subsumed lemmas are not stored,
+       and a new lemma retires the stored lemmas it subsumes.
+    */
+    class lemma_store {
+        struct entry {
+            expr *           m_lemma;
+            unsigned         m_level;
+            unsigned         m_owner;
+            bool             m_active;
+            ptr_vector<expr> m_lits;     // literals of the clause, sorted by id
+        };
+
+        struct pred_lemmas {
+            vector<unsigned_vector> m_levels;
+            unsigned_vector         m_invariants;
+
+            unsigned_vector & at(unsigned level) {
+                if (is_infty_level(level))
+                    return m_invariants;
+                m_levels.reserve(level + 1);
+                return m_levels[level];
+            }
+        };
+
+        ast_manager                  m;
+        std::mutex                   m_mux;
+        expr_ref_vector              m_pinned;
+        vector<entry>                m_entries;
+        obj_map<func_decl, unsigned> m_pred2idx;
+        vector<pred_lemmas>          m_preds;
+        std::atomic<unsigned>        m_size { 0 };
+        unsigned                     m_num_subsumed { 0 };
+
+        static bool is_subset(ptr_vector<expr> const & a, ptr_vector<expr> const & b) {
+            return std::includes(b.begin(), b.end(), a.begin(), a.end(),
+                                 [](expr * x, expr * y) { return x->get_id() < y->get_id(); });
+        }
+
+        bool subsumes(unsigned idx, ptr_vector<expr> const & lits) const {
+            return m_entries[idx].m_active && is_subset(m_entries[idx].m_lits, lits);
+        }
+
+        void retire(unsigned_vector & idxs, ptr_vector<expr> const & lits) {
+            unsigned j = 0;
+            for (unsigned idx : idxs) {
+                entry & e = m_entries[idx];
+                if (e.m_active && is_subset(lits, e.m_lits)) {
+                    e.m_active = false;
+                    ++m_num_subsumed;
+                }
+                if (e.m_active)
+                    idxs[j++] = idx;
+            }
+            idxs.shrink(j);
+        }
+
+    public:
+        lemma_store(ast_manager & src): m(src, true), m_pinned(m) {}
+
+        void publish(unsigned owner, ast_manager & src, expr * lemma, unsigned level) {
+            expr * head, * body;
+            if (!src.is_implies(lemma, head, body) || !is_app(head) || is_quantifier(body))
+                return;
+            std::lock_guard<std::mutex> lock(m_mux);
+            ast_translation tr(src, m);
+            expr_ref l(tr(lemma), m);
+            VERIFY(m.is_implies(l, head, body));
+            expr_ref_vector clause(m);
+            flatten_or(body, clause);
+            ptr_vector<expr> lits(clause.size(), clause.data());
+            std::sort(lits.begin(), lits.end(), [](expr * x, expr * y) { return x->get_id() < y->get_id(); });
+            lits.shrink(static_cast<unsigned>(std::unique(lits.begin(), lits.end()) - lits.begin()));
+
+            func_decl * p = to_app(head)->get_decl();
+            unsigned pidx;
+            if (!m_pred2idx.find(p, pidx)) {
+                pidx = m_preds.size();
+                m_preds.push_back(pred_lemmas());
+                m_pred2idx.insert(p, pidx);
+                m_pinned.push_back(head);
+            }
+            pred_lemmas & pl = m_preds[pidx];
+
+            // a lemma at a level at least as high with fewer literals makes it redundant.
+            for (unsigned idx : pl.m_invariants)
+                if (subsumes(idx, lits))
+                    return;
+            if (!is_infty_level(level)) {
+                for (unsigned lvl = level; lvl < pl.m_levels.size(); ++lvl)
+                    for (unsigned idx : pl.m_levels[lvl])
+                        if (subsumes(idx, lits))
+                            return;
+            }
+
+            // retire the lemmas the new lemma subsumes.
+            unsigned max_lvl = is_infty_level(level) ? pl.m_levels.size() : std::min(level + 1, pl.m_levels.size());
+            for (unsigned lvl = 0; lvl < max_lvl; ++lvl)
+                retire(pl.m_levels[lvl], lits);
+            if (is_infty_level(level))
+                retire(pl.m_invariants, lits);
+
+            pl.at(level).push_back(m_entries.size());
+            m_pinned.push_back(l);
+            m_entries.push_back({ l.get(), level, owner, true, std::move(lits) });
+            m_size = m_entries.size();
+        }
+
+        /**
+           \brief Translate the lemmas of other workers published since head to dst.
+        */
+        void fetch(unsigned owner, ast_manager & dst, unsigned & head, expr_ref_vector & lemmas, unsigned_vector & levels) {
+            if (head == m_size)
+                return;
+            std::lock_guard<std::mutex> lock(m_mux);
+            ast_translation tr(m, dst);
+            for (; head < m_entries.size(); ++head) {
+                entry const & e = m_entries[head];
+                if (!e.m_active || e.m_owner == owner)
+                    continue;
+                lemmas.push_back(tr(e.m_lemma));
+                levels.push_back(e.m_level);
+            }
+        }
+
+        unsigned num_lemmas() const { return m_entries.size(); }
+        unsigned num_subsumed() const { return m_num_subsumed; }
+    };
+
+    /**
+       \brief Connects a worker to the lemma store.
+    */
+    class lemma_sharing : public spacer_callback {
+        lemma_store & m_store;
+        unsigned      m_id;
+        unsigned      m_head { 0 };
+    public:
+        lemma_sharing(context & ctx, lemma_store & store, unsigned id):
+            spacer_callback(ctx), m_store(store), m_id(id) {}
+
+        bool new_lemma() override { return true; }
+
+        void new_lemma_eh(expr * lemma, unsigned level) override {
+            m_store.publish(m_id, m_context.get_ast_manager(), lemma, level);
+        }
+
+        bool import_lemmas() override { return true; }
+
+        void import_lemmas_eh() override {
+            ast_manager & m = m_context.get_ast_manager();
+            expr_ref_vector lemmas(m);
+            unsigned_vector levels;
+            m_store.fetch(m_id, m, m_head, lemmas, levels);
+            // imported lemmas are external, so they are not published again.
+            for (unsigned i = 0; i < lemmas.size(); ++i)
+                m_context.add_constraint(lemmas.get(i), levels[i]);
+        }
+
+        /**
+           \brief Publish the inductive invariant of the worker.
+        */
+        void publish_invariant() {
+            ast_manager & m = m_context.get_ast_manager();
+            expr_ref_vector constraints(m), body(m);
+            flatten_and(m_context.get_constraints(m_context.get_inductive_lvl()), constraints);
+            for (expr * c : constraints) {
+                expr * head, * b;
+                if (!m.is_implies(c, head, b))
+                    continue;
+                body.reset();
+                flatten_and(b, body);
+                for (expr * l : body) {
+                    expr_ref lemma(m.mk_implies(head, l), m);
+                    new_lemma_eh(lemma, infty_level());
+                }
+            }
+        }
+    };
+
+    class no_engines : public datalog::register_engine_base {
+    public:
+        datalog::engine_base * mk_engine(datalog::DL_ENGINE engine_type) override { return nullptr; }
+        void set_context(datalog::context * ctx) override {}
+    };
+
+    struct worker {
+        scoped_ptr<ast_manager>       m;
+        smt_params                    m_fparams;
+        params_ref                    m_params;
+        no_engines                    m_engines;
+        scoped_ptr<datalog::context>  m_dl;
+        scoped_ptr<datalog::rule_set> m_rules;
+        scoped_ptr<context>           m_spacer;
+        lemma_sharing *               m_sharing { nullptr };
+    };
+
+    lbool parallel::operator()(unsigned from_lvl) {
+        ast_manager & m = m_ctx.get_ast_manager();
+        unsigned num_threads = m_ctx.get_params().spacer_threads();
+        if (num_threads <= 1)
+            return m_ctx.solve(from_lvl);
+        if (m.has_trace_stream())
+            throw default_exception("trace streams have to be off in parallel mode");
+
+        lemma_store store(m);
+        scoped_limits sl(m.limit());
+        scoped_ptr_vector<worker> workers;
+        for (unsigned i = 1; i < num_threads; ++i) {
+            worker * w = alloc(worker);
+            workers.push_back(w);
+            w->m = alloc(ast_manager, m, !m.proofs_enabled());
+            sl.push_child(&w->m->limit());
+            w->m_params.copy(m_ctx.get_params().p);
+            w->m_params.set_uint("spacer.random_seed", m_ctx.get_params().spacer_random_seed() + i);
+            w->m_params.set_uint("spacer.order_children", i % 2 == 1 ? CO_RANDOM : m_ctx.get_params().spacer_order_children());
+            // only the context reads and writes the lemma database.
+            w->m_params.set_sym("spacer.lemma_db", symbol::null);
+            w->m_dl = alloc(datalog::context, *w->m, w->m_engines, w->m_fparams, w->m_params);
+            w->m_rules = alloc(datalog::rule_set, *w->m_dl);
+
+            ast_translation tr(m, *w->m);
+            datalog::rule_manager & rm = w->m_dl->get_rule_manager();
+            for (datalog::rule * r : m_rules) {
+                ptr_vector<app> tail;
+                bool_vector neg;
+                for (unsigned j = 0; j < r->get_tail_size(); ++j) {
+                    tail.push_back(tr(r->get_tail(j)));
+                    neg.push_back(r->is_neg_tail(j));
+                }
+                w->m_rules->add_rule(rm.mk(tr(r->get_head()), tail.size(), tail.data(), neg.data(), r->name(), false));
+            }
+            w->m_rules->close();
+            w->m_spacer = alloc(context, w->m_dl->get_params(), *w->m);
+            w->m_spacer->set_query(tr(m_query));
+            w->m_spacer->update_rules(*w->m_rules);
+            w->m_sharing = alloc(lemma_sharing, *w->m_spacer, store, i);
+            w->m_spacer->callbacks().push_back(w->m_sharing);
+        }
+        m_ctx.callbacks().push_back(alloc(lemma_sharing, m_ctx, store, 0));
+
+        auto worker_thread = [&](worker & w, unsigned i) {
+            try {
+                lbool r = w.m_spacer->solve(from_lvl);
+                IF_VERBOSE(1, verbose_stream() << "(spacer.thread " << i << " :result " << r << ")\n");
+                if (r == l_false)
+                    w.m_sharing->publish_invariant();
+            }
+            catch (z3_exception &) {
+                // workers are canceled when the context is done.
+            }
+        };
+
+        vector<std::thread> threads(workers.size());
+        for (unsigned i = 0; i < workers.size(); ++i)
+            threads[i] = std::thread([&, i]() { worker_thread(*workers[i], i + 1); });
+
+        auto stop = [&]() {
+            for (worker * w : workers)
+                w->m->limit().cancel();
+            for (auto & th : threads)
+                th.join();
+            m_ctx.callbacks().pop_back();
+            IF_VERBOSE(1, verbose_stream() << "(spacer.parallel :lemmas " << store.num_lemmas()
+                       << " :subsumed " << store.num_subsumed() << ")\n");
+        };
+
+        lbool result;
+        try {
+            result = m_ctx.solve(from_lvl);
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+        stop();
+        return result;
+    }
+
+}
+
+#endif
@@ -0,0 +1,46 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    spacer_parallel.h
+
+Abstract:
+
+    Parallel SPACER with lemmas shared between workers.
+
+--*/
+
+#pragma once
+
+#include "muz/base/dl_rule_set.h"
+#include "muz/spacer/spacer_context.h"
+
+namespace spacer {
+
+    /**
+       \brief Solve the rules of a context with spacer.threads workers.
+
+       The context is the first worker and runs on the calling thread. The other
+       workers get a copy of the rules in their own ast_manager and differ in their
+       random seed and the order of children. Every worker has its own queue of
+       proof obligations and its own solver pools.
+
+       Workers publish their lemmas to a lemma store and import the lemmas of the
+       other workers between proof obligations. A worker that proves the query
+       unreachable publishes its inductive invariant at the infinite level, so the
+       context completes the proof right after importing it. Reach facts are not
+       shared, counterexamples are always found by the context.
+    */
+    class parallel {
+        context &                 m_ctx;
+        datalog::rule_set const & m_rules;
+        func_decl *               m_query;
+    public:
+        parallel(context & ctx, datalog::rule_set const & rules, func_decl * query):
+            m_ctx(ctx), m_rules(rules), m_query(query) {}
+
+        lbool operator()(unsigned from_lvl);
+    };
+
+}
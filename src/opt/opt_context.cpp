@@ -45,6 +45,12 @@ Notes:
 #include "opt/opt_context.h"
 #include "opt/opt_solver.h"
 #include "opt/opt_params.hpp"
+#ifndef SINGLE_THREAD
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "ast/ast_translation.h"
+#endif
 
 
 namespace opt {
@@ -343,7 +349,7 @@ namespace opt {
                 is_sat = execute_pareto();
             }
             else if (pri == symbol("box")) {
-                is_sat = execute_box();
+                is_sat = optp.objective_threads() > 1 ? execute_box_parallel(asms) : execute_box();
             }
             else {
                 is_sat = execute_lex();
@@ -529,6 +535,182 @@ namespace opt {
         return r;
     }
 
+    /**
+       \brief Optimize the box objectives on several threads.
+
+       Each objective is optimized by a fresh context over a copy of the
+       hard constraints in the manager of a worker. Workers take the next
+       objective until all objectives are done. The models found by any
+       worker bound all minimize and maximize objectives, so a worker
+       starts an objective from the best value known for it.
+    */
+    lbool context::execute_box_parallel(expr_ref_vector const& asms) {
+#ifdef SINGLE_THREAD
+        return execute_box();
+#else
+        vector<objective> const& objectives = m_scoped_state.m_objectives;
+        unsigned num_objectives = objectives.size();
+        unsigned num_threads = std::min(opt_params(m_params).objective_threads(), num_objectives);
+        if (m.has_trace_stream())
+            throw default_exception("trace streams have to be off in parallel mode");
+
+        expr_ref_vector hard(m);
+        hard.append(m_scoped_state.m_hard);
+        hard.append(asms);
+        params_ref p(m_params);
+        p.set_uint("objective_threads", 1);
+        p.set_sym("priority", symbol("lex"));
+
+        // the main manager and the shared bounds are guarded by mux.
+        std::mutex             mux;
+        std::atomic<unsigned>  next(0);
+        vector<rational>       best(num_objectives);
+        bool_vector            has_best(num_objectives, false);
+        vector<inf_eps>        lower(num_objectives), upper(num_objectives);
+        sref_vector<model>     models;
+        svector<lbool>         results(num_objectives, l_undef);
+        std::string            ex_msg;
+        for (unsigned i = 0; i < num_objectives; ++i)
+            models.push_back(nullptr);
+
+        // the caches of the translations hold references into the main
+        // manager, so they are created and released outside of the workers.
+        scoped_ptr_vector<ast_manager> managers;
+        scoped_ptr_vector<ast_translation> to_workers, to_mains;
+        scoped_limits sl(m.limit());
+        for (unsigned i = 0; i < num_threads; ++i) {
+            managers.push_back(alloc(ast_manager, m, true));
+            sl.push_child(&managers.back()->limit());
+            to_workers.push_back(alloc(ast_translation, m, *managers.back()));
+            to_mains.push_back(alloc(ast_translation, *managers.back(), m));
+        }
+
+        auto optimize_objectives = [&](unsigned id) {
+            ast_manager& wm = *managers[id];
+            arith_util a(wm);
+            bv_util bv(wm);
+            ast_translation& to_worker = *to_workers[id], & to_main = *to_mains[id];
+            expr_ref_vector w_hard(wm), w_terms(wm);
+            {
+                std::lock_guard<std::mutex> lock(mux);
+                for (expr* f : hard)
+                    w_hard.push_back(to_worker(f));
+                for (objective const& obj : objectives)
+                    w_terms.push_back(obj.m_type == O_MAXSMT ? nullptr : to_worker(obj.m_term.get()));
+            }
+
+            // publish the values of the objectives in a model.
+            std::function<void(on_model_t&, model_ref&)> on_model = [&](on_model_t&, model_ref& mdl) {
+                rational v;
+                unsigned sz;
+                std::lock_guard<std::mutex> lock(mux);
+                for (unsigned k = 0; k < num_objectives; ++k) {
+                    if (!w_terms.get(k))
+                        continue;
+                    expr_ref val = (*mdl)(w_terms.get(k));
+                    if (!a.is_numeral(val, v) && !bv.is_numeral(val, v, sz))
+                        continue;
+                    bool is_max = objectives[k].m_type == O_MAXIMIZE;
+                    if (!has_best[k] || (is_max ? v > best[k] : v < best[k])) {
+                        best[k] = v;
+                        has_best[k] = true;
+                    }
+                }
+            };
+
+            unsigned i;
+            while ((i = next++) < num_objectives && wm.inc()) {
+                objective const& obj = objectives[i];
+                context sub(wm);
+                sub.updt_params(p);
+                on_model_t ctx = { nullptr, nullptr, nullptr, nullptr };
+                sub.register_on_model(ctx, on_model);
+                for (expr* f : w_hard)
+                    sub.add_hard_constraint(f);
+                if (obj.m_type == O_MAXSMT) {
+                    std::lock_guard<std::mutex> lock(mux);
+                    for (unsigned j = 0; j < obj.m_terms.size(); ++j)
+                        sub.add_soft_constraint(to_worker(obj.m_terms.get(j)), obj.m_weights[j], obj.m_id);
+                }
+                else {
+                    app* t = to_app(w_terms.get(i));
+                    bool is_max = obj.m_type == O_MAXIMIZE;
+                    sub.add_objective(t, is_max);
+                    expr_ref bound(wm);
+                    {
+                        std::lock_guard<std::mutex> lock(mux);
+                        if (has_best[i]) {
+                            if (bv.is_bv(t)) {
+                                expr_ref k(bv.mk_numeral(best[i], t->get_sort()), wm);
+                                bound = is_max ? bv.mk_ule(k, t) : bv.mk_ule(t, k);
+                            }
+                            else {
+                                expr_ref k(a.mk_numeral(best[i], t->get_sort()), wm);
+                                bound = is_max ? a.mk_ge(t, k) : a.mk_le(t, k);
+                            }
+                        }
+                    }
+                    // the bound is attained by a model, so the optimum is unchanged.
+                    if (bound)
+                        sub.add_hard_constraint(bound);
+                }
+                lbool r = sub.optimize(expr_ref_vector(wm));
+                model_ref mdl;
+                if (r == l_true)
+                    sub.get_model(mdl);
+                IF_VERBOSE(2, verbose_stream() << "(opt.box :objective " << i << " :worker " << id << " :result " << r << ")\n";);
+                std::lock_guard<std::mutex> lock(mux);
+                results[i] = r;
+                if (r == l_true && mdl) {
+                    models.set(i, mdl->translate(to_main));
+                    lower[i] = sub.get_lower_as_num(0);
+                    upper[i] = sub.get_upper_as_num(0);
+                }
+            }
+        };
+
+        vector<std::thread> threads(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) {
+            threads[i] = std::thread([&, i]() {
+                try {
+                    optimize_objectives(i);
+                }
+                catch (z3_exception& ex) {
+                    std::lock_guard<std::mutex> lock(mux);
+                    if (ex_msg.empty())
+                        ex_msg = ex.msg();
+                    for (ast_manager* wm : managers)
+                        wm->limit().cancel();
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+
+        if (!ex_msg.empty() && m.inc())
+            throw default_exception(std::move(ex_msg));
+
+        lbool r = l_true;
+        for (unsigned i = 0; r == l_true && i < num_objectives; ++i)
+            if (results[i] != l_true || !models.get(i))
+                r = results[i] == l_false ? l_false : l_undef;
+
+        m_box_index = 1;
+        m_box_models.reset();
+        if (r == l_true) {
+            for (model* mdl : models) {
+                // the models are already in terms of the original constraints.
+                m_model_fixed.push_back(mdl);
+                m_box_models.push_back(mdl);
+            }
+            m_box_lower.swap(lower);
+            m_box_upper.swap(upper);
+            m_model = m_box_models[0];
+        }
+        return r;
+#endif
+    }
+
     expr_ref context::mk_le(unsigned i, model_ref& mdl) {
         objective const& obj = m_objectives[i];
         return mk_cmp(false, mdl, obj);
@@ -618,7 +800,11 @@ namespace opt {
 
     lbool context::execute_pareto() {        
         if (!m_pareto) {
-            set_pareto(alloc(gia_pareto, m, *this, m_solver.get(), m_params));
+            unsigned num_threads = opt_params(m_params).objective_threads();
+            if (num_threads > 1)
+                set_pareto(alloc(parallel_pareto, m, *this, m_solver.get(), m_params, num_threads));
+            else
+                set_pareto(alloc(gia_pareto, m, *this, m_solver.get(), m_params));
         }
         lbool is_sat = (*(m_pareto.get()))();
         if (is_sat != l_true) {
@@ -1402,6 +1588,9 @@ namespace opt {
         if (idx >= m_objectives.size()) {
             throw default_exception("index out of bounds"); 
         }
+        if (idx < m_box_lower.size()) {
+            return m_box_lower[idx];
+        }
         objective const& obj = m_objectives[idx];
         switch(obj.m_type) {
         case O_MAXSMT: 
@@ -1420,6 +1609,9 @@ namespace opt {
         if (idx >= m_objectives.size()) {
             throw default_exception("index out of bounds"); 
         }
+        if (idx < m_box_upper.size()) {
+            return m_box_upper[idx];
+        }
         objective const& obj = m_objectives[idx];
         switch(obj.m_type) {
         case O_MAXSMT: 
@@ -1494,6 +1686,8 @@ namespace opt {
         m_pareto1 = false;
         m_box_index = UINT_MAX;
         m_box_models.reset();
+        m_box_lower.reset();
+        m_box_upper.reset();
         m_model.reset();
         m_model_fixed.reset();
         m_core.reset();
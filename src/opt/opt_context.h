@@ -164,6 +164,8 @@ namespace opt {
         scoped_ptr<qe::qmax> m_qmax;
         sref_vector<model>  m_box_models;
         unsigned            m_box_index;
+        vector<inf_eps>     m_box_lower;     // bounds of the objectives found by parallel box optimization
+        vector<inf_eps>     m_box_upper;
         params_ref          m_params;
         optsmt              m_optsmt; 
         map_t               m_maxsmts;
@@ -267,6 +269,7 @@ namespace opt {
         lbool execute_maxsat(symbol const& s, bool committed, bool scoped);
         lbool execute_lex();
         lbool execute_box();
+        lbool execute_box_parallel(expr_ref_vector const& asms);
         lbool execute_pareto();
         lbool adjust_unknown(lbool r);
         bool scoped_lex();
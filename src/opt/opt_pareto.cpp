@@ -22,6 +22,14 @@ Notes:
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
 #include "model/model_smt2_pp.h"
+#include "smt/smt_solver.h"
+#ifndef SINGLE_THREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "util/scoped_ptr_vector.h"
+#include "ast/ast_translation.h"
+#endif
 
 namespace opt {
 
@@ -63,29 +71,35 @@ namespace opt {
         return is_sat;
     }
 
-    void pareto_base::mk_dominates() {
+    expr_ref pareto_base::dominates(model_ref& mdl) {
         unsigned sz = cb.num_objectives();
-        expr_ref fml(m);
         expr_ref_vector gt(m), fmls(m);
         for (unsigned i = 0; i < sz; ++i) {
-            fmls.push_back(cb.mk_ge(i, m_model));
-            gt.push_back(cb.mk_gt(i, m_model));
+            fmls.push_back(cb.mk_ge(i, mdl));
+            gt.push_back(cb.mk_gt(i, mdl));
         }
         fmls.push_back(mk_or(gt));
-        fml = mk_and(fmls);
-        IF_VERBOSE(10, verbose_stream() << "dominates: " << fml << "\n";);
-        TRACE("opt", model_smt2_pp(tout << fml << "\n", m, *m_model, 0););
-        m_solver->assert_expr(fml);        
+        return mk_and(fmls);
     }
 
-    void pareto_base::mk_not_dominated_by() {
+    expr_ref pareto_base::not_dominated_by(model_ref& mdl) {
         unsigned sz = cb.num_objectives();
-        expr_ref fml(m);
         expr_ref_vector le(m);
         for (unsigned i = 0; i < sz; ++i) {
-            le.push_back(cb.mk_le(i, m_model));
+            le.push_back(cb.mk_le(i, mdl));
         }
-        fml = m.mk_not(mk_and(le));
+        return expr_ref(m.mk_not(mk_and(le)), m);
+    }
+
+    void pareto_base::mk_dominates() {
+        expr_ref fml = dominates(m_model);
+        IF_VERBOSE(10, verbose_stream() << "dominates: " << fml << "\n";);
+        TRACE("opt", model_smt2_pp(tout << fml << "\n", m, *m_model, 0););
+        m_solver->assert_expr(fml);        
+    }
+
+    void pareto_base::mk_not_dominated_by() {
+        expr_ref fml = not_dominated_by(m_model);
         IF_VERBOSE(10, verbose_stream() << "not dominated by: " << fml << "\n";);
         TRACE("opt", tout << fml << "\n";);
         m_solver->assert_expr(fml);        
@@ -109,5 +123,209 @@ namespace opt {
         return is_sat;
     }
 
-}
+    // ---------------------------------
+    // Pareto front with several workers
+
+    lbool parallel_pareto::operator()() {
+        if (!m_computed) {
+            m_computed = true;
+            lbool r = compute_front();
+            if (r != l_true) {
+                return r;
+            }
+        }
+        if (m_next >= m_front.size()) {
+            return l_false;
+        }
+        m_model = m_front.get(m_next++);
+        m_labels.reset();
+        return l_true;
+    }
+
+#ifdef SINGLE_THREAD
 
+    lbool parallel_pareto::compute_front() {
+        gia_pareto gia(m, cb, m_solver.get(), m_params);
+        lbool r;
+        while ((r = gia()) == l_true) {
+            model_ref mdl;
+            svector<symbol> labels;
+            gia.get_model(mdl, labels);
+            m_front.push_back(mdl.get());
+        }
+        return r == l_false && !m_front.empty() ? l_true : r;
+    }
+
+#else
+
+    lbool parallel_pareto::compute_front() {
+        unsigned sz = cb.num_objectives();
+        if (m.has_trace_stream())
+            throw default_exception("trace streams have to be off in parallel mode");
+
+        // the main manager, the regions and the points are shared and
+        // guarded by mux. The main thread waits for the workers.
+        std::mutex              mux;
+        std::condition_variable cv;
+        expr_ref_vector         regions(m);
+        sref_vector<model>      points;
+        unsigned                num_active = 0;
+        bool                    done = false;
+        lbool                   result = l_true;
+        std::string             ex_msg;
+        regions.push_back(m.mk_true());
+
+        expr_ref_vector assertions(m);
+        m_solver->get_assertions(assertions);
+        // the references of a worker into the main manager. They are only
+        // updated under mux and released after the workers are joined.
+        struct worker_state {
+            ast_translation to_worker, to_main;
+            expr_ref        region;
+            model_ref       mdl;
+            worker_state(ast_manager& m, ast_manager& wm): to_worker(m, wm), to_main(wm, m), region(m) {}
+        };
+
+        scoped_ptr_vector<ast_manager> managers;
+        scoped_ptr_vector<worker_state> states;
+        scoped_limits sl(m.limit());
+        sref_vector<solver> solvers;
+        for (unsigned i = 0; i < m_num_threads; ++i) {
+            ast_manager* wm = alloc(ast_manager, m, true);
+            managers.push_back(wm);
+            sl.push_child(&wm->limit());
+            worker_state* st = alloc(worker_state, m, *wm);
+            states.push_back(st);
+            solver* s = mk_smt_solver(*wm, m_params, symbol::null);
+            for (expr* f : assertions)
+                s->assert_expr(st->to_worker(f));
+            solvers.push_back(s);
+        }
+
+        auto cancel = [&]() {
+            done = true;
+            for (ast_manager* wm : managers)
+                wm->limit().cancel();
+            cv.notify_all();
+        };
+
+        auto explore = [&](unsigned id) {
+            ast_manager& wm = *managers[id];
+            solver& s = *solvers.get(id);
+            worker_state& st = *states[id];
+            ast_translation& to_worker = st.to_worker, & to_main = st.to_main;
+            expr_ref& region = st.region;
+            model_ref& mdl = st.mdl;
+            unsigned num_shared = 0;
+            while (true) {
+                expr_ref w_region(wm);
+                expr_ref_vector shared(wm);
+                {
+                    std::unique_lock<std::mutex> lock(mux);
+                    cv.wait(lock, [&]() { return done || !regions.empty() || num_active == 0; });
+                    if (done || regions.empty())
+                        return;
+                    region = regions.back();
+                    regions.pop_back();
+                    w_region = to_worker(region.get());
+                    for (; num_shared < points.size(); ++num_shared) {
+                        model_ref p = points.get(num_shared);
+                        shared.push_back(to_worker(not_dominated_by(p).get()));
+                    }
+                    ++num_active;
+                }
+
+                // solutions dominated by a point are never Pareto optimal.
+                s.assert_expr(shared);
+                solver::scoped_push _region(s);
+                s.assert_expr(w_region);
+                model_ref w_mdl;
+                lbool r = s.check_sat(0, nullptr);
+                // the dominance constraints of the climb are scoped by the region.
+                if (r == l_true) {
+                    while (r == l_true) {
+                        s.get_model(w_mdl);
+                        if (!w_mdl) {
+                            r = l_undef;
+                            break;
+                        }
+                        expr_ref dom(wm);
+                        {
+                            std::lock_guard<std::mutex> lock(mux);
+                            mdl = w_mdl->translate(to_main);
+                            mdl->set_model_completion(true);
+                            dom = to_worker(dominates(mdl).get());
+                        }
+                        s.assert_expr(dom);
+                        r = s.check_sat(0, nullptr);
+                    }
+                    if (r == l_false)
+                        r = l_true;
+                }
+
+                std::lock_guard<std::mutex> lock(mux);
+                --num_active;
+                if (r == l_undef) {
+                    result = l_undef;
+                    cancel();
+                    return;
+                }
+                if (r == l_true) {
+                    IF_VERBOSE(2, verbose_stream() << "(opt.pareto :worker " << id << " :points " << points.size() + 1
+                               << " :regions " << regions.size() + sz << ")\n";);
+                    points.push_back(mdl.get());
+                    expr_ref_vector le(m);
+                    for (unsigned i = 0; i < sz; ++i) {
+                        expr_ref_vector conj(le);
+                        conj.push_back(region);
+                        conj.push_back(cb.mk_gt(i, mdl));
+                        regions.push_back(mk_and(conj));
+                        le.push_back(cb.mk_le(i, mdl));
+                    }
+                }
+                cv.notify_all();
+            }
+        };
+
+        vector<std::thread> threads(m_num_threads);
+        for (unsigned i = 0; i < m_num_threads; ++i) {
+            threads[i] = std::thread([&, i]() {
+                try {
+                    explore(i);
+                }
+                catch (z3_exception& ex) {
+                    std::lock_guard<std::mutex> lock(mux);
+                    if (ex_msg.empty())
+                        ex_msg = ex.msg();
+                    cancel();
+                }
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+
+        if (!ex_msg.empty() && m.inc())
+            throw default_exception(std::move(ex_msg));
+        if (!m.inc() || result == l_undef || !ex_msg.empty())
+            return l_undef;
+
+        // keep the points that are not dominated by points of other regions.
+        for (model* p : points) {
+            model_ref mdl(p);
+            expr_ref dom = dominates(mdl);
+            bool is_dominated = false;
+            for (model* q : points)
+                if (q != p && q->is_true(dom)) {
+                    is_dominated = true;
+                    break;
+                }
+            if (!is_dominated)
+                m_front.push_back(p);
+        }
+        IF_VERBOSE(1, verbose_stream() << "(opt.pareto :points " << points.size() << " :front " << m_front.size() << ")\n";);
+        return m_front.empty() ? l_false : l_true;
+    }
+
+#endif
+
+}
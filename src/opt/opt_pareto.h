@@ -77,6 +77,12 @@ namespace opt {
         void mk_dominates();
 
         void mk_not_dominated_by();            
+
+        // objectives of mdl are dominated by the solution
+        expr_ref dominates(model_ref& mdl);
+
+        // solution is not dominated by the objectives of mdl
+        expr_ref not_dominated_by(model_ref& mdl);
     };
     class gia_pareto : public pareto_base {
     public:
@@ -104,5 +110,44 @@ namespace opt {
 
         lbool operator()() override;
     };
+
+    /**
+       \brief Pareto front enumeration with several workers.
+
+       The objective space is partitioned into regions that workers explore
+       on their own copy of the solver. A worker climbs to a point p that is
+       Pareto optimal within its region R, and splits the part of R that is
+       not dominated by p into the disjoint regions
+
+           R & obj_0 <= p_0 & ... & obj_{i-1} <= p_{i-1} & obj_i > p_i
+
+       for every objective i. Workers share their points: a worker excludes
+       the solutions dominated by the points of the other workers before it
+       explores a region. Points that are only optimal within their region
+       are removed when all regions are explored.
+
+       The first call computes the front, the following calls return one
+       point of the front each.
+    */
+    class parallel_pareto : public pareto_base {
+        unsigned           m_num_threads;
+        sref_vector<model> m_front;
+        unsigned           m_next { 0 };
+        bool               m_computed { false };
+
+        lbool compute_front();
+    public:
+        parallel_pareto(ast_manager & m, 
+                        pareto_callback& cb, 
+                        solver* s, 
+                        params_ref & p,
+                        unsigned num_threads):
+            pareto_base(m, cb, s, p),
+            m_num_threads(num_threads) {
+        }
+        ~parallel_pareto() override {}
+
+        lbool operator()() override;
+    };
 }
 
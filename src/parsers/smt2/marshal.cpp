@@ -8,6 +8,10 @@ Abstract:
 
    marshaling and unmarshaling of expressions
 
+   Expressions are marshaled in the binary format of ast_serialize,
+   which preserves sharing. Legacy SMT2 text is still accepted by
+   unmarshal.
+
    --*/
 #include "parsers/smt2/marshal.h"
 
@@ -15,29 +19,34 @@ Abstract:
 
 #include "cmd_context/cmd_context.h"
 #include "parsers/smt2/smt2parser.h"
-#include "util/vector.h"
 #include "ast/ast_smt_pp.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
+#include "ast/ast_serialize.h"
 
 std::ostream &marshal(std::ostream &os, expr_ref e, ast_manager &m) {
-    ast_smt_pp pp(m);
-    pp.display_smt2(os, e);
+    std::string s = marshal(e, m);
+    os.write(s.data(), s.size());
     return os;
 }
 
 std::string marshal(expr_ref e, ast_manager &m) {
-    std::stringstream ss;
-    marshal(ss, e, m);
-    return ss.str();
+    std::string r;
+    ast_serialize(m, e, r);
+    return r;
 }
 
+std::ostream &marshal_smt2(std::ostream &os, expr_ref e, ast_manager &m) {
+    ast_smt_pp pp(m);
+    pp.display_smt2(os, e);
+    return os;
+}
 
-expr_ref unmarshal(std::istream &is, ast_manager &m) {
+static expr_ref unmarshal_smt2(std::istream &is, ast_manager &m) {
     cmd_context ctx(false, &m);
     ctx.set_ignore_check(true);
-    if (!parse_smt2_commands(ctx, is)) { 
-        return expr_ref(nullptr, m); 
+    if (!parse_smt2_commands(ctx, is)) {
+        return expr_ref(nullptr, m);
     }
 
     ptr_vector<expr>::const_iterator it  = ctx.assertions().begin();
@@ -45,7 +54,14 @@ expr_ref unmarshal(std::istream &is, ast_manager &m) {
     return expr_ref(mk_and(m, size, it), m);
 }
 
+expr_ref unmarshal(std::istream &is, ast_manager &m) {
+    std::string s((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    return unmarshal(std::move(s), m);
+}
+
 expr_ref unmarshal(std::string s, ast_manager &m) {
+    if (is_ast_serialization(s.data(), s.size()))
+        return ast_deserialize(m, s.data(), s.size());
     std::istringstream is(s);
-    return unmarshal(is, m);
+    return unmarshal_smt2(is, m);
 }
@@ -8,6 +8,11 @@ Abstract:
 
    marshaling and unmarshaling of expressions
 
+   marshal produces a compact binary encoding that preserves
+   sharing in the expression DAG. unmarshal accepts both the binary
+   encoding and (legacy) SMT2 text as produced by marshal_smt2.
+   It returns a null expression if the input is malformed.
+
    --*/
 #pragma once
 
@@ -18,6 +23,7 @@ Abstract:
 
 std::ostream &marshal(std::ostream &os, expr_ref e, ast_manager &m);
 std::string marshal(expr_ref e, ast_manager &m);
+std::ostream &marshal_smt2(std::ostream &os, expr_ref e, ast_manager &m);
 expr_ref unmarshal(std::string s, ast_manager &m);
 expr_ref unmarshal(std::istream &is, ast_manager &m);
 
@@ -46,6 +46,10 @@ static void skip_line(Buffer & in) {
     } 
 }
 
+static void skip_line(dimacs::mapped_buffer & in) {
+    in.skip_line();
+}
+
 template<typename Buffer>
 static int parse_int(Buffer & in, std::ostream& err) {
     int     val = 0;
@@ -142,6 +146,11 @@ bool parse_dimacs(std::istream & in, std::ostream& err, sat::solver & solver) {
     return parse_dimacs_core(_in, err, solver);
 }
 
+bool parse_dimacs(mapped_file & f, std::ostream& err, sat::solver & solver) {
+    dimacs::mapped_buffer in(f);
+    return parse_dimacs_core(in, err, solver);
+}
+
 
 namespace dimacs {
 
@@ -22,9 +22,13 @@ Revision History:
 #pragma once
 
 #include "sat/sat_types.h"
+#include <cstring>
+#include "util/mapped_file.h"
 
 bool parse_dimacs(std::istream & s, std::ostream& err, sat::solver & solver);
 
+bool parse_dimacs(mapped_file & f, std::ostream& err, sat::solver & solver);
+
 namespace dimacs {
     struct lex_error {};
 
@@ -52,6 +56,51 @@ namespace dimacs {
         unsigned line() const { return m_line; }
     };
 
+    /**
+       \brief Buffer over the windows of a memory mapped file.
+       Characters are read directly from the mapping.
+    */
+    class mapped_buffer {
+        mapped_file &  m_file;
+        char const *   m_curr { nullptr };
+        char const *   m_end { nullptr };
+        unsigned       m_line { 0 };
+
+        // m_curr == m_end only at the end of the file.
+        void next_window() {
+            if (!m_file.next(m_curr, m_end)) 
+                m_curr = m_end = nullptr;
+        }
+
+    public:
+        mapped_buffer(mapped_file & f): m_file(f) {
+            next_window();
+        }
+
+        int operator *() const {
+            return m_curr == m_end ? EOF : static_cast<unsigned char>(*m_curr);
+        }
+
+        void operator ++() {
+            if (*m_curr == '\n') ++m_line;
+            if (++m_curr == m_end) next_window();
+        }
+
+        void skip_line() {
+            while (m_curr != m_end) {
+                char const * nl = static_cast<char const *>(memchr(m_curr, '\n', m_end - m_curr));
+                if (nl) {
+                    m_curr = nl;
+                    ++(*this);
+                    return;
+                }
+                next_window();
+            }
+        }
+
+        unsigned line() const { return m_line; }
+    };
+
     struct drat_record {
         enum class tag_t { is_clause, is_node, is_decl, is_sort, is_bool_def };
         tag_t            m_tag{ tag_t::is_clause };
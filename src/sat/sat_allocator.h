@@ -26,6 +26,7 @@ class sat_allocator {
     static const unsigned SMALL_OBJ_SIZE = 512;
     static const unsigned MASK = ((1 << PTR_ALIGNMENT) - 1);
     static const unsigned NUM_FREE = 1 + (SMALL_OBJ_SIZE >> PTR_ALIGNMENT);
+    static const unsigned CACHE_LINE_SIZE = 64;
     struct chunk {
         char  * m_curr;
         char    m_data[CHUNK_SIZE];
@@ -43,6 +44,15 @@ class sat_allocator {
     unsigned free_slot_id(size_t size) const {
         return (static_cast<unsigned>(size >> PTR_ALIGNMENT) + ((0 != (size & MASK)) ? 1u : 0u));
     }
+    // number of bytes to skip such that [m_chunk_ptr + padding, m_chunk_ptr + padding + hot_size) 
+    // does not straddle a cache line.
+    unsigned line_padding(unsigned hot_size) const {
+        size_t addr = reinterpret_cast<size_t>(m_chunk_ptr);
+        size_t offset = addr & (CACHE_LINE_SIZE - 1);
+        if (hot_size > CACHE_LINE_SIZE || offset + hot_size <= CACHE_LINE_SIZE)
+            return 0;
+        return static_cast<unsigned>(CACHE_LINE_SIZE - offset);
+    }
 public:
     sat_allocator(char const * id = "unknown"): m_id(id), m_alloc_size(0), m_chunk_ptr(nullptr) {}
     ~sat_allocator() { reset(); }
@@ -79,6 +89,33 @@ public:
         return result;
     }
 
+    /**
+       \brief Allocate at the end of the current chunk, bypassing the free lists,
+       such that the first hot_size bytes of the object share a cache line.
+       Objects allocated in sequence are laid out contiguously. It is used when
+       objects are relocated for locality.
+    */
+    void * allocate_packed(size_t size, unsigned hot_size) {
+        if (size >= SMALL_OBJ_SIZE) {
+            return allocate(size);
+        }
+        m_alloc_size += size;
+        unsigned sz = align_size(size);
+        if (m_chunks.empty()) {
+            m_chunks.push_back(alloc(chunk));
+            m_chunk_ptr = m_chunks.back();
+        }
+        unsigned padding = line_padding(hot_size);
+        if ((char*)m_chunk_ptr + padding + sz > (char*)m_chunks.back() + CHUNK_SIZE) {
+            m_chunks.push_back(alloc(chunk));
+            m_chunk_ptr = m_chunks.back();
+            padding = line_padding(hot_size);
+        }
+        void * result = (char*)m_chunk_ptr + padding;
+        m_chunk_ptr = (char*)result + sz;
+        return result;
+    }
+
     void deallocate(size_t size, void * p) {
         m_alloc_size -= size;
         if (size >= SMALL_OBJ_SIZE) {
@@ -25,8 +25,8 @@ namespace sat {
 
     clause::clause(unsigned id, unsigned sz, literal const * lits, bool learned):
         m_id(id),
-        m_size(sz),
         m_capacity(sz),
+        m_size(sz),
         m_removed(false),
         m_learned(learned),
         m_used(false),
@@ -185,7 +185,7 @@ namespace sat {
 
     clause * clause_allocator::copy_clause(clause const& other) {
         size_t size = clause::get_obj_size(other.size());
-        void * mem = m_allocator.allocate(size);
+        void * mem = m_allocator.allocate_packed(size, clause::get_hot_size());
         clause * cls = new (mem) clause(m_id_gen.mk(), other.size(), other.m_lits, other.is_learned());
         cls->m_reinit_stack = other.on_reinit_stack();
         cls->m_glue   = other.glue();
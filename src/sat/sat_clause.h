@@ -40,10 +40,12 @@ namespace sat {
     class clause {
         friend class clause_allocator;
         friend class tmp_clause;
+        // cold fields are stored first, so that the fields used during 
+        // propagation are adjacent to the literals.
         unsigned           m_id;
-        unsigned           m_size;
         unsigned           m_capacity;
         var_approx_set     m_approx;
+        unsigned           m_size;
         unsigned           m_strengthened:1;
         unsigned           m_removed:1;
         unsigned           m_learned:1;
@@ -56,6 +58,8 @@ namespace sat {
         literal            m_lits[0];
 
         static size_t get_obj_size(unsigned num_lits) { return sizeof(clause) + num_lits * sizeof(literal); }
+        // prefix of the clause accessed when visiting a watch: header and the two watched literals.
+        static unsigned get_hot_size() { return static_cast<unsigned>(get_obj_size(2)); }
         size_t get_size() const { return get_obj_size(m_capacity); }
         clause(unsigned id, unsigned sz, literal const * lits, bool learned);
     public:
@@ -22,70 +22,114 @@ Revision History:
 
 namespace sat {
 
-    void parallel::vector_pool::next(unsigned& index) {
-        SASSERT(index < m_size);
-        unsigned n = index + 2 + get_length(index);
-        if (n >= m_size) {
-            index = 0;
-        }
-        else {
-            index = n;
-        }
+    void shared_clause_pool::finalize() {
+        if (m_slots)
+            dealloc_vect(m_slots, m_num_slots);
+        if (m_hashes)
+            dealloc_vect(m_hashes, m_num_hashes);
+        m_slots = nullptr;
+        m_hashes = nullptr;
+        m_num_slots = 0;
+        m_num_hashes = 0;
     }
 
-    void parallel::vector_pool::reserve(unsigned num_threads, unsigned sz) {
-        m_vectors.reset();
-        m_vectors.resize(sz, 0);
-        m_heads.reset();
-        m_heads.resize(num_threads, 0);
-        m_at_end.reset();
-        m_at_end.resize(num_threads, true);
-        m_tail = 0;
-        m_size = sz;
-    }
-    
-    void parallel::vector_pool::begin_add_vector(unsigned owner, unsigned n) {
-        SASSERT(m_tail < m_size);
-        unsigned capacity = n + 2;
-        m_vectors.reserve(m_size + capacity, 0);
-        IF_VERBOSE(3, verbose_stream() << owner << ": begin-add " << n << " tail: " << m_tail << " size: " << m_size << "\n";);
-        for (unsigned i = 0; i < m_heads.size(); ++i) {
-            while (m_tail < m_heads[i] && m_heads[i] < m_tail + capacity) {
-                next(m_heads[i]);
-            }
-            m_at_end[i] = false;
+    void shared_clause_pool::reserve(unsigned num_owners, unsigned sz) {
+        finalize();
+        m_num_slots = 1;
+        while (m_num_slots < sz)
+            m_num_slots *= 2;
+        m_num_hashes = 4 * m_num_slots;
+        m_slots = alloc_vect<slot>(m_num_slots);
+        m_hashes = alloc_vect<std::atomic<uint64_t>>(m_num_hashes);
+        for (unsigned i = 0; i < m_num_slots; ++i) {
+            m_slots[i].m_seq = 0;
+            m_slots[i].m_owner = 0;
+            m_slots[i].m_size = 0;
         }
-        m_vectors[m_tail++] = owner;
-        m_vectors[m_tail++] = n;    
+        for (unsigned i = 0; i < m_num_hashes; ++i)
+            m_hashes[i] = 0;
+        m_tail = 0;
+        cursor c;
+        c.m_head = 0;
+        m_cursors.reset();
+        m_cursors.resize(num_owners, c);
+        m_num_added = 0;
+        m_num_duplicates = 0;
     }
 
-    void parallel::vector_pool::add_vector_elem(unsigned e) {
-        m_vectors[m_tail++] = e;
+    // hash of the set of literals, independent of their order.
+    uint64_t shared_clause_pool::hash(unsigned n, literal const* lits) {
+        uint64_t h = n;
+        for (unsigned i = 0; i < n; ++i) {
+            uint64_t x = lits[i].index() + 0x9e3779b97f4a7c15ull;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            h += x ^ (x >> 31);
+        }
+        return h | 1;
     }
 
-    void parallel::vector_pool::end_add_vector() {
-        if (m_tail >= m_size) {
-            m_tail = 0;
+    bool shared_clause_pool::add(unsigned owner, unsigned n, literal const* lits) {
+        SASSERT(m_num_slots > 0);
+        if (n > max_clause_size)
+            return false;
+        uint64_t h = hash(n, lits);
+        if (m_hashes[h & (m_num_hashes - 1)].exchange(h, std::memory_order_relaxed) == h) {
+            ++m_num_duplicates;
+            return false;
         }
+        ++m_num_added;
+        uint64_t ticket = m_tail.fetch_add(1, std::memory_order_relaxed);
+        slot& s = m_slots[ticket & (m_num_slots - 1)];
+        uint64_t writing = 2 * ticket + 1;
+        uint64_t seq = s.m_seq.load(std::memory_order_relaxed);
+        while (true) {
+            if (seq >= writing) 
+                // a producer that came later has taken the slot.
+                return true;
+            if (seq % 2 == 1) 
+                // wait for a producer one round ahead to finish.
+                seq = s.m_seq.load(std::memory_order_relaxed);
+            else if (s.m_seq.compare_exchange_weak(seq, writing, std::memory_order_acquire))
+                break;
+        }
+        s.m_owner.store(owner, std::memory_order_relaxed);
+        s.m_size.store(n, std::memory_order_relaxed);
+        for (unsigned i = 0; i < n; ++i)
+            s.m_lits[i].store(lits[i].index(), std::memory_order_relaxed);
+        s.m_seq.store(writing + 1, std::memory_order_release);
+        return true;
     }
 
-
-    bool parallel::vector_pool::get_vector(unsigned owner, unsigned& n, unsigned const*& ptr) {
-        unsigned head = m_heads[owner];      
-        unsigned iterations = 0;
-        while (head != m_tail || !m_at_end[owner]) {
-            ++iterations;
-            SASSERT(head < m_size && m_tail < m_size);            
-            bool is_self = owner == get_owner(head);
-            next(m_heads[owner]);
-            IF_VERBOSE(static_cast<unsigned>(iterations > m_size ? 0 : 3), verbose_stream() << owner << ": [" << head << ":" << m_heads[owner] << "] tail: " << m_tail << "\n";);
-            m_at_end[owner] = (m_heads[owner] == m_tail);
-            if (!is_self) {
-                n = get_length(head);
-                ptr = get_ptr(head);
-                return true;
-            }
-            head = m_heads[owner];
+    bool shared_clause_pool::get(unsigned owner, literal_vector& lits) {
+        uint64_t& head = m_cursors[owner].m_head;
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        if (tail > head + m_num_slots) {
+            IF_VERBOSE(3, verbose_stream() << owner << ": skipped " << (tail - head - m_num_slots) << " shared clauses\n";);
+            head = tail - m_num_slots;
+        }
+        for (; head < tail; ++head) {
+            slot& s = m_slots[head & (m_num_slots - 1)];
+            uint64_t published = 2 * head + 2;
+            uint64_t seq = s.m_seq.load(std::memory_order_acquire);
+            if (seq < published) 
+                // not yet published, resume from here on the next call.
+                return false;
+            if (seq > published) 
+                continue;
+            unsigned slot_owner = s.m_owner.load(std::memory_order_relaxed);
+            unsigned n = std::min(s.m_size.load(std::memory_order_relaxed), max_clause_size);
+            lits.reset();
+            for (unsigned i = 0; i < n; ++i)
+                lits.push_back(to_literal(s.m_lits[i].load(std::memory_order_relaxed)));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.m_seq.load(std::memory_order_relaxed) != seq) 
+                // overwritten while reading.
+                continue;
+            if (slot_owner == owner)
+                continue;
+            ++head;
+            return true;
         }
         return false;
     }
@@ -93,6 +137,7 @@ namespace sat {
     parallel::parallel(solver& s): m_num_clauses(0), m_consumer_ready(false), m_scoped_rlimit(s.rlimit()) {}
 
     parallel::~parallel() {
+        IF_VERBOSE(2, verbose_stream() << "(sat-parallel :shared " << m_pool.num_added() << " :duplicates " << m_pool.num_duplicates() << ")\n";);
         for (unsigned i = 0; i < m_solvers.size(); ++i) {            
             dealloc(m_solvers[i]);
         }
@@ -147,59 +192,35 @@ namespace sat {
         if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
         IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  l1 << " " << l2 << "\n";);
-        {
-            lock_guard lock(m_mux);
-            m_pool.begin_add_vector(s.m_par_id, 2);
-            m_pool.add_vector_elem(l1.index());
-            m_pool.add_vector_elem(l2.index());            
-            m_pool.end_add_vector();
-        }        
+        literal lits[2] = { l1, l2 };
+        m_pool.add(s.m_par_id, 2, lits);
     }
 
     void parallel::share_clause(solver& s, clause const& c) {        
         if (s.get_config().m_num_threads == 1 || !enable_add(c) || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        unsigned n = c.size();
-        unsigned owner = s.m_par_id;
-        IF_VERBOSE(3, verbose_stream() << owner << ": share " <<  c << "\n";);
-        lock_guard lock(m_mux);
-        m_pool.begin_add_vector(owner, n);                
-        for (unsigned i = 0; i < n; ++i) {
-            m_pool.add_vector_elem(c[i].index());
-        }
-        m_pool.end_add_vector();        
+        IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  c << "\n";);
+        m_pool.add(s.m_par_id, c.size(), c.begin());
     }
 
     void parallel::get_clauses(solver& s) {
         if (s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        lock_guard lock(m_mux);
-        _get_clauses(s);        
-    }
-
-    void parallel::_get_clauses(solver& s) {
-        unsigned n;
-        unsigned const* ptr;
-        unsigned owner = s.m_par_id;
-        while (m_pool.get_vector(owner, n, ptr)) {
-            m_lits.reset();
+        literal_vector lits;
+        while (m_pool.get(s.m_par_id, lits)) {
+            SASSERT(lits.size() >= 2);
+            IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << lits << "\n";);
             bool usable_clause = true;
-            for (unsigned i = 0; usable_clause && i < n; ++i) {
-                literal lit(to_literal(ptr[i]));                
-                m_lits.push_back(lit);
-                usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
-            }
-            IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << m_lits << "\n";);
-            SASSERT(n >= 2);
-            if (usable_clause) {
-                s.mk_clause_core(m_lits.size(), m_lits.data(), sat::status::redundant());
-            }
+            for (unsigned i = 0; usable_clause && i < lits.size(); ++i) 
+                usable_clause = lits[i].var() <= s.m_par_num_vars && !s.was_eliminated(lits[i].var());
+            if (usable_clause) 
+                s.mk_clause_core(lits.size(), lits.data(), sat::status::redundant());
         }        
     }
 
     bool parallel::enable_add(clause const& c) const {
         // plingeling, glucose heuristic:
-        return (c.size() <= 40 && c.glue() <= 8) || c.glue() <= 2;
+        return c.size() <= shared_clause_pool::max_clause_size && c.glue() <= 8;
     }
 
     void parallel::_from_solver(solver& s) {
@@ -24,33 +24,76 @@ Revision History:
 #include "util/rlimit.h"
 #include "util/scoped_ptr_vector.h"
 #include "util/mutex.h"
+#include <atomic>
 
 namespace sat {
 
-    class parallel {
+    /**
+       \brief Pool of learned clauses shared between parallel solvers.
+
+       The pool is a ring buffer of fixed size slots. Producers reserve a
+       slot by incrementing the tail and publish the clause through the
+       sequence number of the slot. Each consumer has its own read cursor
+       and detects slots that were overwritten while it was reading them.
+       No locks are taken. A consumer that falls behind by more than the
+       size of the ring loses the oldest clauses.
 
-        // shared pool of learned clauses.
-        class vector_pool {
-            unsigned_vector m_vectors;
-            unsigned        m_size{ 0 };
-            unsigned        m_tail{ 0 };
-            unsigned_vector m_heads;
-            bool_vector   m_at_end;
-            void next(unsigned& index);
-            unsigned get_owner(unsigned index) const { return m_vectors[index]; }
-            unsigned get_length(unsigned index) const { return m_vectors[index+1]; }
-            unsigned const* get_ptr(unsigned index) const { return m_vectors.data() + index + 2; }
-        public:
-            vector_pool() {}
-            void reserve(unsigned num_owners, unsigned sz);
-            void begin_add_vector(unsigned owner, unsigned n);
-            void end_add_vector();
-            void add_vector_elem(unsigned e);
-            bool get_vector(unsigned owner, unsigned& n, unsigned const*& ptr);
+       Clauses are identified by a hash of their literal set. Recently
+       added clauses with the same hash are not added again.
+    */
+    class shared_clause_pool {
+    public:
+        static const unsigned max_clause_size = 40;
+    private:
+        struct slot {
+            std::atomic<uint64_t> m_seq;    // 2*ticket + 1 while written, 2*ticket + 2 when published
+            std::atomic<unsigned> m_owner;
+            std::atomic<unsigned> m_size;
+            std::atomic<unsigned> m_lits[max_clause_size];
+        };
+        struct cursor {
+            uint64_t m_head;
+            char     m_padding[56];         // keep cursors of different threads on separate cache lines
         };
+        slot*                   m_slots { nullptr };
+        unsigned                m_num_slots { 0 };
+        std::atomic<uint64_t>*  m_hashes { nullptr };
+        unsigned                m_num_hashes { 0 };
+        std::atomic<uint64_t>   m_tail { 0 };
+        svector<cursor>         m_cursors;
+        std::atomic<unsigned>   m_num_added { 0 };
+        std::atomic<unsigned>   m_num_duplicates { 0 };
+
+        static uint64_t hash(unsigned n, literal const* lits);
+        void finalize();
+    public:
+        ~shared_clause_pool() { finalize(); }
+
+        /**
+           \brief allocate a pool for num_owners threads with at least sz slots.
+           Not thread safe.
+        */
+        void reserve(unsigned num_owners, unsigned sz);
+
+        /**
+           \brief add a clause on behalf of owner.
+           Return false if the clause is too long or was recently added.
+        */
+        bool add(unsigned owner, unsigned n, literal const* lits);
+
+        /**
+           \brief retrieve the next clause added by a thread other than owner.
+           Only the thread identified by owner may call this function.
+        */
+        bool get(unsigned owner, literal_vector& lits);
+
+        unsigned num_added() const { return m_num_added; }
+        unsigned num_duplicates() const { return m_num_duplicates; }
+    };
+
+    class parallel {
 
         bool enable_add(clause const& c) const;
-        void _get_clauses(solver& s);
         void _from_solver(solver& s);
         bool _to_solver(solver& s);
         bool _from_solver(i_local_search& s);
@@ -59,8 +102,7 @@ namespace sat {
         typedef hashtable<unsigned, u_hash, u_eq> index_set;
         literal_vector m_units;
         index_set      m_unit_set;
-        literal_vector m_lits;
-        vector_pool    m_pool;
+        shared_clause_pool m_pool;
         mutex          m_mux;
 
         // for exchange with local search:
@@ -375,6 +375,10 @@ public:
         if (m_preprocess) m_preprocess->collect_statistics(st);
         m_solver.collect_statistics(st);
     }
+    void display_qi_profile(std::ostream & out, bool csv) const override {
+        if (auto* ext = dynamic_cast<euf::solver*>(m_solver.get_extension()))
+            ext->display_qi_profile(out, csv);
+    }
     void get_unsat_core(expr_ref_vector & r) override {
         r.reset();
         r.append(m_core.size(), m_core.data());
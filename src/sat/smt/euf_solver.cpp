@@ -61,6 +61,8 @@ namespace euf {
 
     void solver::updt_params(params_ref const& p) {
         m_config.updt_params(p);
+        m_egraph.set_explain_cache(m_config.m_euf_explain_cache);
+        m_egraph.set_explain_shortest(m_config.m_euf_explain_shortest);
     }
 
     /**
@@ -690,6 +692,11 @@ namespace euf {
         st.update("euf final check", m_stats.m_final_checks);
     }
 
+    void solver::display_qi_profile(std::ostream& out, bool csv) const {
+        if (m_qsolver)
+            static_cast<q::solver*>(m_qsolver)->display_qi_profile(out, csv);
+    }
+
     enode* solver::copy(solver& dst_ctx, enode* src_n) {
         if (!src_n)
             return nullptr;
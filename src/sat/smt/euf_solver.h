@@ -311,6 +311,7 @@ namespace euf {
         euf::egraph::b_pp bpp(enode* n) { return m_egraph.bpp(n); }
         clause_pp pp(literal_vector const& lits) { return clause_pp(*this, lits); }
         void collect_statistics(statistics& st) const override;
+        void display_qi_profile(std::ostream& out, bool csv) const;
         extension* copy(sat::solver* s) override;
         enode* copy(solver& dst_ctx, enode* src_n);
         void find_mutexes(literal_vector& lits, vector<literal_vector>& mutexes) override;
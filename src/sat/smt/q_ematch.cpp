@@ -67,6 +67,15 @@ namespace q {
         ctx.get_egraph().set_on_merge(_on_merge);
         ctx.get_egraph().set_on_make(_on_make);
         m_mam = mam::mk(ctx, *this);
+        if (ctx.get_config().m_qi_profile) {
+            m_profiler = alloc(qi_profiler, m);
+            m_profile_file = ctx.get_config().m_qi_profile_file;
+        }
+    }
+
+    ematch::~ematch() {
+        if (m_profiler && !m_profile_file.empty())
+            m_profiler->write(m_profile_file.c_str());
     }
 
     void ematch::ensure_ground_enodes(expr* e) {
@@ -99,7 +108,12 @@ namespace q {
     }
 
     void ematch::get_antecedents(sat::literal l, sat::ext_justification_idx idx, sat::literal_vector& r, bool probing) {
-        m_eval.explain(l, justification::from_index(idx), r, probing);
+        auto& j = justification::from_index(idx);
+        if (m_profiler && !probing) {
+            m_profiler->set_num_conflicts(ctx.s().get_stats().m_conflict);
+            m_profiler->add_conflict(j.m_clause.q());
+        }
+        m_eval.explain(l, j, r, probing);
     }
 
     std::ostream& ematch::display_constraint(std::ostream& out, sat::ext_constraint_idx idx) const {
@@ -229,16 +243,20 @@ namespace q {
         TRACE("q", tout << "on-binding " << mk_pp(q, m) << "\n";);
         unsigned idx = m_q2clauses[q];
         clause& c = *m_clauses[idx];
-        if (!propagate(_binding, max_generation, c)) 
+        if (m_profiler)
+            m_profiler->add_match(q, pat);
+        if (!propagate(_binding, pat, max_generation, c)) 
             add_binding(c, pat, _binding, max_generation, min_gen, max_gen);
     }
 
-    bool ematch::propagate(euf::enode* const* binding, unsigned max_generation, clause& c) {
+    bool ematch::propagate(euf::enode* const* binding, app* pat, unsigned max_generation, clause& c) {
         TRACE("q", c.display(ctx, tout) << "\n";);
         unsigned idx = UINT_MAX;
         lbool ev = m_eval(binding, c, idx);
         if (ev == l_true) {
             ++m_stats.m_num_redundant;
+            if (m_profiler)
+                m_profiler->add_redundant(c.q());
             return true;
         }
         if (ev == l_undef && idx == UINT_MAX) {
@@ -252,6 +270,8 @@ namespace q {
         if (ev == l_undef && max_generation > m_generation_propagation_threshold)
             return false;
         auto j_idx = mk_justification(idx, c, binding);       
+        if (m_profiler)
+            m_profiler->add_instance(c.q(), pat, max_generation);
         if (ev == l_false) {
             ++m_stats.m_num_conflicts;
             ctx.set_conflict(j_idx);
@@ -479,7 +499,7 @@ namespace q {
                 continue;
 
             do {
-                if (propagate(b->m_nodes, b->m_max_generation, c)) {
+                if (propagate(b->m_nodes, b->m_pattern, b->m_max_generation, c)) {
                     to_remove.push_back(b);
                     propagated = true;
                 }
@@ -507,6 +527,8 @@ namespace q {
 
     bool ematch::operator()() {
         TRACE("q", m_mam->display(tout););
+        if (m_profiler)
+            m_profiler->set_num_conflicts(ctx.s().get_stats().m_conflict);
         if (propagate(false))
             return true;
         if (m_lazy_mam) {
@@ -532,6 +554,16 @@ namespace q {
         st.update("q conflicts", m_stats.m_num_conflicts);
     }
 
+    void ematch::display_qi_profile(std::ostream& out, bool csv) const {
+        if (!m_profiler)
+            return;
+        m_profiler->set_num_conflicts(ctx.s().get_stats().m_conflict);
+        if (csv)
+            m_profiler->display_csv(out);
+        else
+            m_profiler->display_json(out);
+    }
+
     std::ostream& ematch::display(std::ostream& out) const {
         for (auto const& c : m_clauses) 
             c->display(ctx, out);
@@ -18,6 +18,7 @@ Author:
 
 #include "util/nat_set.h"
 #include "ast/quantifier_stat.h"
+#include "ast/qi_profiler.h"
 #include "ast/pattern/pattern_inference.h"
 #include "solver/solver.h"
 #include "sat/smt/sat_th.h"
@@ -79,6 +80,8 @@ namespace q {
         nat_set                       m_clause_in_queue;
         unsigned                      m_qhead { 0 };
         unsigned_vector               m_clause_queue;
+        scoped_ptr<qi_profiler>       m_profiler;
+        std::string                   m_profile_file;
 
         binding* alloc_binding(unsigned n, app* pat, unsigned max_generation, unsigned min_top, unsigned max_top);
         void add_binding(clause& c, app* pat, euf::enode* const* _binding, unsigned max_generation, unsigned min_top, unsigned max_top);
@@ -109,6 +112,8 @@ namespace q {
     public:
         
         ematch(euf::solver& ctx, solver& s);
+
+        ~ematch();
             
         bool operator()();
 
@@ -130,7 +135,11 @@ namespace q {
 
         void add_instantiation(clause& c, binding& b, sat::literal lit);
 
-        bool propagate(euf::enode* const* binding, unsigned max_generation, clause& c);
+        bool propagate(euf::enode* const* binding, app* pat, unsigned max_generation, clause& c);
+
+        qi_profiler* profiler() const { return m_profiler.get(); }
+
+        void display_qi_profile(std::ostream& out, bool csv) const;
 
         std::ostream& display(std::ostream& out) const;
 
@@ -25,6 +25,13 @@ Revision History:
 #include "util/trail.h"
 #include "util/stopwatch.h"
 #include "util/approx_set.h"
+#include "util/scoped_ptr_vector.h"
+#ifndef SINGLE_THREAD
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_smt2_pp.h"
@@ -1834,11 +1841,36 @@ namespace q {
 
     typedef svector<backtrack_point> backtrack_stack;
 
+    /**
+       \brief Matches found by an interpreter that runs concurrently with other interpreters.
+       They are passed to ematch after all interpreters are done.
+    */
+    struct match_buffer {
+        struct match {
+            quantifier * m_qa;
+            app *        m_pat;
+            unsigned     m_bindings;      // offset of the bindings in m_bindings
+            unsigned     m_max_generation;
+            unsigned     m_min_top_generation;
+            unsigned     m_max_top_generation;
+        };
+        svector<match> m_matches;
+        enode_vector   m_bindings;
+        double         m_seconds { 0 };
+
+        void reset() {
+            m_matches.reset();
+            m_bindings.reset();
+            m_seconds = 0;
+        }
+    };
+
     class interpreter {
         euf::solver&        ctx;
         ast_manager &       m;
         mam &               m_mam;
         bool                m_use_filters;
+        match_buffer *      m_buffer { nullptr };
         enode_vector        m_registers;
         enode_vector        m_bindings;
         enode_vector        m_args;
@@ -2019,6 +2051,23 @@ namespace q {
         // init(t) must be invoked before execute_core
         bool execute_core(code_tree * t, enode * n);
 
+        /**
+           \brief Matches are buffered instead of passed to ematch while a buffer is set.
+           The interpreter then only reads the egraph.
+        */
+        void set_buffer(match_buffer * b) { m_buffer = b; }
+
+        void on_match(quantifier * qa, app * pat, unsigned num_bindings, enode * const * bindings, unsigned max_generation) {
+            if (!m_buffer) {
+                m_mam.on_match(qa, pat, num_bindings, bindings, max_generation);
+                return;
+            }
+            unsigned min_gen = 0, max_gen = 0;
+            get_min_max_top_generation(min_gen, max_gen);
+            m_buffer->m_matches.push_back({ qa, pat, m_buffer->m_bindings.size(), max_generation, min_gen, max_gen });
+            m_buffer->m_bindings.append(num_bindings, bindings);
+        }
+
         // Return the min, max generation of the enodes in m_pattern_instances.
 
         void get_min_max_top_generation(unsigned& min, unsigned& max) {
@@ -2475,14 +2524,14 @@ namespace q {
             m_bindings[0] = m_registers[static_cast<const yield *>(m_pc)->m_bindings[0]];
 #define ON_MATCH(NUM)                                                   \
             m_max_generation = std::max(m_max_generation, get_max_generation(NUM, m_bindings.begin())); \
-            if (!m.inc()) {                          \
+            if (m_buffer ? m.limit().is_canceled() : !m.inc()) {       \
                 return false;                                           \
             }                                                           \
-            m_mam.on_match(static_cast<const yield *>(m_pc)->m_qa,                                      \
-                           static_cast<const yield *>(m_pc)->m_pat,                                     \
-                           NUM,                                                                         \
-                           m_bindings.begin(),                                                          \
-                           m_max_generation)
+            on_match(static_cast<const yield *>(m_pc)->m_qa,                                            \
+                     static_cast<const yield *>(m_pc)->m_pat,                                           \
+                     NUM,                                                                               \
+                     m_bindings.begin(),                                                                \
+                     m_max_generation)
 
             ON_MATCH(1);
             goto backtrack;
@@ -3026,6 +3075,9 @@ namespace q {
         compiler                    m_compiler;
         interpreter                 m_interpreter;
         code_tree_map               m_trees;
+        unsigned                    m_num_threads;
+        scoped_ptr_vector<interpreter> m_workers;
+        vector<match_buffer>        m_buffers;
 
         ptr_vector<code_tree>       m_tmp_trees;
         ptr_vector<func_decl>       m_tmp_trees_to_delete;
@@ -3701,6 +3753,7 @@ namespace q {
                 code_tree * tmp_tree = m_tmp_trees[lbl_id];
                 SASSERT(tmp_tree != 0);
                 SASSERT(!m_egraph.enodes_of(lbl).empty());
+                scoped_mam_timer _timer(m_ematch.profiler(), lbl);
                 m_interpreter.init(tmp_tree);
                 for (enode * app : m_egraph.enodes_of(lbl)) 
                     if (ctx.is_relevant(app))
@@ -3722,6 +3775,7 @@ namespace q {
             m_compiler(m_egraph, m_ct_manager, m_lbl_hasher, use_filters),
             m_interpreter(ctx, *this, use_filters),
             m_trees(m, m_compiler, ctx),
+            m_num_threads(ctx.get_config().m_qi_ematch_threads),
             m_region(ctx.get_region()) {
             DEBUG_CODE(m_trees.set_egraph(&m_egraph););
             DEBUG_CODE(m_check_missing_instances = false;);
@@ -3771,12 +3825,94 @@ namespace q {
             return out;
         }
 
+        // below this number of candidates, starting threads costs more than matching.
+        static const unsigned c_min_parallel_candidates = 256;
+
+        /**
+           \brief Execute the code trees in m_to_match on m_num_threads threads.
+           The egraph is not modified while the trees are executed. Matches are
+           buffered per code tree and passed to ematch in the order of m_to_match
+           afterwards, so the instances do not depend on the number of threads.
+           Rounds with few candidates are matched on the calling thread.
+        */
+        void propagate_buffered() {
+            unsigned num_trees = m_to_match.size();
+            if (num_trees == 0)
+                return;
+            unsigned num_candidates = 0;
+            for (code_tree* t : m_to_match)
+                num_candidates += t->get_candidates().size();
+            unsigned num_threads = num_candidates < c_min_parallel_candidates ? 1 : std::min(m_num_threads, num_trees);
+            while (m_workers.size() < num_threads)
+                m_workers.push_back(alloc(interpreter, ctx, *this, m_use_filters));
+            m_buffers.reserve(num_trees);
+            qi_profiler* profiler = m_ematch.profiler();
+            auto execute = [&](interpreter& interp, unsigned i) {
+                match_buffer& b = m_buffers[i];
+                b.reset();
+                stopwatch watch;
+                if (profiler)
+                    watch.start();
+                interp.set_buffer(&b);
+                interp.execute(m_to_match[i]);
+                interp.set_buffer(nullptr);
+                if (profiler)
+                    b.m_seconds = watch.get_current_seconds();
+            };
+#ifdef SINGLE_THREAD
+            for (unsigned i = 0; i < num_trees; ++i)
+                execute(*m_workers[0], i);
+#else
+            std::atomic<unsigned> next(0);
+            std::mutex mux;
+            std::exception_ptr ex;
+            auto worker = [&](unsigned w) {
+                try {
+                    for (unsigned i = next++; i < num_trees; i = next++)
+                        execute(*m_workers[w], i);
+                }
+                catch (...) {
+                    m_workers[w]->set_buffer(nullptr);
+                    std::lock_guard<std::mutex> lock(mux);
+                    if (!ex)
+                        ex = std::current_exception();
+                }
+            };
+            vector<std::thread> threads;
+            for (unsigned w = 1; w < num_threads; ++w)
+                threads.push_back(std::thread([&, w]() { worker(w); }));
+            worker(0);
+            for (auto& th : threads)
+                th.join();
+            if (ex)
+                std::rethrow_exception(ex);
+#endif
+            for (unsigned i = 0; i < num_trees; ++i) {
+                code_tree* t = m_to_match[i];
+                match_buffer const& b = m_buffers[i];
+                if (profiler)
+                    profiler->add_mam_time(t->get_root_lbl(), b.m_seconds);
+                for (auto const& mt : b.m_matches) {
+                    if (!m.inc())
+                        break;
+                    m_ematch.on_binding(mt.m_qa, mt.m_pat, b.m_bindings.data() + mt.m_bindings, mt.m_max_generation, mt.m_min_top_generation, mt.m_max_top_generation);
+                }
+                t->reset_candidates();
+            }
+        }
+
         void propagate() override {
             TRACE("trigger_bug", tout << "match\n"; display(tout););
-            for (code_tree* t : m_to_match) {
-                SASSERT(t->has_candidates());
-                m_interpreter.execute(t);
-                t->reset_candidates();
+            if (m_num_threads > 0) 
+                propagate_buffered();
+            else {
+                qi_profiler* profiler = m_ematch.profiler();
+                for (code_tree* t : m_to_match) {
+                    SASSERT(t->has_candidates());
+                    scoped_mam_timer _timer(profiler, t->get_root_lbl());
+                    m_interpreter.execute(t);
+                    t->reset_candidates();
+                }
             }
             m_to_match.reset();
             if (!m_new_patterns.empty()) {
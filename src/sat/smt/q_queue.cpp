@@ -145,7 +145,7 @@ namespace q {
         ent.m_instantiated = true;
                 
         unsigned gen = get_new_gen(f, ent.m_cost);
-        if (em.propagate(f.nodes(), gen, *f.c))
+        if (em.propagate(f.nodes(), f.b->m_pattern, gen, *f.c))
             return;
 
         auto* ebindings = m_subst(q, num_bindings);
@@ -155,9 +155,15 @@ namespace q {
         ctx.get_rewriter()(instance);
         if (m.is_true(instance)) {
             stat->inc_num_instances_simplify_true();
+            if (qi_profiler* p = em.profiler())
+                p->add_redundant(q);
             return;
         }
         stat->inc_num_instances();
+        if (qi_profiler* p = em.profiler()) {
+            p->add_instance(q, f.b->m_pattern, gen);
+            p->add_cost(q, ent.m_cost);
+        }
 
         m_stats.m_num_instances++;
         
@@ -83,6 +83,7 @@ namespace q {
         ast_manager& get_manager() { return m; }
         sat::literal_vector const& universal() const { return m_universal; }
         quantifier* flatten(quantifier* q);
+        void display_qi_profile(std::ostream& out, bool csv) const { m_ematch.display_qi_profile(out, csv); }
 
     };
 }
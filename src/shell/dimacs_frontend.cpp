@@ -32,6 +32,7 @@ Revision History:
 
 
 extern bool          g_display_statistics;
+extern bool          g_mapped_input;
 static sat::solver * g_solver = nullptr;
 static clock_t       g_start_time;
 static tactic_ref    g_tac;
@@ -231,7 +232,15 @@ unsigned read_dimacs(char const * file_name) {
     sat::solver solver(p, limit);
     g_solver = &solver;
 
-    if (file_name) {
+    if (file_name && g_mapped_input) {
+        mapped_file in(file_name);
+        if (!in.is_open()) {
+            std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
+            exit(ERR_OPEN_FILE);
+        }
+        parse_dimacs(in, std::cerr, solver);
+    }
+    else if (file_name) {
         std::ifstream in(file_name);
         if (in.bad() || in.fail()) {
             std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
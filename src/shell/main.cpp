@@ -52,6 +52,7 @@ static bool         g_standard_input      = false;
 static input_kind   g_input_kind          = IN_UNSPECIFIED;
 bool                g_display_statistics  = false;
 bool                g_display_model       = false;
+bool                g_mapped_input        = false;
 static bool         g_display_istatistics = false;
 
 static void error(const char * msg) {
@@ -86,6 +87,7 @@ void display_usage() {
     std::cout << "  -lp         use parser for a modest subset of CPLEX LP input format.\n";
     std::cout << "  -log        use parser for Z3 log input format.\n";
     std::cout << "  -in         read formula from standard input.\n";
+    std::cout << "  -mmap       read SMT 2 and DIMACS input files through memory mapping.\n";
     std::cout << "  -model      display model for satisfiable SMT.\n";
     std::cout << "\nMiscellaneous:\n";
     std::cout << "  -h, -?      prints this message.\n";
@@ -191,6 +193,9 @@ static void parse_cmd_line_args(std::string& input_file, int argc, char ** argv)
             else if (strcmp(opt_name, "in") == 0) {
                 g_standard_input = true;
             }
+            else if (strcmp(opt_name, "mmap") == 0) {
+                g_mapped_input = true;
+            }
             else if (strcmp(opt_name, "dimacs") == 0) {
                 g_input_kind = IN_DIMACS;
             }
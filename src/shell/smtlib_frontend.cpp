@@ -23,6 +23,7 @@ Revision History:
 #include<signal.h>
 #include "util/timeout.h"
 #include "util/mutex.h"
+#include "util/mapped_file.h"
 #include "parsers/smt2/smt2parser.h"
 #include "muz/fp/dl_cmds.h"
 #include "cmd_context/extra_cmds/dbg_cmds.h"
@@ -36,6 +37,7 @@ static mutex *display_stats_mux = new mutex;
 
 extern bool g_display_statistics;
 extern bool g_display_model;
+extern bool g_mapped_input;
 static clock_t             g_start_time;
 static cmd_context *       g_cmd_context = nullptr;
 
@@ -133,7 +135,17 @@ unsigned read_smtlib2_commands(char const * file_name) {
     signal(SIGINT, on_ctrl_c);
 
     bool result = true;
-    if (file_name) {
+    if (file_name && g_mapped_input) {
+        mapped_file f(file_name);
+        if (!f.is_open()) {
+            std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
+            exit(ERR_OPEN_FILE);
+        }
+        mapped_file_streambuf buf(f);
+        std::istream in(&buf);
+        result = parse_smt2_commands(ctx, in);
+    }
+    else if (file_name) {
         std::ifstream in(file_name);
         if (in.bad() || in.fail()) {
             std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
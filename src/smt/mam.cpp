@@ -3758,6 +3758,7 @@ namespace {
                 code_tree * tmp_tree = m_tmp_trees[lbl_id];
                 SASSERT(tmp_tree != 0);
                 SASSERT(m_context.get_num_enodes_of(lbl) > 0);
+                q::scoped_mam_timer _timer(m_context.get_qi_profiler(), lbl);
                 m_interpreter.init(tmp_tree);
                 for (enode * app : m_context.enodes_of(lbl)) {
                     if (m_context.is_relevant(app))
@@ -3881,8 +3882,10 @@ namespace {
 
         void match() override {
             TRACE("trigger_bug", tout << "match\n"; display(tout););
+            q::qi_profiler * profiler = m_context.get_qi_profiler();
             for (code_tree* t : m_to_match) {
                 SASSERT(t->has_candidates());
+                q::scoped_mam_timer _timer(profiler, t->get_root_lbl());
                 m_interpreter.execute(t);
                 t->reset_candidates();
             }
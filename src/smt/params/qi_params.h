@@ -36,6 +36,8 @@ struct qi_params {
     unsigned           m_qi_max_lazy_multipattern_matching;
     bool               m_qi_profile;
     unsigned           m_qi_profile_freq;
+    std::string        m_qi_profile_file;
+    unsigned           m_qi_ematch_threads;
     quick_checker_mode m_qi_quick_checker;
     bool               m_qi_lazy_quick_checker;
     bool               m_qi_promote_unsat;
@@ -85,6 +87,7 @@ struct qi_params {
         m_qi_max_lazy_multipattern_matching(2),
         m_qi_profile(false),
         m_qi_profile_freq(UINT_MAX),
+        m_qi_ematch_threads(0),
         m_qi_quick_checker(MC_NO),
         m_qi_lazy_quick_checker(true),
         m_qi_promote_unsat(true),
@@ -25,6 +25,7 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_auto_config = p.auto_config() && gparams::get_value("auto_config") == "true"; // auto-config is not scoped by smt in gparams.
     m_random_seed = p.random_seed();
     m_relevancy_lvl = p.relevancy();
+    m_relevancy_lazy_axioms = p.relevancy_lazy_axioms();
     m_ematching   = p.ematching();
     m_induction   = p.induction();
     m_clause_proof = p.clause_proof();
@@ -47,6 +48,11 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_threads       = p.threads();
     m_threads_max_conflicts  = p.threads_max_conflicts();
     m_threads_cube_frequency = p.threads_cube_frequency();
+    m_threads_share_size = p.threads_share_size();
+    m_threads_share_glue = p.threads_share_glue();
+    m_threads_share_max  = p.threads_share_max();
+    m_euf_explain_cache = p.euf_explain_cache();
+    m_euf_explain_shortest = p.euf_explain_shortest();
     m_core_validate = p.core_validate();
     m_logic = _p.get_sym("logic", m_logic);
     m_string_solver = p.string_solver();
@@ -100,6 +106,7 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_binary_clause_opt);
     DISPLAY_PARAM(m_relevancy_lvl);
     DISPLAY_PARAM(m_relevancy_lemma);
+    DISPLAY_PARAM(m_relevancy_lazy_axioms);
     DISPLAY_PARAM(m_random_seed);
     DISPLAY_PARAM(m_random_var_freq);
     DISPLAY_PARAM(m_inv_decay);
@@ -114,6 +121,11 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_threads);
     DISPLAY_PARAM(m_threads_max_conflicts);
     DISPLAY_PARAM(m_threads_cube_frequency);
+    DISPLAY_PARAM(m_threads_share_size);
+    DISPLAY_PARAM(m_threads_share_glue);
+    DISPLAY_PARAM(m_threads_share_max);
+    DISPLAY_PARAM(m_euf_explain_cache);
+    DISPLAY_PARAM(m_euf_explain_shortest);
     DISPLAY_PARAM(m_simplify_clauses);
     DISPLAY_PARAM(m_tick);
     DISPLAY_PARAM(m_display_features);
@@ -90,6 +90,7 @@ struct smt_params : public preprocessor_params,
     bool             m_binary_clause_opt;
     unsigned         m_relevancy_lvl;
     bool             m_relevancy_lemma;
+    bool             m_relevancy_lazy_axioms;
     unsigned         m_random_seed;
     double           m_random_var_freq;
     double           m_inv_decay;
@@ -105,6 +106,11 @@ struct smt_params : public preprocessor_params,
     unsigned         m_threads;
     unsigned         m_threads_max_conflicts;
     unsigned         m_threads_cube_frequency;
+    unsigned         m_threads_share_size;
+    unsigned         m_threads_share_glue;
+    unsigned         m_threads_share_max;
+    bool             m_euf_explain_cache;
+    bool             m_euf_explain_shortest;
     bool             m_simplify_clauses;
     unsigned         m_tick;
     bool             m_display_features;
@@ -246,6 +252,7 @@ struct smt_params : public preprocessor_params,
         m_binary_clause_opt(true),
         m_relevancy_lvl(2),
         m_relevancy_lemma(false),
+        m_relevancy_lazy_axioms(false),
         m_random_seed(0),
         m_random_var_freq(0.01),
         m_inv_decay(1.052),
@@ -260,6 +267,11 @@ struct smt_params : public preprocessor_params,
         m_threads(1),
         m_threads_max_conflicts(UINT_MAX),
         m_threads_cube_frequency(2),
+        m_threads_share_size(8),
+        m_threads_share_glue(4),
+        m_threads_share_max(1000),
+        m_euf_explain_cache(true),
+        m_euf_explain_shortest(false),
         m_simplify_clauses(true),
         m_tick(1000),
         m_display_features(false),
@@ -144,7 +144,7 @@ namespace smt {
               }
               tout << "\n";);
         TRACE("new_entries_bug", tout << "[qi:insert]\n";);
-        m_new_entries.push_back(entry(f, cost, generation));
+        m_new_entries.push_back(entry(f, pat, cost, generation));
     }
 
     void qi_queue::instantiate() {
@@ -216,6 +216,8 @@ namespace smt {
             // a dummy instantiation is still an instantiation.
             // in this way smt.qi.profile=true coincides with the axiom profiler
             stat->inc_num_instances_checker_sat();
+            if (q::qi_profiler * p = m_qm.get_profiler())
+                p->add_redundant(q);
             return;
         }
 
@@ -237,6 +239,8 @@ namespace smt {
 
             STRACE("instance", tout <<  "Instance reduced to true\n";);
             stat -> inc_num_instances_simplify_true();
+            if (q::qi_profiler * p = m_qm.get_profiler())
+                p->add_redundant(q);
             if (m.has_trace_stream()) {
                 display_instance_profile(f, q, num_bindings, bindings, pr ? pr->get_id() : 0, generation);
                 m.trace_stream() << "[end-of-instance]\n";
@@ -297,7 +301,15 @@ namespace smt {
         m_stats.m_num_instances++;
         unsigned gen = get_new_gen(q, generation, ent.m_cost);
         display_instance_profile(f, q, num_bindings, bindings, proof_id, gen);
+        q::qi_profiler * profiler = m_qm.get_profiler();
+        unsigned num_bool_vars = m_context.get_num_bool_vars();
         m_context.internalize_instance(lemma, pr1, gen);
+        if (profiler) {
+            profiler->add_instance(q, ent.m_pattern, gen);
+            profiler->add_cost(q, ent.m_cost);
+            for (unsigned v = num_bool_vars; v < m_context.get_num_bool_vars(); ++v)
+                profiler->set_var_origin(v, q);
+        }
         if (f->get_def()) {
             m_context.internalize(f->get_def(), true);
         }
@@ -339,6 +351,7 @@ namespace smt {
         s.m_delayed_entries_lim    = m_delayed_entries.size();
         s.m_instances_lim          = m_instances.size();
         s.m_instantiated_trail_lim = m_instantiated_trail.size();
+        s.m_num_bool_vars          = m_context.get_num_bool_vars();
     }
 
     void qi_queue::pop_scope(unsigned num_scopes) {
@@ -352,6 +365,8 @@ namespace smt {
         m_delayed_entries.shrink(s.m_delayed_entries_lim);
         m_instances.shrink(s.m_instances_lim);
         m_new_entries.reset();
+        if (q::qi_profiler * p = m_qm.get_profiler())
+            p->shrink_var_origins(s.m_num_bool_vars);
         m_scopes.shrink(new_lvl);
         TRACE("new_entries_bug", tout << "[qi:pop-scope]\n";);
     }
@@ -434,7 +449,7 @@ namespace smt {
             if (qa2info.find(qa, info)) {
                 info.m_num++;
                 info.m_min_cost = std::min(info.m_min_cost, e.m_cost);
-                info.m_max_cost = std::min(info.m_max_cost, e.m_cost);
+                info.m_max_cost = std::max(info.m_max_cost, e.m_cost);
             }
             else {
                 qas.push_back(qa);
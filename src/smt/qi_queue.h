@@ -54,10 +54,11 @@ namespace smt {
         double                        m_eager_cost_threshold;
         struct entry {
             fingerprint * m_qb;
+            app *         m_pattern;
             float         m_cost;
             unsigned      m_generation:31;
             unsigned      m_instantiated:1;
-            entry(fingerprint * f, float c, unsigned g):m_qb(f), m_cost(c), m_generation(g), m_instantiated(false) {}
+            entry(fingerprint * f, app * pat, float c, unsigned g):m_qb(f), m_pattern(pat), m_cost(c), m_generation(g), m_instantiated(false) {}
         };
         svector<entry>                m_new_entries;
         svector<entry>                m_delayed_entries;
@@ -67,6 +68,7 @@ namespace smt {
             unsigned   m_delayed_entries_lim;
             unsigned   m_instances_lim;
             unsigned   m_instantiated_trail_lim;
+            unsigned   m_num_bool_vars;
         };
         svector<scope>                m_scopes;
 
@@ -330,6 +330,8 @@ namespace smt {
                 if (th)
                     th->conflict_resolution_eh(to_app(n), var);
             }
+            if (q::qi_profiler * p = m_ctx.get_qi_profiler())
+                p->add_conflict_var(var);
 
             if (get_manager().has_trace_stream()) {
                 get_manager().trace_stream() << "[resolve-lit] " << m_conflict_lvl - lvl << " ";
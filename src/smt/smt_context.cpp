@@ -1941,7 +1941,7 @@ namespace smt {
        \brief Execute generic undo-objects.
     */
     void context::undo_trail_stack(unsigned old_size) {
-        ::undo_trail_stack(m_trail_stack, old_size);
+        m_trail_stack.undo(old_size);
     }
 
     /**
@@ -3516,6 +3516,10 @@ namespace smt {
             return;
         }
         m_setup(get_config_mode(use_static_features));
+        // Lazy axiom instantiation tracks relevancy, but atoms are asserted
+        // regardless of whether they are relevant, as with relevancy level 1.
+        if (m_fparams.m_relevancy_lvl == 0 && m_fparams.m_relevancy_lazy_axioms)
+            m_fparams.m_relevancy_lvl = 1;
         m_relevancy_lvl = m_fparams.m_relevancy_lvl;
         setup_components();
     }
@@ -3994,6 +3998,8 @@ namespace smt {
         m_num_conflicts ++;
         m_num_conflicts_since_restart ++;
         m_num_conflicts_since_lemma_gc ++;
+        if (q::qi_profiler * p = get_qi_profiler())
+            p->set_num_conflicts(m_stats.m_num_conflicts);
         switch (m_conflict.get_kind()) {
         case b_justification::CLAUSE:
         case b_justification::BIN_CLAUSE:
@@ -4171,6 +4177,8 @@ namespace smt {
                 }
             }
 #endif
+            if (m_par)
+                m_par->share_clause(*this, num_lits, lits);
             mk_clause(num_lits, lits, js, CLS_LEARNED);
             if (delay_forced_restart) {
                 SASSERT(num_lits == 1);
@@ -563,6 +563,10 @@ namespace smt {
             return m_qmanager->get_generation(q);
         }
 
+        q::qi_profiler * get_qi_profiler() const {
+            return m_qmanager->get_profiler();
+        }
+
         /**
            \brief Return true if the logical context internalized universal quantifiers.
         */
@@ -600,8 +604,7 @@ namespace smt {
         //
         // -----------------------------------
     protected:
-        typedef ptr_vector<trail >   trail_stack;
-        trail_stack                           m_trail_stack;
+        typed_trail                           m_trail_stack;
 #ifdef Z3DEBUG
         bool                                  m_trail_enabled { true };
 #endif
@@ -610,11 +613,40 @@ namespace smt {
         template<typename TrailObject>
         void push_trail(const TrailObject & obj) {
             SASSERT(m_trail_enabled);
-            m_trail_stack.push_back(new (m_region) TrailObject(obj));
+            m_trail_stack.push_ptr(new (m_region) TrailObject(obj));
+        }
+
+        // The most common trail objects are kept in typed arrays of the trail stack.
+        void push_trail(value_trail<unsigned> const & t) {
+            SASSERT(m_trail_enabled);
+            m_trail_stack.push_value(t.get_value(), t.get_old_value());
+        }
+
+        void push_trail(value_trail<bool> const & t) {
+            SASSERT(m_trail_enabled);
+            m_trail_stack.push_value(t.get_value(), t.get_old_value());
+        }
+
+        template<typename V>
+        void push_trail(push_back_vector<V> const & t) {
+            SASSERT(m_trail_enabled);
+            m_trail_stack.push_back(t.get_vector());
+        }
+
+        template<typename T, bool CallDestructors>
+        void push_trail(push_back_trail<T, CallDestructors> const & t) {
+            SASSERT(m_trail_enabled);
+            m_trail_stack.push_back(t.get_vector());
+        }
+
+        template<typename D, typename R>
+        void push_trail(insert_obj_map<D, R> const & t) {
+            SASSERT(m_trail_enabled);
+            m_trail_stack.push_insert(t.get_map(), t.get_obj());
         }
 
         void push_trail_ptr(trail * ptr) {
-            m_trail_stack.push_back(ptr);
+            m_trail_stack.push_ptr(ptr);
         }
 
     protected:
@@ -1749,6 +1781,8 @@ namespace smt {
         void display_statistics(std::ostream & out) const;
         void display_istatistics(std::ostream & out) const;
 
+        void display_qi_profile(std::ostream & out, bool csv) const { m_qmanager->display_qi_profile(out, csv); }
+
         // -----------------------------------
         //
         // Macros
@@ -212,6 +212,10 @@ namespace smt {
         void display_istatistics(std::ostream & out) const {
             m_kernel.display_istatistics(out);
         }
+
+        void display_qi_profile(std::ostream & out, bool csv) const {
+            m_kernel.display_qi_profile(out, csv);
+        }
         
         bool canceled() {
             return m_kernel.get_cancel_flag();
@@ -413,6 +417,10 @@ namespace smt {
         m_imp->collect_statistics(st);
     }
         
+    void kernel::display_qi_profile(std::ostream & out, bool csv) const {
+        m_imp->display_qi_profile(out, csv);
+    }
+
     void kernel::reset_statistics() {
         m_imp->reset_statistics();
     }
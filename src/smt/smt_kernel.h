@@ -268,6 +268,11 @@ namespace smt {
            \brief Display statistics in low level format.
         */
         void display_istatistics(std::ostream & out) const;
+
+        /**
+           \brief Display the profile of quantifier instantiation.
+        */
+        void display_qi_profile(std::ostream & out, bool csv) const;
                 
         /**
            \brief Return true if the kernel was interrupted.
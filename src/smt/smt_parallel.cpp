@@ -21,9 +21,50 @@ Author:
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_translation.h"
+#include "ast/for_each_expr.h"
 #include "smt/smt_parallel.h"
 #include "smt/smt_lookahead.h"
 
+namespace smt {
+
+    void parallel::share_clause(context& pctx, unsigned num_lits, literal const* lits) {
+        smt_params const& p = pctx.get_fparams();
+        // units are exchanged separately at the end of each round.
+        if (num_lits <= 1 || num_lits > p.m_threads_share_size)
+            return;
+        expr_ref_vector& out = *m_exported[pctx.m_par_index];
+        if (out.size() >= p.m_threads_share_max)
+            return;
+        sbuffer<unsigned> lvls;
+        bool has_undef = false;
+        for (unsigned i = 0; i < num_lits; ++i) {
+            if (pctx.get_assignment(lits[i]) == l_undef)
+                has_undef = true;
+            else
+                lvls.push_back(pctx.get_assign_level(lits[i]));
+        }
+        std::sort(lvls.begin(), lvls.end());
+        unsigned glue = has_undef ? 1 : 0;
+        for (unsigned i = 0; i < lvls.size(); ++i)
+            if (i == 0 || lvls[i] != lvls[i - 1])
+                ++glue;
+        if (glue > p.m_threads_share_glue)
+            return;
+        expr_ref_vector clause(pctx.m);
+        for (unsigned i = 0; i < num_lits; ++i) {
+            expr* atom = pctx.bool_var2expr(lits[i].var());
+            // skolem functions are private to the context that created them.
+            if (!atom || has_skolem_functions(atom))
+                return;
+            expr_ref e(pctx.m);
+            pctx.literal2expr(lits[i], e);
+            clause.push_back(e);
+        }
+        out.push_back(pctx.m.mk_or(clause));
+    }
+
+}
+
 #ifdef SINGLE_THREAD
 
 namespace smt {
@@ -64,6 +105,7 @@ namespace smt {
         scoped_ptr_vector<ast_manager> pms;
         scoped_ptr_vector<context> pctxs;
         vector<expr_ref_vector> pasms;
+        scoped_ptr_vector<expr_ref_vector> pexported;
 
         ast_manager& m = ctx.m;
         scoped_limits sl(m.limit());
@@ -87,6 +129,12 @@ namespace smt {
             context& new_ctx = *pctxs.back();
             context::copy(ctx, new_ctx, true);
             new_ctx.set_random_seed(i + ctx.get_fparams().m_random_seed);
+            pexported.push_back(alloc(expr_ref_vector, *new_m));
+            m_exported.push_back(pexported.back());
+            if (ctx.get_fparams().m_threads_share_size > 0) {
+                new_ctx.m_par = this;
+                new_ctx.m_par_index = i;
+            }
             ast_translation tr(m, *new_m);
             pasms.push_back(tr(asms));
             sl.push_child(&(new_m->limit()));
@@ -139,6 +187,48 @@ namespace smt {
             IF_VERBOSE(1, verbose_stream() << "(smt.thread :units " << sz << ")\n");
         };
 
+        obj_hashtable<expr> clause_set;
+        expr_ref_vector clause_trail(ctx.m);
+        unsigned_vector clause_origin;
+
+        std::function<void(void)> share_clauses = [&,this]() {
+            unsigned old_sz = clause_trail.size();
+            for (unsigned i = 0; i < num_threads; ++i) {
+                context& pctx = *pctxs[i];
+                expr_ref_vector& out = *m_exported[i];
+                ast_translation tr(pctx.m, ctx.m);
+                for (expr* cls : out) {
+                    expr_ref c(tr(cls), ctx.m);
+                    // normalize literal order to recognize the same clause from different workers.
+                    ptr_buffer<expr> lits;
+                    lits.append(to_app(c)->get_num_args(), to_app(c)->get_args());
+                    std::sort(lits.begin(), lits.end(), ast_lt_proc());
+                    c = ctx.m.mk_or(lits.size(), lits.data());
+                    if (!clause_set.contains(c)) {
+                        clause_set.insert(c);
+                        clause_trail.push_back(c);
+                        clause_origin.push_back(i);
+                    }
+                }
+                m_num_exported += out.size();
+                out.reset();
+            }
+
+            unsigned sz = clause_trail.size();
+            for (unsigned i = 0; i < num_threads; ++i) {
+                context& pctx = *pctxs[i];
+                ast_translation tr(ctx.m, pctx.m);
+                for (unsigned j = old_sz; j < sz; ++j) {
+                    if (clause_origin[j] == i)
+                        continue;
+                    expr_ref dst(tr(clause_trail.get(j)), pctx.m);
+                    pctx.assert_expr(dst);
+                    ++m_num_imported;
+                }
+            }
+            IF_VERBOSE(1, verbose_stream() << "(smt.thread :clauses " << (sz - old_sz) << " :exported " << m_num_exported << " :imported " << m_num_imported << ")\n");
+        };
+
         std::mutex mux;
 
         auto worker_thread = [&](int i) {
@@ -228,6 +318,7 @@ namespace smt {
             if (done) break;
 
             collect_units();
+            share_clauses();
             ++num_rounds;
             max_conflicts = (max_conflicts < thread_max_conflicts) ? 0 : (max_conflicts - thread_max_conflicts);
             thread_max_conflicts *= 2;            
@@ -236,6 +327,9 @@ namespace smt {
         for (context* c : pctxs) {
             c->collect_statistics(ctx.m_aux_stats);
         }
+        ctx.m_aux_stats.update("parallel clauses exported", m_num_exported);
+        ctx.m_aux_stats.update("parallel clauses imported", m_num_imported);
+        m_exported.reset();
 
         if (finished_id == UINT_MAX) {
             switch (ex_kind) {
@@ -24,11 +24,26 @@ namespace smt {
 
     class parallel {
         context& ctx;
+
+        // Learned clauses exported by each worker context during a round.
+        // A buffer is only written by the thread owning the worker and it
+        // is drained at the round barrier, so the exchange is lock-free.
+        ptr_vector<expr_ref_vector> m_exported;
+        unsigned m_num_exported { 0 };
+        unsigned m_num_imported { 0 };
+
     public:
         parallel(context& ctx): ctx(ctx) {}
 
         lbool operator()(expr_ref_vector const& asms);
 
+        /**
+           \brief Called by worker context pctx when it learns a clause.
+           Short clauses of low glue over shared atoms are buffered for
+           export to the other workers.
+        */
+        void share_clause(context& pctx, unsigned num_lits, literal const* lits);
+
     };
 
 }
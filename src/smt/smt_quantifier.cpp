@@ -301,6 +301,8 @@ namespace smt {
                 return false;
             }
             get_stat(q)->update_max_generation(max_generation);
+            if (q::qi_profiler * p = m_wrapper.get_profiler())
+                p->add_match(q, pat);
             fingerprint * f = m_context.add_fingerprint(q, q->get_id(), num_bindings, bindings, def);
             if (f) {
                 if (is_trace_enabled("causality")) {
@@ -429,11 +431,16 @@ namespace smt {
         m_imp->m_plugin->set_manager(*this);
         m_lazy_scopes = 0;
         m_lazy = true;
-        
+        if (fp.m_qi_profile) {
+            m_profiler = alloc(q::qi_profiler, ctx.get_manager());
+            m_profile_file = fp.m_qi_profile_file;
+        }
     }
 
     quantifier_manager::~quantifier_manager() {
         dealloc(m_imp);
+        if (m_profiler && !m_profile_file.empty())
+            m_profiler->write(m_profile_file.c_str());
     }
 
     context & quantifier_manager::get_context() const {
@@ -573,6 +580,15 @@ namespace smt {
         m_imp->display_stats(out, q);
     }
 
+    void quantifier_manager::display_qi_profile(std::ostream & out, bool csv) const {
+        if (!m_profiler)
+            return;
+        if (csv)
+            m_profiler->display_csv(out);
+        else
+            m_profiler->display_json(out);
+    }
+
     ptr_vector<quantifier>::const_iterator quantifier_manager::begin_quantifiers() const {
         return m_imp->m_quantifiers.begin();
     }
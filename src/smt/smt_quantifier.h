@@ -20,6 +20,7 @@ Revision History:
 
 #include "ast/ast.h"
 #include "ast/quantifier_stat.h"
+#include "ast/qi_profiler.h"
 #include "util/statistics.h"
 #include "util/params.h"
 #include "smt/smt_types.h"
@@ -38,6 +39,8 @@ namespace smt {
         imp *                       m_imp;
         unsigned                    m_lazy_scopes;
         bool                        m_lazy;
+        scoped_ptr<q::qi_profiler>  m_profiler;
+        std::string                 m_profile_file;
         void flush();
     public:
         quantifier_manager(context & ctx, smt_params & fp, params_ref const & p);
@@ -93,6 +96,13 @@ namespace smt {
         void display(std::ostream & out) const;
         void display_stats(std::ostream & out, quantifier * q) const;
 
+        /**
+           \brief Return the profile of quantifier instantiation, or nullptr if
+           qi.profile is disabled. The profile is kept across resets.
+        */
+        q::qi_profiler * get_profiler() const { return m_profiler.get(); }
+        void display_qi_profile(std::ostream & out, bool csv) const;
+
         void collect_statistics(::statistics & st) const;
         void reset_statistics();
 
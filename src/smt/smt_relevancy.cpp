@@ -126,19 +126,24 @@ namespace smt {
         return mk_relevancy_eh(ite_term_relevancy_eh(c, t, e));
     }
     
+    /**
+       \brief Relevancy propagator whose watch lists are flat arrays indexed by
+       expression id. Watches that only mark a target as relevant are stored as
+       the target itself, so they do not allocate event handlers.
+    */
     struct relevancy_propagator_imp : public relevancy_propagator {
+        typedef ptr_vector<relevancy_eh> relevancy_ehs;
         unsigned                       m_qhead;
         expr_ref_vector                m_relevant_exprs; 
         uint_set                       m_is_relevant;
-        typedef list<relevancy_eh *>   relevancy_ehs;
-        obj_map<expr, relevancy_ehs *> m_relevant_ehs;
-        obj_map<expr, relevancy_ehs *> m_watches[2];
+        vector<relevancy_ehs>          m_handlers;    // expression id -> handlers invoked when it becomes relevant
+        vector<relevancy_ehs>          m_watches[2];  // expression id -> handlers invoked when it is assigned
+        vector<ptr_vector<expr>>       m_targets[2];  // expression id -> targets marked relevant when it is assigned
         struct eh_trail {
-            enum kind { POS_WATCH, NEG_WATCH, HANDLER };
+            enum kind { NEG_WATCH, POS_WATCH, NEG_TARGET, POS_TARGET, HANDLER };
             kind   m_kind;
             expr * m_node;
-            eh_trail(expr * n):m_kind(HANDLER), m_node(n) {}
-            eh_trail(expr * n, bool val):m_kind(val ? POS_WATCH : NEG_WATCH), m_node(n) {}
+            eh_trail(kind k, expr * n):m_kind(k), m_node(n) {}
             kind get_kind() const { return m_kind; }
             expr * get_node() const { return m_node; }
         };
@@ -158,32 +163,12 @@ namespace smt {
             undo_trail(0);
         }
 
-        relevancy_ehs * get_handlers(expr * n) {
-            relevancy_ehs * r = nullptr;
-            m_relevant_ehs.find(n, r);
-            SASSERT(m_relevant_ehs.contains(n) || r == 0);
-            return r;
-        }
-
-        void set_handlers(expr * n, relevancy_ehs * ehs) {
-            if (ehs == nullptr)
-                m_relevant_ehs.erase(n);
-            else
-                m_relevant_ehs.insert(n, ehs);
-        }
-
-        relevancy_ehs * get_watches(expr * n, bool val) {
-            relevancy_ehs * r = nullptr;
-            m_watches[val ? 1 : 0].find(n, r);
-            SASSERT(m_watches[val ? 1 : 0].contains(n) || r == 0);
-            return r;
-        }
-
-        void set_watches(expr * n, bool val, relevancy_ehs * ehs) {
-            if (ehs == nullptr)
-                m_watches[val ? 1 : 0].erase(n);
-            else
-                m_watches[val ? 1 : 0].insert(n, ehs);
+        template<typename T>
+        static T & get_slot(vector<T> & v, expr * n) {
+            unsigned id = n->get_id();
+            if (id >= v.size())
+                v.resize(id + 1);
+            return v[id];
         }
 
         void push_trail(eh_trail const & t) {
@@ -199,8 +184,8 @@ namespace smt {
             }
             else {
                 SASSERT(eh);
-                push_trail(eh_trail(source));
-                set_handlers(source, new (get_region()) relevancy_ehs(eh, get_handlers(source)));
+                push_trail(eh_trail(eh_trail::HANDLER, source));
+                get_slot(m_handlers, source).push_back(eh);
             }
         }
         
@@ -215,8 +200,8 @@ namespace smt {
                 return;
             case l_undef:
                 SASSERT(eh);
-                set_watches(n, val, new (get_region()) relevancy_ehs(eh, get_watches(n, val)));
-                push_trail(eh_trail(n, val));
+                get_slot(m_watches[val], n).push_back(eh);
+                push_trail(eh_trail(val ? eh_trail::POS_WATCH : eh_trail::NEG_WATCH, n));
                 break;
             case l_true:
                 eh->operator()(*this, n, val);
@@ -234,7 +219,8 @@ namespace smt {
             case l_false:
                 return;
             case l_undef:
-                add_watch(n, val, mk_relevancy_eh(simple_relevancy_eh(target)));
+                get_slot(m_targets[val], n).push_back(target);
+                push_trail(eh_trail(val ? eh_trail::POS_TARGET : eh_trail::NEG_TARGET, n));
                 break;
             case l_true:
                 mark_as_relevant(target); propagate();
@@ -290,11 +276,13 @@ namespace smt {
                 --i;
                 eh_trail & t = m_trail[i];
                 expr * n = t.get_node();
-                relevancy_ehs * ehs;
+                unsigned id = n->get_id();
                 switch (t.get_kind()) {
-                case eh_trail::POS_WATCH: ehs = get_watches(n, true); SASSERT(ehs); set_watches(n, true, ehs->tail()); break;
-                case eh_trail::NEG_WATCH: ehs = get_watches(n, false); SASSERT(ehs); set_watches(n, false, ehs->tail()); break;
-                case eh_trail::HANDLER:   ehs = get_handlers(n); SASSERT(ehs); set_handlers(n, ehs->tail()); break;
+                case eh_trail::POS_WATCH:  m_watches[1][id].pop_back(); break;
+                case eh_trail::NEG_WATCH:  m_watches[0][id].pop_back(); break;
+                case eh_trail::POS_TARGET: m_targets[1][id].pop_back(); break;
+                case eh_trail::NEG_TARGET: m_targets[0][id].pop_back(); break;
+                case eh_trail::HANDLER:    m_handlers[id].pop_back(); break;
                 default: UNREACHABLE(); break;
                 }
                 m.dec_ref(n);
@@ -446,10 +434,57 @@ namespace smt {
         }
         
         /**
-           \brief Propagate relevancy to the arguments of recently marked
-           expressions. That is, expressions that are located at positions
-           [m_qhead, m_relevant_exprs.size()) in the stack of 
+           \brief Propagate relevancy to the arguments of an expression
+           that was marked as relevant.
+        */
+        void propagate_relevant_structure(expr * n) {
+            ast_manager & m = get_manager();
+            TRACE("propagate_relevancy_to_args", tout << "propagating relevancy to args of #" << n->get_id() << "\n";);
+            TRACE("propagate_relevancy", tout << "marking as relevant:\n" << mk_bounded_pp(n, m) << "\n";);
+            SASSERT(is_relevant_core(n));
+            if (!is_app(n))
+                return;
+            if (to_app(n)->get_family_id() == m.get_basic_family_id()) {
+                switch (to_app(n)->get_decl_kind()) {
+                case OP_OR:
+                    propagate_relevant_or(to_app(n));
+                    return;
+                case OP_AND:
+                    propagate_relevant_and(to_app(n));
+                    return;
+                case OP_ITE:
+                    propagate_relevant_ite(to_app(n));
+                    return;
+                default:
+                    break;
+                }
+            }
+            propagate_relevant_app(to_app(n));
+        }
+
+        /**
+           \brief Invoke the handlers of an expression that was marked as relevant,
+           the most recently installed first.
+           Handlers are not installed on relevant expressions, so the list is
+           stable while it is traversed.
+        */
+        void propagate_handlers(expr * n) {
+            unsigned id = n->get_id();
+            if (id >= m_handlers.size())
+                return;
+            for (unsigned i = m_handlers[id].size(); i-- > 0; )
+                m_handlers[id][i]->operator()(*this, n);
+        }
+        
+        /**
+           \brief Propagate relevancy from the expressions that are located at
+           positions [m_qhead, m_relevant_exprs.size()) in the stack of 
            relevant expressions.
+
+           Expressions are processed in rounds. A round first propagates the
+           structure of every expression marked since the previous round and
+           then invokes their handlers. Expressions marked during a round are
+           processed by the next one.
         */
         void propagate() override {
             if (m_propagating) {  
@@ -457,41 +492,14 @@ namespace smt {
             }  
             flet<bool> l_prop(m_propagating, true);  
 
-            ast_manager & m = get_manager();
             while (m_qhead < m_relevant_exprs.size()) {
-                expr * n = m_relevant_exprs.get(m_qhead);
-                TRACE("propagate_relevancy_to_args", tout << "propagating relevancy to args of #" << n->get_id() << "\n";);
-                TRACE("propagate_relevancy", tout << "marking as relevant:\n" << mk_bounded_pp(n, m) << "\n";);
-                SASSERT(is_relevant_core(n));
-                m_qhead++;
-                if (is_app(n)) {
-                    family_id fid = to_app(n)->get_family_id();
-                    if (fid == m.get_basic_family_id()) {
-                        switch (to_app(n)->get_decl_kind()) {
-                        case OP_OR:
-                            propagate_relevant_or(to_app(n));
-                            break;
-                        case OP_AND:
-                            propagate_relevant_and(to_app(n));
-                            break;
-                        case OP_ITE:
-                            propagate_relevant_ite(to_app(n));
-                            break;
-                        default:
-                            propagate_relevant_app(to_app(n));
-                            break;
-                        }
-                    }
-                    else {
-                        propagate_relevant_app(to_app(n));
-                    }
-                }
-                
-                relevancy_ehs * ehs = get_handlers(n);
-                while (ehs != nullptr) {
-                    ehs->head()->operator()(*this, n);
-                    ehs = ehs->tail();
-                }
+                unsigned head = m_qhead;
+                unsigned tail = m_relevant_exprs.size();
+                m_qhead = tail;
+                for (unsigned i = head; i < tail; ++i)
+                    propagate_relevant_structure(m_relevant_exprs.get(i));
+                for (unsigned i = head; i < tail; ++i)
+                    propagate_handlers(m_relevant_exprs.get(i));
             }
         }
 
@@ -504,17 +512,24 @@ namespace smt {
                 return;
             ast_manager & m = get_manager();
             SASSERT(enabled());
-            if (is_relevant_core(n)) {
+            if (!is_relevant_core(n)) {
+                // terms of assigned atoms are relevant when axioms are instantiated lazily.
+                if (m_context.get_fparams().m_relevancy_lazy_axioms)
+                    mark_as_relevant(n);
+            }
+            else {
                 if (m.is_or(n))
                     propagate_relevant_or(to_app(n));
                 else if (m.is_and(n))
                     propagate_relevant_and(to_app(n));
             }
-            relevancy_ehs * ehs = get_watches(n, val);
-            while (ehs != nullptr) {
-                ehs->head()->operator()(*this, n, val);
-                ehs = ehs->tail();
-            }
+            unsigned id = n->get_id();
+            if (id < m_targets[val].size())
+                for (unsigned i = m_targets[val][id].size(); i-- > 0; )
+                    mark_as_relevant(m_targets[val][id][i]);
+            if (id < m_watches[val].size())
+                for (unsigned i = m_watches[val][id].size(); i-- > 0; )
+                    m_watches[val][id][i]->operator()(*this, n, val);
         }
 
         void display(std::ostream & out) const override {
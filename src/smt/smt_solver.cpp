@@ -142,6 +142,10 @@ namespace {
             insert_ctrl_c(r);
         }
 
+        void display_qi_profile(std::ostream & out, bool csv) const override {
+            m_context.display_qi_profile(out, csv);
+        }
+
         void collect_statistics(statistics & st) const override {
             m_context.collect_statistics(st);
         }
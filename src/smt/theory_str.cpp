@@ -80,6 +80,7 @@ namespace smt {
         loopDetected(false),
         m_theoryStrOverlapAssumption_term(m.mk_true(), m),
         contains_map(m),
+        m_cache_pins(m),
         string_int_conversion_terms(m),
         totalCacheAccessCount(0),
         cacheHitCount(0),
@@ -95,10 +96,6 @@ namespace smt {
 
     theory_str::~theory_str() {
         m_trail_stack.reset();
-        for (eautomaton * aut : regex_automata) {
-            dealloc(aut);
-        }
-        regex_automata.clear();
         for (auto& kv: var_to_char_subterm_map) dealloc(kv.m_value);
         for (auto& kv: uninterpreted_to_char_subterm_map) dealloc(kv.m_value);
     }
@@ -135,14 +132,16 @@ namespace smt {
         contain_pair_idx_map.reset();
 
         m_automata.reset();
-        regex_automata.reset();
         regex_terms.reset();
         regex_terms_by_string.reset();
         regex_automaton_assumptions.reset();
         regex_terms_with_path_constraints.reset();
         regex_terms_with_length_constraints.reset();
-        regex_term_to_length_constraint.reset();
-        regex_term_to_extra_length_vars.reset();
+        // regex_term_to_length_constraint, regex_term_to_extra_length_vars,
+        // m_regex_automaton_cache and m_concat_axiom_cache are valid across calls to check.
+        // No automaton is in use at this point, so the caches can be dropped if they are too large.
+        if (m_regex_automaton_cache.size() + m_concat_axiom_cache.size() + regex_term_to_length_constraint.size() > c_max_cache_size)
+            reset_caches();
         regex_last_lower_bound.reset();
         regex_last_upper_bound.reset();
         regex_length_attempt_count.reset();
@@ -199,6 +198,8 @@ namespace smt {
         st.update("str refine negated equation", m_stats.m_refine_neq);
         st.update("str refine function", m_stats.m_refine_f);
         st.update("str refine negated function", m_stats.m_refine_nf);
+        st.update("str automaton cache hits", m_stats.m_automaton_cache_hits);
+        st.update("str axiom cache hits", m_stats.m_axiom_cache_hits);
     }
 
     void theory_str::assert_axiom(expr * _e) {
@@ -939,6 +940,13 @@ namespace smt {
             return;
         }
 
+        expr * axiom = nullptr;
+        if (m_concat_axiom_cache.find(a_cat, axiom)) {
+            m_stats.m_axiom_cache_hits++;
+            assert_axiom(axiom);
+            return;
+        }
+
         // build LHS
         expr_ref len_xy(m);
         len_xy = mk_strlen(a_cat);
@@ -966,6 +974,9 @@ namespace smt {
         app * eq = m.mk_eq(len_xy, len_x_plus_len_y);
         SASSERT(eq);
         assert_axiom(eq);
+        m_cache_pins.push_back(a_cat);
+        m_cache_pins.push_back(eq);
+        m_concat_axiom_cache.insert(a_cat, eq);
     }
 
     /*
@@ -1958,6 +1969,18 @@ namespace smt {
         m_basicstr_axiom_todo.reset();
         m_concat_axiom_todo.reset();
         pop_scope_eh(ctx.get_scope_level());
+        regex_automaton_assumptions.reset();
+        reset_caches();
+    }
+
+    void theory_str::reset_caches() {
+        TRACE("str", tout << "resetting caches" << std::endl;);
+        m_regex_automaton_cache.reset();
+        m_regex_automaton_store.reset();
+        m_concat_axiom_cache.reset();
+        regex_term_to_length_constraint.reset();
+        regex_term_to_extra_length_vars.reset();
+        m_cache_pins.reset();
     }
 
     /*
@@ -304,6 +304,8 @@ class theory_str : public theory {
         unsigned m_refine_nf;
         unsigned m_solved_by;
         unsigned m_fixed_length_iterations;
+        unsigned m_automaton_cache_hits;
+        unsigned m_axiom_cache_hits;
     };
 
 protected:
@@ -437,7 +439,9 @@ protected:
 
     // regex automata
     scoped_ptr_vector<eautomaton> m_automata;
-    ptr_vector<eautomaton> regex_automata;
+    // automata by regex term, kept across scopes and calls to check
+    obj_map<expr, eautomaton*> m_regex_automaton_cache;
+    scoped_ptr_vector<eautomaton> m_regex_automaton_store;
     obj_hashtable<expr> regex_terms;
     obj_map<expr, ptr_vector<expr> > regex_terms_by_string; // S --> [ (str.in.re S *) ]
     obj_map<expr, svector<regex_automaton_under_assumptions> > regex_automaton_assumptions; // RegEx --> [ aut+assumptions ]
@@ -461,6 +465,14 @@ protected:
 
     obj_pair_map<expr, expr, expr*> concat_astNode_map;
 
+    // length axiom by concat term; the axiom is valid, so it is kept across scopes
+    obj_map<expr, expr*> m_concat_axiom_cache;
+
+    // keys and values of the caches kept across calls to check. The caches
+    // are dropped when they grow beyond c_max_cache_size entries.
+    expr_ref_vector m_cache_pins;
+    static const unsigned c_max_cache_size = 4096;
+
     // all (str.to-int) and (int.to-str) terms
     expr_ref_vector string_int_conversion_terms;
     obj_hashtable<expr> string_int_axioms;
@@ -567,6 +579,8 @@ protected:
 
     // regex automata and length-aware regex
     bool solve_regex_automata();
+    eautomaton * get_regex_automaton(expr * re);
+    void reset_caches();
     unsigned estimate_regex_complexity(expr * re);
     unsigned estimate_regex_complexity_under_complement(expr * re);
     unsigned estimate_automata_intersection_difficulty(eautomaton * aut1, eautomaton * aut2);
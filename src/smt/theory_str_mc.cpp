@@ -450,9 +450,11 @@ namespace smt {
         expr * str = nullptr, *re = nullptr;
         VERIFY(u.str.is_in_re(f, str, re));
 
-        // TODO reuse some of the automaton framework from theory_str_regex
-        eautomaton * aut = m_mk_aut(re);
-        aut->compress();
+        eautomaton * aut = get_regex_automaton(re);
+        if (aut == nullptr) {
+            TRACE("str_fl", tout << "symbolic automaton construction failed for " << mk_pp(re, m) << std::endl;);
+            return false;
+        }
 
         expr_ref_vector str_chars(m);
         if (!fixed_length_reduce_string_term(subsolver, str, str_chars, cex)) {
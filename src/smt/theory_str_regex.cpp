@@ -43,6 +43,27 @@ namespace smt {
         return static_cast<unsigned>(result);
     }
 
+    /*
+     * Return the compressed automaton for the regex re, or nullptr if it cannot be constructed.
+     * The automaton only depends on re, so it is cached across scopes and calls to check.
+     */
+    eautomaton * theory_str::get_regex_automaton(expr * re) {
+        eautomaton * aut = nullptr;
+        if (m_regex_automaton_cache.find(re, aut)) {
+            m_stats.m_automaton_cache_hits++;
+            return aut;
+        }
+        aut = m_mk_aut(re);
+        if (aut == nullptr) {
+            return nullptr;
+        }
+        aut->compress();
+        m_regex_automaton_store.push_back(aut);
+        m_cache_pins.push_back(re);
+        m_regex_automaton_cache.insert(re, aut);
+        return aut;
+    }
+
     // Returns false if we need to give up solving, e.g. because we found symbolic expressions in an automaton.
     bool theory_str::solve_regex_automata() {
         for (auto str_in_re : regex_terms) {
@@ -95,9 +116,13 @@ namespace smt {
                             assert_axiom(len_constraint);
                         }
 
+                        // the length constraint is valid, keep it across calls to check
+                        m_cache_pins.push_back(str_in_re);
+                        m_cache_pins.push_back(top_level_length_constraint);
                         regex_term_to_length_constraint.insert(str_in_re, top_level_length_constraint);
                         ptr_vector<expr> vtmp;
                         for(auto v : extra_length_vars) {
+                            m_cache_pins.push_back(v);
                             vtmp.push_back(v);
                         }
                         regex_term_to_extra_length_vars.insert(str_in_re, vtmp);
@@ -201,13 +226,11 @@ namespace smt {
                     if (expected_complexity <= m_params.m_RegexAutomata_DifficultyThreshold || regex_get_counter(regex_fail_count, str_in_re) >= m_params.m_RegexAutomata_FailedAutomatonThreshold) {
                         CTRACE("str", regex_get_counter(regex_fail_count, str_in_re) >= m_params.m_RegexAutomata_FailedAutomatonThreshold,
                                 tout << "failed automaton threshold reached for " << mk_pp(str_in_re, m) << " -- automatically constructing full automaton" << std::endl;);
-                        eautomaton * aut = m_mk_aut(re);
+                        eautomaton * aut = get_regex_automaton(re);
                         if (aut == nullptr) {
                             TRACE("str", tout << "ERROR: symbolic automaton construction failed, likely due to non-constant term in regex" << std::endl;);
                             return false;
                         }
-                        aut->compress();
-                        regex_automata.push_back(aut);
                         regex_automaton_under_assumptions new_aut(re, aut, true);
                         if (!regex_automaton_assumptions.contains(re)) {
                             regex_automaton_assumptions.insert(re, svector<regex_automaton_under_assumptions>());
@@ -339,13 +362,11 @@ namespace smt {
                     unsigned expected_complexity = estimate_regex_complexity(re);
                     bool failureThresholdExceeded = (regex_get_counter(regex_fail_count, str_in_re) >= m_params.m_RegexAutomata_FailedAutomatonThreshold);
                     if (expected_complexity <= m_params.m_RegexAutomata_DifficultyThreshold || failureThresholdExceeded) {
-                        eautomaton * aut = m_mk_aut(re);
+                        eautomaton * aut = get_regex_automaton(re);
                         if (aut == nullptr) {
                             TRACE("str", tout << "ERROR: symbolic automaton construction failed, likely due to non-constant term in regex" << std::endl;);
                             return false;
                         }
-                        aut->compress();
-                        regex_automata.push_back(aut);
                         regex_automaton_under_assumptions new_aut(re, aut, true);
                         if (!regex_automaton_assumptions.contains(re)) {
                             regex_automaton_assumptions.insert(re, svector<regex_automaton_under_assumptions>());
@@ -449,13 +470,11 @@ namespace smt {
                         unsigned expected_complexity = estimate_regex_complexity(re);
                         bool failureThresholdExceeded = (regex_get_counter(regex_fail_count, str_in_re) >= m_params.m_RegexAutomata_FailedAutomatonThreshold);
                         if (expected_complexity <= m_params.m_RegexAutomata_DifficultyThreshold || failureThresholdExceeded) {
-                            eautomaton * aut = m_mk_aut(re);
+                            eautomaton * aut = get_regex_automaton(re);
                             if (aut == nullptr) {
                                 TRACE("str", tout << "ERROR: symbolic automaton construction failed, likely due to non-constant term in regex" << std::endl;);
                                 return false;
                             }
-                            aut->compress();
-                            regex_automata.push_back(aut);
                             regex_automaton_under_assumptions new_aut(re, aut, true);
                             if (!regex_automaton_assumptions.contains(re)) {
                                 regex_automaton_assumptions.insert(re, svector<regex_automaton_under_assumptions>());
@@ -485,13 +504,11 @@ namespace smt {
                         unsigned expected_complexity = estimate_regex_complexity(re);
                         if (expected_complexity <= m_params.m_RegexAutomata_DifficultyThreshold
                                 || failureThresholdExceeded) {
-                            eautomaton * aut = m_mk_aut(re);
+                            eautomaton * aut = get_regex_automaton(re);
                             if (aut == nullptr) {
                                 TRACE("str", tout << "ERROR: symbolic automaton construction failed, likely due to non-constant term in regex" << std::endl;);
                                 return false;
                             }
-                            aut->compress();
-                            regex_automata.push_back(aut);
                             regex_automaton_under_assumptions new_aut(re, aut, true);
                             if (!regex_automaton_assumptions.contains(re)) {
                                 regex_automaton_assumptions.insert(re, svector<regex_automaton_under_assumptions>());
@@ -602,7 +619,6 @@ namespace smt {
                         // if the assignment is consistent with our assumption, use the automaton directly;
                         // otherwise, complement it (and save that automaton for next time)
                         // TODO we should cache these intermediate results
-                        // TODO do we need to push the intermediates into a vector for deletion anyway?
                         if ( (current_assignment == l_true && aut.get_polarity())
                                 || (current_assignment == l_false && !aut.get_polarity())) {
                             if (aut_inter == nullptr) {
@@ -614,12 +630,11 @@ namespace smt {
                         } else {
                             // need to complement first
                             expr_ref rc(u.re.mk_complement(aut.get_regex_term()), m);
-                            eautomaton * aut_c = m_mk_aut(rc);
+                            eautomaton * aut_c = get_regex_automaton(rc);
                             if (aut_c == nullptr) {
                                 TRACE("str", tout << "ERROR: symbolic automaton construction failed, likely due to non-constant term in regex" << std::endl;);
                                 return false;
                             }
-                            regex_automata.push_back(aut_c);
                             // TODO is there any way to build a complement automaton from an existing one?
                             // this discards length information
                             if (aut_inter == nullptr) {
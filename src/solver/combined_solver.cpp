@@ -290,6 +290,13 @@ public:
             m_solver1->collect_statistics(st);
     }
 
+    void display_qi_profile(std::ostream & out, bool csv) const override {
+        if (m_use_solver1_results)
+            m_solver1->display_qi_profile(out, csv);
+        else
+            m_solver2->display_qi_profile(out, csv);
+    }
+
     void get_unsat_core(expr_ref_vector & r) override {
         if (m_use_solver1_results)
             m_solver1->get_unsat_core(r);
@@ -58,31 +58,79 @@ class parallel_tactic : public tactic {
 
     class solver_state; 
 
+    /**
+       \brief Work-stealing task queue.
+
+       Each worker owns a deque of tasks. Workers add the tasks they create
+       to their own deque and take tasks from it with priority to the deepest
+       task, so that subtrees are closed before new ones are opened. Idle
+       workers steal from other deques, taking the task that covers the
+       largest fraction of the search space (smallest width).
+       A shared lock is only taken when workers go to sleep or wake up.
+    */
     class task_queue {
-        std::mutex                   m_mutex;
+        struct worker_queue {
+            std::mutex                   m_mutex;
+            ptr_vector<solver_state>     m_tasks;
+            solver_state*                m_active { nullptr };
+        };
+        scoped_ptr_vector<worker_queue> m_queues;
+        std::mutex                   m_mutex;        // protects sleeping
         std::condition_variable      m_cond;
-        ptr_vector<solver_state>     m_tasks;
-        ptr_vector<solver_state>     m_active;
-        unsigned                     m_num_waiters;
+        std::atomic<unsigned>        m_num_tasks;    // number of queued tasks
+        std::atomic<unsigned>        m_num_pending;  // number of tasks queued or being processed
+        std::atomic<unsigned>        m_num_waiters;
+        std::atomic<unsigned>        m_num_steals;
         std::atomic<bool>            m_shutdown;
 
-        void inc_wait() {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            ++m_num_waiters;
-        }
-
-        void dec_wait() {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            --m_num_waiters;
+        worker_queue& get_queue(unsigned id) {
+            return *m_queues[id % m_queues.size()];
+        }
+
+        // index of the deepest task, most recent first.
+        static unsigned select_own(ptr_vector<solver_state> const& tasks) {
+            unsigned best = tasks.size() - 1;
+            for (unsigned i = best; i-- > 0; )
+                if (tasks[i]->get_depth() > tasks[best]->get_depth())
+                    best = i;
+            return best;
+        }
+
+        // index of the task covering the largest part of the search space, oldest first.
+        static unsigned select_steal(ptr_vector<solver_state> const& tasks) {
+            unsigned best = 0;
+            for (unsigned i = 1; i < tasks.size(); ++i)
+                if (tasks[i]->get_width() < tasks[best]->get_width())
+                    best = i;
+            return best;
+        }
+
+        solver_state* try_get_task(worker_queue& q, bool steal) {
+            std::lock_guard<std::mutex> lock(q.m_mutex);
+            if (q.m_tasks.empty())
+                return nullptr;
+            unsigned idx = steal ? select_steal(q.m_tasks) : select_own(q.m_tasks);
+            solver_state* st = q.m_tasks[idx];
+            q.m_tasks[idx] = q.m_tasks.back();
+            q.m_tasks.pop_back();
+            --m_num_tasks;
+            return st;
         }
 
-        solver_state* try_get_task() {
-            solver_state* st = nullptr;
-            std::lock_guard<std::mutex> lock(m_mutex);
-            if (!m_tasks.empty()) {
-                st = m_tasks.back();
-                m_tasks.pop_back();
-                m_active.push_back(st);
+        solver_state* try_get_task(unsigned id) {
+            worker_queue& own = get_queue(id);
+            solver_state* st = try_get_task(own, false);
+            unsigned n = m_queues.size();
+            for (unsigned i = 1; i < n && !st; ++i) {
+                st = try_get_task(*m_queues[(id + i) % n], true);
+                if (st)
+                    ++m_num_steals;
+            }
+            if (st) {
+                std::lock_guard<std::mutex> lock(own.m_mutex);
+                own.m_active = st;
+                if (m_shutdown)
+                    st->m().limit().cancel();
             }
             return st;
         }
@@ -90,86 +138,122 @@ class parallel_tactic : public tactic {
     public:
 
         task_queue(): 
-            m_num_waiters(0), 
-            m_shutdown(false) {}             
+            m_num_tasks(0),
+            m_num_pending(0),
+            m_num_waiters(0),
+            m_num_steals(0),
+            m_shutdown(false) {
+            set_num_workers(1);
+        }
 
         ~task_queue() { reset(); }
 
+        void set_num_workers(unsigned n) {
+            while (m_queues.size() < n)
+                m_queues.push_back(alloc(worker_queue));
+        }
+
         void shutdown() {
             if (!m_shutdown) {
-                m_shutdown = true;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_shutdown = true;
+                }
                 m_cond.notify_all();
-                std::lock_guard<std::mutex> lock(m_mutex);
-                for (solver_state* st : m_active) {
-                    st->m().limit().cancel();
+                for (worker_queue* q : m_queues) {
+                    std::lock_guard<std::mutex> lock(q->m_mutex);
+                    if (q->m_active)
+                        q->m_active->m().limit().cancel();
                 }
             }
         }
 
         bool in_shutdown() const { return m_shutdown; }
 
-        void add_task(solver_state* task) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_tasks.push_back(task);
+        void add_task(solver_state* task, unsigned id) {
+            worker_queue& q = get_queue(id);
+            ++m_num_pending;
+            {
+                std::lock_guard<std::mutex> lock(q.m_mutex);
+                q.m_tasks.push_back(task);
+                ++m_num_tasks;
+            }
             if (m_num_waiters > 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
                 m_cond.notify_one();
-            }            
+            }
         } 
 
         bool is_idle() {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            return m_tasks.empty() && m_num_waiters > 0;
+            return m_num_tasks == 0 && m_num_waiters > 0;
         }
 
-        solver_state* get_task() { 
+        solver_state* get_task(unsigned id) { 
             while (!m_shutdown) {
-                inc_wait();
-                solver_state* st = try_get_task();
-                if (st) {
-                    dec_wait();
+                solver_state* st = try_get_task(id);
+                if (st) 
                     return st;
-                }
-                {
-                    std::unique_lock<std::mutex> lock(m_mutex);
-                    m_cond.wait(lock);
-                }
-                dec_wait();
+                std::unique_lock<std::mutex> lock(m_mutex);
+                ++m_num_waiters;
+                m_cond.wait(lock, [&]() { return m_shutdown || m_num_tasks > 0; });
+                --m_num_waiters;
             }
             return nullptr;
         }
 
-        void task_done(solver_state* st) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_active.erase(st);
-            if (m_tasks.empty() && m_active.empty()) {
-                m_shutdown = true;
+        void task_done(solver_state* st, unsigned id) {
+            {
+                worker_queue& q = get_queue(id);
+                std::lock_guard<std::mutex> lock(q.m_mutex);
+                SASSERT(q.m_active == st);
+                q.m_active = nullptr;
+            }
+            // a task adds its sub-tasks before it is done, so the count of
+            // pending tasks only drops to zero once all work is finished.
+            if (--m_num_pending == 0) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_shutdown = true;
+                }
                 m_cond.notify_all();
             }
         }
 
+        unsigned num_steals() const { return m_num_steals; }
+
         void stats(::statistics& st) {
-            for (auto* t : m_tasks) 
-                t->get_solver().collect_statistics(st);
-            for (auto* t : m_active) 
-                t->get_solver().collect_statistics(st);
+            for (worker_queue* q : m_queues) {
+                for (auto* t : q->m_tasks) 
+                    t->get_solver().collect_statistics(st);
+                if (q->m_active)
+                    q->m_active->get_solver().collect_statistics(st);
+            }
         }
 
         void reset() {
-            for (auto* t : m_tasks) 
-                dealloc(t);
-            for (auto* t : m_active) 
-                dealloc(t);
-            m_tasks.reset();
-            m_active.reset();
+            for (worker_queue* q : m_queues) {
+                for (auto* t : q->m_tasks) 
+                    dealloc(t);
+                if (q->m_active)
+                    dealloc(q->m_active);
+                q->m_tasks.reset();
+                q->m_active = nullptr;
+            }
+            m_num_tasks = 0;
+            m_num_pending = 0;
             m_num_waiters = 0;
+            m_num_steals = 0;
             m_shutdown = false;
         }
 
         std::ostream& display(std::ostream& out) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            out << "num_tasks " << m_tasks.size() << " active: " << m_active.size() << "\n";
-            for (solver_state* st : m_tasks) {
-                st->display(out);
+            for (unsigned i = 0; i < m_queues.size(); ++i) {
+                worker_queue& q = *m_queues[i];
+                std::lock_guard<std::mutex> lock(q.m_mutex);
+                out << "worker " << i << " num_tasks " << q.m_tasks.size() << " active: " << (q.m_active ? 1 : 0) << "\n";
+                for (solver_state* st : q.m_tasks) {
+                    st->display(out);
+                }
             }
             return out;
         }
@@ -248,6 +332,13 @@ class parallel_tactic : public tactic {
 
         vector<cube_var> const& cubes() const { return m_cubes; }
 
+        // hand the cubes over to a clone of this state.
+        solver_state* move_cubes_to_clone() {
+            solver_state* st = clone();
+            m_cubes.reset();
+            return st;
+        }
+
         // remove up to n cubes from list of cubes.
         vector<cube_var> split_cubes(unsigned n) {
             vector<cube_var> result;
@@ -260,6 +351,28 @@ class parallel_tactic : public tactic {
             return result;
         }
 
+        /**
+           \brief remove cubes that contain all literals of core.
+           The core is known to be unsatisfiable with the asserted cubes.
+        */
+        static unsigned prune_cubes(vector<cube_var>& cubes, expr_ref_vector const& core) {
+            auto subsumed = [&](cube_var const& cv) {
+                for (expr* e : core)
+                    if (!cv.cube().contains(e))
+                        return false;
+                return true;
+            };
+            if (!std::any_of(cubes.begin(), cubes.end(), subsumed))
+                return 0;
+            vector<cube_var> result;
+            for (cube_var const& cv : cubes)
+                if (!subsumed(cv))
+                    result.push_back(cv);
+            unsigned num_pruned = cubes.size() - result.size();
+            cubes.swap(result);
+            return num_pruned;
+        }
+
         void set_cubes(vector<cube_var>& c) {
             m_cubes.reset();
             DEBUG_CODE(for (auto & cb : c) for (expr* e : cb.cube()) SASSERT(e););
@@ -373,6 +486,7 @@ private:
     std::atomic<bool> m_has_undef;
     bool          m_allsat;
     unsigned      m_num_unsat;
+    unsigned      m_num_pruned;
     unsigned      m_last_depth;
     int           m_exn_code;
     std::string   m_exn_msg;
@@ -386,12 +500,14 @@ private:
         m_allsat = false;
         m_branches = 0;    
         m_num_unsat = 0;
+        m_num_pruned = 0;
         m_last_depth = 0;
         m_backtrack_frequency = pp.conquer_backtrack_frequency();
         m_conquer_delay = pp.conquer_delay();
         m_exn_code = 0;
         m_params.set_bool("override_incremental", true);
         m_core.reset();
+        m_queue.set_num_workers(m_num_threads);
     }
 
     void log_branches(lbool status) {
@@ -490,7 +606,21 @@ private:
         close_branch(s, l_undef);
     }
 
-    void cube_and_conquer(solver_state& s) {
+    /**
+       \brief prune pending cubes that are subsumed by an unsatisfiable core.
+       The cubes of s were already handed to a clone before conquering.
+    */
+    void prune_cubes(vector<cube_var>& pending, expr_ref_vector const& core) {
+        if (core.empty())
+            return;
+        unsigned n = solver_state::prune_cubes(pending, core);
+        if (n == 0)
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_num_pruned += n;
+    }
+
+    void cube_and_conquer(solver_state& s, unsigned id) {
         ast_manager& m = s.m();
         vector<cube_var> cube, hard_cubes, cubes;
         expr_ref_vector vars(m);
@@ -503,7 +633,7 @@ private:
         cube.append(s.split_cubes(1));
         SASSERT(cube.size() <= 1);
         IF_VERBOSE(2, verbose_stream() << "(tactic.parallel :split-cube " << cube.size() << ")\n";);
-        if (!s.cubes().empty()) m_queue.add_task(s.clone());
+        if (!s.cubes().empty()) m_queue.add_task(s.move_cubes_to_clone(), id);
         if (!cube.empty()) {
             s.assert_cube(cube.get(0).cube());
             vars.reset();
@@ -564,6 +694,7 @@ private:
                     IF_VERBOSE(0, verbose_stream() << "(tactic.parallel :backtrack " << cutoff << " -> " << c.size() << ")\n");
                     cutoff = c.size();
                 }
+                prune_cubes(cubes, c);
                 inc_unsat(s);
                 log_branches(l_false);
                 break;
@@ -584,7 +715,7 @@ private:
 
             }
             if (cubes.size() >= conquer_batch_size()) {
-                spawn_cubes(s, 10*width, cubes);
+                spawn_cubes(s, 10*width, cubes, id);
                 first = false;
                 cubes.reset();
             }
@@ -608,13 +739,13 @@ private:
         }                
     }
 
-    void spawn_cubes(solver_state& s, unsigned width, vector<cube_var>& cubes) {
+    void spawn_cubes(solver_state& s, unsigned width, vector<cube_var>& cubes, unsigned id) {
         if (cubes.empty()) return;
         add_branches(cubes.size());
         s.set_cubes(cubes);
-        solver_state* s1 = s.clone();
+        solver_state* s1 = s.move_cubes_to_clone();
         s1->inc_width(width);
-        m_queue.add_task(s1);
+        m_queue.add_task(s1, id);
     }
 
     /*
@@ -648,7 +779,11 @@ private:
             }
             if (r == l_false) {
                 backtrack(s, asms, full);
-            }            
+            }
+            else {
+                // the prefix is not known to be unsatisfiable.
+                asms.push_back(last);
+            }
         }        
     }
 
@@ -666,12 +801,12 @@ private:
         return memory::above_high_watermark();
     }
 
-    void run_solver() {
+    void run_solver(unsigned id) {
         try {
-            while (solver_state* st = m_queue.get_task()) {
-                cube_and_conquer(*st);                
+            while (solver_state* st = m_queue.get_task(id)) {
+                cube_and_conquer(*st, id);                
                 collect_statistics(*st);
-                m_queue.task_done(st);
+                m_queue.task_done(st, id);
                 if (!st->m().inc()) m_queue.shutdown();
                 IF_VERBOSE(2, display(verbose_stream()););
                 dealloc(st);
@@ -705,7 +840,7 @@ private:
         add_branches(1);
         vector<std::thread> threads;
         for (unsigned i = 0; i < m_num_threads; ++i) 
-            threads.push_back(std::thread([this]() { run_solver(); }));
+            threads.push_back(std::thread([this, i]() { run_solver(i); }));
         for (std::thread& t : threads) 
             t.join();
         m_queue.stats(m_stats);
@@ -758,7 +893,7 @@ public:
             throw default_exception("parallel tactic does not work with trace");
         solver* s = m_solver->translate(m, m_params);
         solver_state* st = alloc(solver_state, nullptr, s, m_params);
-        m_queue.add_task(st);
+        m_queue.add_task(st, 0);
         expr_ref_vector clauses(m);
         ptr_vector<expr> assumptions;
         obj_map<expr, expr*> bool2dep;
@@ -822,6 +957,8 @@ public:
         st.update("par unsat", m_num_unsat);
         st.update("par models", m_models.size());
         st.update("par progress", m_progress);
+        st.update("par pruned", m_num_pruned);
+        st.update("par steals", m_queue.num_steals());
     }
 
     void reset_statistics() override {
@@ -290,6 +290,13 @@ public:
     */
     virtual std::ostream& display(std::ostream & out, unsigned n = 0, expr* const* assumptions = nullptr) const;
 
+    /**
+       \brief Display the profile of quantifier instantiation collected when
+       smt.qi.profile is enabled, as CSV if csv is true and as JSON otherwise.
+       Solvers without E-matching display nothing.
+    */
+    virtual void display_qi_profile(std::ostream & out, bool csv) const {}
+
     /**
        \brief Display the content of this solver in DIMACS format
     */
@@ -84,6 +84,7 @@ public:
 
     void collect_param_descrs(param_descrs & r) override { m_base->collect_param_descrs(r); }
     void collect_statistics(statistics & st) const override { m_base->collect_statistics(st); }
+    void display_qi_profile(std::ostream & out, bool csv) const override { m_base->display_qi_profile(out, csv); }
     unsigned get_num_assertions() const override { return m_base->get_num_assertions(); }
     expr * get_assertion(unsigned idx) const override { return m_base->get_assertion(idx); }
 
@@ -131,6 +131,9 @@ public:
         r.insert("blast_add", CPK_BOOL, "(default: true) bit-blast adders.");
         r.insert("blast_quant", CPK_BOOL, "(default: false) bit-blast quantified variables.");
         r.insert("blast_full", CPK_BOOL, "(default: false) bit-blast any term with bit-vector sort, this option will make E-matching ineffective in any pattern containing bit-vector terms.");
+        r.insert("blast_aig", CPK_BOOL, "(default: false) normalize the gates of bit-blasted circuits as in And-Inverter graphs, so that gates equal up to commutativity and polarity of inputs are shared.");
+        r.insert("blast_mul_encoding", CPK_SYMBOL, "(default: array) encoding of bit-blasted multipliers: array, wallace (Wallace tree) or karatsuba (recursive splitting of wide multipliers).");
+        r.insert("blast_karatsuba_threshold", CPK_UINT, "(default: 32) minimal bit-width of multipliers that are split when blast_mul_encoding is karatsuba.");
     }
      
     void operator()(goal_ref const & g, 
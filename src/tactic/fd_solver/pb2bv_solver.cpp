@@ -88,6 +88,7 @@ public:
         m_rewriter.collect_statistics(st);
         m_solver->collect_statistics(st); 
     }
+    void display_qi_profile(std::ostream & out, bool csv) const override { m_solver->display_qi_profile(out, csv); }
     void get_unsat_core(expr_ref_vector & r) override { m_solver->get_unsat_core(r); }
     void get_model_core(model_ref & mdl) override { 
         m_solver->get_model(mdl);
@@ -17,6 +17,7 @@ Revision History:
 
 --*/
 #include "ast/ast.h"
+#include <thread>
 
 static void tst1() {
     ast_manager m;
@@ -131,6 +132,41 @@ static void tst5() {
     m.del(arr3);
 }
 
+#ifndef SINGLE_THREAD
+// threads create the same terms concurrently, hash-consing must still 
+// return a unique node for each term.
+static void tst6() {
+    ast_manager m;
+    sort_ref s(m.mk_uninterpreted_sort(symbol("S")), m);
+    m.set_concurrent(true);
+    unsigned const num_threads = 4;
+    unsigned const num_terms = 200;
+    vector<expr_ref_vector> results;
+    for (unsigned i = 0; i < num_threads; ++i)
+        results.push_back(expr_ref_vector(m));
+    vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            func_decl_ref f(m.mk_func_decl(symbol("f"), s, s, s), m);
+            for (unsigned i = 0; i < num_terms; ++i) {
+                expr_ref x(m.mk_const(symbol(i % 10), s), m);
+                expr_ref y(m.mk_const(symbol(i), s), m);
+                expr_ref e(m.mk_eq(m.mk_app(f.get(), x.get(), y.get()), x), m);
+                results[t].push_back(e);
+                // create and drop garbage to exercise deferred deletion.
+                expr_ref tmp(m.mk_app(f.get(), m.mk_app(f.get(), x.get(), x.get()), y.get()), m);
+            }
+        }));
+    }
+    for (auto& th : threads)
+        th.join();
+    for (unsigned t = 1; t < num_threads; ++t)
+        for (unsigned i = 0; i < num_terms; ++i)
+            ENSURE(results[0].get(i) == results[t].get(i));
+    m.set_concurrent(false);
+    ENSURE(!m.is_concurrent());
+}
+#endif
 
 struct foo {
     unsigned       m_id; 
@@ -153,5 +189,8 @@ void tst_ast() {
     tst3();
     tst4();
     tst5();
+#ifndef SINGLE_THREAD
+    tst6();
+#endif
 }
 
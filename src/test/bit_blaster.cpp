@@ -18,8 +18,15 @@ Revision History:
 --*/
 
 #include "ast/rewriter/bit_blaster/bit_blaster.h"
+#include "ast/rewriter/bit_blaster/bit_blaster_rewriter.h"
+#include "ast/rewriter/expr_safe_replace.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
+#include "ast/for_each_expr.h"
+#include "util/util.h"
 
 void mk_bits(ast_manager & m, char const * prefix, unsigned sz, expr_ref_vector & r) {
     sort_ref b(m);
@@ -113,7 +120,56 @@ void tst_sh(ast_manager & m, unsigned sz) {
 //     TRACE("bit_blaster", tout << "ashr " << c.size() << "\n"; display(tout, c, false););
 }
 
+// blast x*y = z and evaluate the circuit on random values of x, y.
+static void tst_mul_encoding(unsigned sz, bool aig, char const * encoding) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    params_ref p;
+    p.set_bool("blast_aig", aig);
+    p.set_sym("blast_mul_encoding", symbol(encoding));
+    p.set_uint("blast_karatsuba_threshold", 8);
+    bit_blaster_rewriter blaster(m, p);
+    expr_ref x(m.mk_const("x", bv.mk_sort(sz)), m);
+    expr_ref y(m.mk_const("y", bv.mk_sort(sz)), m);
+    expr_ref z(m.mk_const("z", bv.mk_sort(sz)), m);
+    expr_ref fml(m.mk_eq(bv.mk_bv_mul(x, y), z), m), circuit(m);
+    proof_ref pr(m);
+    blaster.start_rewrite();
+    blaster(fml, circuit, pr);
+    obj_map<func_decl, expr*> const2bits;
+    ptr_vector<func_decl> newbits;
+    blaster.end_rewrite(const2bits, newbits);
+    std::cout << "bit-width " << sz << " aig " << aig << " " << encoding << " size " << get_num_exprs(circuit) << "\n";
+
+    random_gen r(sz);
+    th_rewriter rw(m);
+    rational pow2 = rational::power_of_two(sz);
+    for (unsigned k = 0; k < 20; ++k) {
+        rational vx = mod(rational(r()) * rational(r()), pow2);
+        rational vy = mod(rational(r()) * rational(r()), pow2);
+        rational vz = mod(vx * vy + rational(k % 2), pow2);
+        expr_safe_replace sub(m);
+        auto set_bits = [&](expr * c, rational const & v) {
+            app * bits = to_app(const2bits[to_app(c)->get_decl()]);
+            for (unsigned i = 0; i < sz; ++i)
+                sub.insert(bits->get_arg(i), m.mk_bool_val(v.get_bit(i)));
+        };
+        set_bits(x, vx);
+        set_bits(y, vy);
+        set_bits(z, vz);
+        expr_ref val(m);
+        sub(circuit, val);
+        rw(val);
+        ENSURE(k % 2 == 0 ? m.is_true(val) : m.is_false(val));
+    }
+}
+
 void tst_bit_blaster() {
+    for (bool aig : { false, true })
+        for (char const * encoding : { "array", "wallace", "karatsuba" })
+            for (unsigned sz : { 5, 13, 16 })
+                tst_mul_encoding(sz, aig, encoding);
     ast_manager m;
     tst_adder(m, 4);
     tst_multiplier(m, 4);
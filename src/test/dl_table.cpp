@@ -6,6 +6,7 @@ Copyright (c) 2015 Microsoft Corporation
 #include "muz/rel/dl_table.h"
 #include "muz/fp/dl_register_engine.h"
 #include "muz/rel/dl_relation_manager.h"
+#include <algorithm>
 
 typedef datalog::table_base* (*mk_table_fn)(datalog::relation_manager& m, datalog::table_signature& sig);
 
@@ -95,6 +96,75 @@ void test_dl_bitvector_table() {
     test_table(mk_bv_table);
 }
 
+static void join_sparse(unsigned num_threads, vector<datalog::table_fact>& facts) {
+    smt_params params;
+    params_ref p;
+    p.set_uint("datalog.threads", num_threads);
+    ast_manager ast_m;
+    reg_decl_plugins(ast_m);
+    datalog::register_engine re;
+    datalog::context ctx(ast_m, re, params, p);
+    datalog::relation_manager & m = ctx.get_rel_context()->get_rmanager();
+    datalog::table_plugin * plugin = m.get_table_plugin(symbol("sparse"));
+    ENSURE(plugin);
+
+    datalog::table_signature sig1, sig2;
+    sig1.push_back(1 << 16);
+    sig1.push_back(128);
+    sig1.push_back(1024);
+    sig2.push_back(128);
+    sig2.push_back(1 << 10);
+    datalog::table_base* t1 = plugin->mk_empty(sig1);
+    datalog::table_base* t2 = plugin->mk_empty(sig2);
+    datalog::table_fact row;
+    for (unsigned i = 0; i < 6000; ++i) {
+        row.reset();
+        row.push_back(i);
+        row.push_back(i % 97);
+        row.push_back((i * 7) % 1000);
+        t1->add_fact(row);
+    }
+    for (unsigned j = 0; j < 300; ++j) {
+        row.reset();
+        row.push_back((j * 13) % 101);
+        row.push_back(j);
+        t2->add_fact(row);
+    }
+    unsigned cols1[1] = { 1 };
+    unsigned cols2[1] = { 0 };
+    datalog::table_join_fn * join = m.mk_join_fn(*t1, *t2, 1, cols1, cols2);
+    datalog::table_base* t3 = (*join)(*t1, *t2);
+    for (auto const& r : *t3) {
+        r.get_fact(row);
+        facts.push_back(row);
+    }
+    dealloc(join);
+    t1->deallocate();
+    t2->deallocate();
+    t3->deallocate();
+}
+
+static void test_sparse_parallel_join() {
+    // the joined relation does not depend on the number of threads.
+    vector<datalog::table_fact> facts1, facts4;
+    join_sparse(1, facts1);
+    join_sparse(4, facts4);
+    unsigned expected = 0;
+    for (unsigned i = 0; i < 6000; ++i)
+        for (unsigned j = 0; j < 300; ++j)
+            expected += (i % 97) == (j * 13) % 101;
+    std::cout << "sparse join rows: " << facts1.size() << "\n";
+    ENSURE(facts1.size() == expected);
+    ENSURE(facts4.size() == expected);
+    auto lt = [](datalog::table_fact const& a, datalog::table_fact const& b) {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    };
+    std::sort(facts1.begin(), facts1.end(), lt);
+    std::sort(facts4.begin(), facts4.end(), lt);
+    ENSURE(facts1 == facts4);
+}
+
 void tst_dl_table() {
     test_dl_bitvector_table();
+    test_sparse_parallel_join();
 }
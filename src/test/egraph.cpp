@@ -129,8 +129,72 @@ static void test3() {
         std::cout << "conflict: " << *j << "\n";
 }
 
+static unsigned get_stat(euf::egraph const& g, char const* key) {
+    statistics st;
+    g.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+static ptr_vector<int> explain_eq(euf::egraph& g, euf::enode* a, euf::enode* b) {
+    ptr_vector<int> js;
+    g.begin_explain();
+    g.explain_eq<int>(js, a, b);
+    g.end_explain();
+    std::sort(js.begin(), js.end(), [](int* x, int* y) { return *x < *y; });
+    return js;
+}
+
+// explanation cache and shortest explanations
+static void test4(bool shortest) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    euf::egraph g(m);
+    g.set_explain_shortest(shortest);
+    sort_ref S(m.mk_uninterpreted_sort(symbol("S")), m);
+    int justifications[13] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+    euf::enode_vector xs;
+    expr_ref_vector pinned(m);
+    for (unsigned i = 0; i < 10; ++i) {
+        expr_ref x = mk_const(m, ("x" + std::to_string(i)).c_str(), S);
+        pinned.push_back(x);
+        xs.push_back(g.mk(x, 0, 0, nullptr));
+    }
+    expr_ref y = mk_const(m, "y", S);
+    euf::enode* ny = g.mk(y, 0, 0, nullptr);
+    for (unsigned i = 0; i + 1 < 10; ++i)
+        g.merge(xs[i], xs[i + 1], justifications + i);
+    g.propagate();
+    g.merge(xs[0], xs[9], justifications + 10);
+    g.propagate();
+
+    ptr_vector<int> js = explain_eq(g, xs[0], xs[9]);
+    ENSURE(js.size() == (shortest ? 1 : 9));
+    ENSURE(!shortest || *js[0] == 10);
+    ENSURE(explain_eq(g, xs[9], xs[0]) == js);
+    ENSURE(get_stat(g, "euf explain cache hits") == 1);
+
+    g.push();
+    g.merge(xs[9], ny, justifications + 11);
+    g.propagate();
+    js = explain_eq(g, xs[0], ny);
+    ENSURE(js.size() == (shortest ? 2 : 10) && *js.back() == 11);
+    g.pop(1);
+    // the cached explanation is removed with the merge it uses.
+    g.push();
+    g.merge(xs[9], ny, justifications + 12);
+    g.propagate();
+    js = explain_eq(g, xs[0], ny);
+    ENSURE(js.size() == (shortest ? 2 : 10) && *js.back() == 12);
+    g.pop(1);
+}
+
 void tst_egraph() {
     enable_trace("euf");
+    test4(false);
+    test4(true);
     test3();
     test1();
     test2();
@@ -0,0 +1,76 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    ematch_threads.cpp
+
+Abstract:
+
+    Test that E-matching in the new core produces the same instances
+    independently of the number of matching threads.
+
+--*/
+#include "api/z3.h"
+#include "util/debug.h"
+#include <cstring>
+#include <sstream>
+#include <string>
+
+// the input only contains applications of f to n constants. The instances
+// of the patterns on f add applications of g, h and k to all of them, which
+// are matched together in the next round on several threads.
+static std::string mk_ematch_threads_spec(unsigned n) {
+    std::ostringstream strm;
+    strm << "(declare-sort U 0)\n"
+            "(declare-fun f (U) U)\n"
+            "(declare-fun g (U) U)\n"
+            "(declare-fun h (U) U)\n"
+            "(declare-fun k (U) U)\n"
+            "(declare-const a U)\n"
+            "(assert (forall ((x U)) (! (= (f x) (g x)) :pattern ((f x)))))\n"
+            "(assert (forall ((x U)) (! (= (f x) (h x)) :pattern ((f x)))))\n"
+            "(assert (forall ((x U)) (! (= (f x) (k x)) :pattern ((f x)))))\n"
+            "(assert (forall ((x U)) (! (= (g x) (h x)) :pattern ((g x)))))\n"
+            "(assert (forall ((x U)) (! (= (h x) (k x)) :pattern ((h x)))))\n"
+            "(assert (forall ((x U)) (! (not (= (k x) a)) :pattern ((k x)))))\n";
+    for (unsigned i = 0; i < n; ++i)
+        strm << "(declare-const c" << i << " U)\n";
+    strm << "(assert (or";
+    for (unsigned i = 0; i < n; ++i)
+        strm << " (= (f c" << i << ") a)";
+    strm << "))\n";
+    return strm.str();
+}
+
+static unsigned num_instances(char const* threads) {
+    Z3_global_param_set("sat.euf", "true");
+    Z3_global_param_set("smt.qi.ematch_threads", threads);
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_solver s = Z3_mk_solver(ctx);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_solver_from_string(ctx, s, mk_ematch_threads_spec(100).c_str());
+    ENSURE(Z3_solver_check(ctx, s) == Z3_L_FALSE);
+    Z3_stats st = Z3_solver_get_statistics(ctx, s);
+    Z3_stats_inc_ref(ctx, st);
+    unsigned n = 0;
+    // E-matching propagates instances as units and conflicts or queues them.
+    for (unsigned i = 0; i < Z3_stats_size(ctx, st); ++i) {
+        char const* key = Z3_stats_get_key(ctx, st, i);
+        if (strcmp(key, "q units") == 0 || strcmp(key, "q conflicts") == 0 || strcmp(key, "q instantiations") == 0)
+            n += Z3_stats_get_uint_value(ctx, st, i);
+    }
+    Z3_stats_dec_ref(ctx, st);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+    Z3_global_param_reset_all();
+    return n;
+}
+
+void tst_ematch_threads() {
+    unsigned n1 = num_instances("1");
+    ENSURE(n1 > 0);
+    ENSURE(num_instances("0") == n1);
+    ENSURE(num_instances("2") == n1);
+    ENSURE(num_instances("4") == n1);
+}
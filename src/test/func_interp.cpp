@@ -0,0 +1,83 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    func_interp.cpp
+
+Abstract:
+
+    Test lookups in function interpretations with many entries.
+
+--*/
+#include "model/func_interp.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+
+void tst_func_interp() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * sI = a.mk_int();
+    unsigned n = 1000;
+    expr_ref_vector nums(m);
+    for (unsigned i = 0; i <= n; ++i)
+        nums.push_back(a.mk_int(i));
+
+    func_interp * fi = alloc(func_interp, m, 2);
+    for (unsigned i = 0; i < n; ++i) {
+        expr * args[2] = { nums.get(i), nums.get(i % 7) };
+        fi->insert_entry(args, nums.get(i + 1));
+    }
+    ENSURE(fi->num_entries() == n);
+    for (unsigned i = 0; i < n; ++i) {
+        expr * args[2] = { nums.get(i), nums.get(i % 7) };
+        func_entry * e = fi->get_entry(args);
+        ENSURE(e && e->get_result() == nums.get(i + 1));
+        expr * other[2] = { nums.get(i), nums.get((i + 1) % 7) };
+        ENSURE(!fi->get_entry(other));
+    }
+
+    // overwrite existing entries.
+    for (unsigned i = 0; i < n; i += 2) {
+        expr * args[2] = { nums.get(i), nums.get(i % 7) };
+        fi->insert_entry(args, nums.get(0));
+    }
+    ENSURE(fi->num_entries() == n);
+
+    // compress removes the entries that agree with the else branch.
+    fi->set_else(nums.get(0));
+    fi->compress();
+    ENSURE(fi->num_entries() == n / 2);
+    for (unsigned i = 0; i < n; ++i) {
+        expr * args[2] = { nums.get(i), nums.get(i % 7) };
+        func_entry * e = fi->get_entry(args);
+        ENSURE((i % 2 == 0) == (e == nullptr));
+    }
+
+    fi->del_entry(0);
+    ENSURE(fi->num_entries() == n / 2 - 1);
+    unsigned found = 0;
+    for (unsigned i = 1; i < n; i += 2) {
+        expr * args[2] = { nums.get(i), nums.get(i % 7) };
+        if (fi->get_entry(args))
+            ++found;
+    }
+    ENSURE(found == n / 2 - 1);
+
+    // the else branch is decomposed into entries.
+    func_interp * gi = alloc(func_interp, m, 1);
+    expr_ref e(nums.get(0), m);
+    expr_ref x(m.mk_var(0, sI), m);
+    for (unsigned i = 1; i <= 100; ++i)
+        e = m.mk_ite(m.mk_eq(x, nums.get(i)), nums.get(i - 1), e);
+    gi->set_else(e);
+    ENSURE(gi->num_entries() == 100);
+    for (unsigned i = 1; i <= 100; ++i) {
+        expr * arg = nums.get(i);
+        func_entry * fe = gi->get_entry(&arg);
+        ENSURE(fe && fe->get_result() == nums.get(i - 1));
+    }
+    dealloc(fi);
+    dealloc(gi);
+}
@@ -2210,6 +2210,7 @@ void setup_args_parser(argument_parser & parser) {
     parser.add_option_with_help_string("--test_mpq_np", "test rationals");
     parser.add_option_with_help_string("--test_mpq_np_plus", "test rationals using plus instead of +=");
     parser.add_option_with_help_string("--maximize_term", "test maximize_term()");
+    parser.add_option_with_help_string("--simplex_doubles", "test the presolve with doubles in lar_solver");
 }
 
 struct fff { int a; int b;};
@@ -3004,6 +3005,93 @@ void test_evidence_for_total_inf_simple(argument_parser & args_parser) {
     std::unordered_map<var_index, mpq> model;
     lp_assert(solver.get_status() == lp_status::INFEASIBLE);
 }
+// random systems of terms with bounds are solved with and without the
+// presolve in doubles, the results have to agree. The bounds of the terms
+// are taken around their values at a random point of the box of the
+// variables, so the first system is feasible, and the tighter bounds added
+// after the push may cut the point off.
+lp_status solve_random_lar_system(unsigned seed, bool doubles, unsigned & presolves, unsigned & fallbacks, lp_status & st2) {
+    lar_solver solver;
+    solver.settings().set_simplex_doubles(doubles);
+    random_gen r(seed);
+    unsigned n = 20, m = 30;
+    vector<var_index> vars;
+    vector<mpq> point;
+    for (unsigned j = 0; j < n; j++) {
+        var_index v = solver.add_var(j, false);
+        vars.push_back(v);
+        int lo = static_cast<int>(r(20)) - 10, hi = static_cast<int>(r(20)) + 10;
+        solver.add_var_bound(v, GE, mpq(lo));
+        solver.add_var_bound(v, LE, mpq(hi));
+        point.push_back(mpq(lo + static_cast<int>(r(hi - lo + 1))));
+    }
+    vector<std::pair<mpq, var_index>> ls;
+    vector<var_index> terms;
+    vector<mpq> values;
+    for (unsigned i = 0; i < m; i++) {
+        ls.reset();
+        mpq value(0);
+        unsigned sz = 3 + r(5);
+        for (unsigned k = 0; k < sz; k++) {
+            unsigned j = r(n);
+            bool found = false;
+            for (auto const& p : ls)
+                found |= p.second == vars[j];
+            if (found)
+                continue;
+            mpq a(static_cast<int>(r(19)) - 9, 1 + r(3));
+            ls.push_back(std::make_pair(a, vars[j]));
+            value += a * point[j];
+        }
+        terms.push_back(solver.add_term(ls, n + i));
+        values.push_back(value);
+    }
+    // the slack of a bound is in [-slack_neg, slack_pos]
+    auto add_bounds = [&](unsigned slack_neg, unsigned slack_pos) {
+        for (unsigned i = 0; i < m; i++) {
+            mpq slack(static_cast<int>(r(slack_neg + slack_pos + 1)) - static_cast<int>(slack_neg), 1 + r(2));
+            if (r(2))
+                solver.add_var_bound(terms[i], GE, values[i] - slack);
+            else
+                solver.add_var_bound(terms[i], LE, values[i] + slack);
+        }
+    };
+    add_bounds(0, 10);
+    lp_status st = solver.find_feasible_solution();
+    if (st == lp_status::OPTIMAL)
+        ENSURE(solver.ax_is_correct());
+    solver.push();
+    add_bounds(3, 10);
+    st2 = solver.find_feasible_solution();
+    if (st2 == lp_status::OPTIMAL)
+        ENSURE(solver.ax_is_correct());
+    solver.pop(1);
+    lp_status st3 = solver.find_feasible_solution();
+    ENSURE(st3 == st);
+    presolves += solver.settings().stats().m_double_presolve;
+    fallbacks += solver.settings().stats().m_double_presolve_fallbacks;
+    return st;
+}
+
+void test_simplex_doubles() {
+    unsigned presolves = 0, fallbacks = 0, num_feasible_push = 0;
+    for (unsigned seed = 0; seed < 8; seed++) {
+        unsigned dummy = 0;
+        lp_status st1_push, st2_push;
+        lp_status st1 = solve_random_lar_system(seed, false, dummy, dummy, st1_push);
+        lp_status st2 = solve_random_lar_system(seed, true, presolves, fallbacks, st2_push);
+        ENSURE(st1 == st2);
+        ENSURE(st1_push == st2_push);
+        num_feasible_push += st1_push == lp_status::OPTIMAL;
+    }
+    std::cout << "presolves: " << presolves << ", fallbacks: " << fallbacks
+              << ", feasible after push: " << num_feasible_push << "\n";
+    // the presolve was used, and the rational tableau could always be
+    // pivoted to the basis found in doubles.
+    ENSURE(presolves > 0);
+    ENSURE(fallbacks == 0);
+}
+
 void test_bound_propagation_one_small_sample1() {
     /*
       (<= (+ a (* (- 1.0) b)) 0.0)
@@ -4074,6 +4162,11 @@ void test_lp_local(int argn, char**argv) {
         ret = 0;
         return finalize(ret);
     }
+    if (args_parser.option_is_used("--simplex_doubles")) {
+        test_simplex_doubles();
+        ret = 0;
+        return finalize(ret);
+    }
     unsigned max_iters;
     unsigned time_limit;
     get_time_limit_and_max_iters_from_parser(args_parser, time_limit, max_iters);
@@ -157,6 +157,7 @@ int main(int argc, char ** argv) {
     TST(inf_rational);
     TST(ast);
     TST(optional);
+    TST(opt_parallel);
     TST(bit_vector);
     TST(fixed_bit_vector);
     TST(tbv);
@@ -187,6 +188,9 @@ int main(int argc, char ** argv) {
     TST(mpf);
     TST(total_order);
     TST(dl_table);
+    TST(dl_leapfrog);
+    TST(spacer_parallel);
+    TST(spacer_lemma_db);
     TST(dl_context);
     TST(dl_util);
     TST(dl_product_relation);
@@ -203,6 +207,7 @@ int main(int argc, char ** argv) {
     TST(arith_rewriter);
     TST(check_assumptions);
     TST(smt_context);
+    TST(trail);
     TST(theory_dl);
     TST(model_retrieval);
     TST(model_based_opt);
@@ -246,16 +251,24 @@ int main(int argc, char ** argv) {
     TST(expr_substitution);
     TST(sorting_network);
     TST(theory_pb);
+    TST(theory_str_cache);
     TST(simplex);
     TST(sat_user_scope);
+    TST(sat_parallel);
+    TST(parallel_tactic);
     TST_ARGV(ddnf);
     TST(ddnf1);
     TST(model_evaluator);
+    TST(func_interp);
     TST(get_consequences);
     TST(pb2bv);
     TST_ARGV(sat_lookahead);
     TST_ARGV(sat_local_search);
     TST_ARGV(cnf_backbones);
+    TST_ARGV(sat_bench);
+    TST_ARGV(trail_bench);
+    TST_ARGV(dl_leapfrog_bench);
+    TST_ARGV(rational_threads_bench);
     TST(bdd);
     TST(pdd);
     TST(pdd_solver);
@@ -265,4 +278,9 @@ int main(int argc, char ** argv) {
     TST(polysat);
     TST_ARGV(polysat_argv);
     TST(fixplex);
+    TST(marshal);
+    TST(rewrite_cache);
+    TST(mapped_file);
+    TST(qi_profile);
+    TST(ematch_threads);
 }
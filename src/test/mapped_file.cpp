@@ -0,0 +1,84 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    mapped_file.cpp
+
+Abstract:
+
+    Test reading files through memory mapped windows.
+
+--*/
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "util/mapped_file.h"
+#include "util/rlimit.h"
+#include "sat/dimacs.h"
+#include "sat/sat_solver.h"
+
+static char const * s_file = "mapped_file_test.cnf";
+
+static std::string mk_cnf(unsigned num_clauses) {
+    std::ostringstream out;
+    out << "c random clauses\np cnf 1000 " << num_clauses << "\n";
+    random_gen r(0);
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        if (i % 97 == 0)
+            out << "c comment " << i << "\n";
+        for (unsigned j = 0; j < 3; ++j)
+            out << (r(2) ? "-" : "") << (1 + r(1000)) << " ";
+        out << "0\n";
+    }
+    return out.str();
+}
+
+static void write_file(std::string const & content) {
+    std::ofstream out(s_file, std::ios::binary);
+    out << content;
+}
+
+// windows are page aligned, a small window size spans many windows.
+static void tst_windows(std::string const & content) {
+    mapped_file f(s_file, 1);
+    ENSURE(f.is_open());
+    std::string r;
+    char const * begin, * end;
+    unsigned num_windows = 0;
+    while (f.next(begin, end)) {
+        r.append(begin, end);
+        ++num_windows;
+    }
+    ENSURE(r == content);
+    ENSURE(num_windows > 1);
+
+    mapped_file f2(s_file, 1);
+    mapped_file_streambuf buf(f2);
+    std::istream in(&buf);
+    std::string r2((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ENSURE(r2 == content);
+}
+
+static void tst_dimacs(std::string const & content) {
+    reslimit limit;
+    params_ref p;
+    sat::solver s1(p, limit), s2(p, limit);
+    std::istringstream in(content);
+    ENSURE(parse_dimacs(in, std::cerr, s1));
+    mapped_file f(s_file, 1);
+    ENSURE(parse_dimacs(f, std::cerr, s2));
+    ENSURE(s1.num_vars() == s2.num_vars());
+    ENSURE(s1.num_clauses() == s2.num_clauses());
+    std::cout << "vars: " << s1.num_vars() << " clauses: " << s1.num_clauses() << "\n";
+}
+
+void tst_mapped_file() {
+    std::string content = mk_cnf(5000);
+    write_file(content);
+    tst_windows(content);
+    tst_dimacs(content);
+    mapped_file missing("mapped_file_test_missing.cnf");
+    ENSURE(!missing.is_open());
+    std::remove(s_file);
+}
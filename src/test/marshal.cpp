@@ -0,0 +1,106 @@
+/*++
+Copyright (c) 2021 Microsoft Corporation
+
+Module Name:
+
+    marshal.cpp
+
+Abstract:
+
+    Test binary marshaling of expressions
+
+--*/
+#include "parsers/smt2/marshal.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/array_decl_plugin.h"
+#include "ast/fpa_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+#include <sstream>
+
+static void check_roundtrip(ast_manager & m, expr * t) {
+    expr_ref e(t, m);
+    std::string s = marshal(e, m);
+    ast_manager m2;
+    expr_ref r = unmarshal(s, m2);
+    ENSURE(r);
+    std::ostringstream s1, s2;
+    s1 << mk_pp(e, m);
+    s2 << mk_pp(r, m2);
+    ENSURE(s1.str() == s2.str());
+    // unmarshaling into the original manager yields the same term
+    ENSURE(unmarshal(s, m).get() == e);
+}
+
+static void tst_marshal_terms() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    bv_util bv(m);
+    array_util ar(m);
+    fpa_util fp(m);
+
+    sort_ref U(m.mk_uninterpreted_sort(symbol("U")), m);
+    sort* dom[2] = { U.get(), a.mk_int() };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 2, dom, a.mk_int()), m);
+    expr_ref u(m.mk_const(symbol("u"), U), m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref y(m.mk_const(symbol(3), a.mk_real()), m);
+    expr_ref fx(m.mk_app(f, u.get(), x.get()), m);
+    check_roundtrip(m, a.mk_le(a.mk_add(fx, a.mk_int(rational("123456789012345678901234567890"))), a.mk_int(-7)));
+    check_roundtrip(m, a.mk_lt(y, a.mk_numeral(rational(1, 3), false)));
+
+    sort_ref bv32(bv.mk_sort(32), m);
+    expr_ref b(m.mk_const(symbol("b"), bv32), m);
+    check_roundtrip(m, m.mk_eq(bv.mk_bv_add(b, bv.mk_numeral(rational(5), 32)), bv.mk_extract(35, 4, bv.mk_concat(b, b))));
+
+    sort_ref arr(ar.mk_array_sort(a.mk_int(), bv32), m);
+    expr_ref A(m.mk_const(symbol("A"), arr), m);
+    expr* sel_args[2] = { A.get(), x.get() };
+    check_roundtrip(m, m.mk_eq(ar.mk_select(2, sel_args), b));
+
+    sort_ref fps(fp.mk_float_sort(8, 24), m);
+    expr_ref fz(m.mk_const(symbol("fz"), fps), m);
+    scoped_mpf v(fp.fm());
+    fp.fm().set(v, 8, 24, 1.5);
+    check_roundtrip(m, fp.mk_float_eq(fz, fp.mk_value(v)));
+
+    sort* qs[1] = { a.mk_int() };
+    symbol qn[1] = { symbol("z") };
+    expr_ref body(a.mk_ge(m.mk_var(0, a.mk_int()), x), m);
+    check_roundtrip(m, m.mk_forall(1, qs, qn, body, 0, symbol("q1")));
+}
+
+static void tst_marshal_dag() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    // x_{i+1} = x_i + x_i has exponential tree size, linear DAG size.
+    expr_ref t(m.mk_const(symbol("x"), a.mk_int()), m);
+    for (unsigned i = 0; i < 1000; ++i)
+        t = a.mk_add(t, t);
+    t = m.mk_eq(t, a.mk_int(0));
+    std::string s = marshal(t, m);
+    ENSURE(s.size() < 10000);
+    ENSURE(unmarshal(s, m).get() == t.get());
+}
+
+static void tst_marshal_legacy() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref e(a.mk_le(x, a.mk_int(3)), m);
+    std::ostringstream out;
+    marshal_smt2(out, e, m);
+    ENSURE(unmarshal(out.str(), m).get() == e.get());
+    std::string s = marshal(e, m);
+    ENSURE(!unmarshal(s.substr(0, s.size() - 2), m));
+}
+
+void tst_marshal() {
+    tst_marshal_terms();
+    tst_marshal_dag();
+    tst_marshal_legacy();
+}
@@ -503,10 +503,75 @@ static void tst_pw2() {
     }
 }
 
+// arithmetic around the boundaries of the range of small numbers.
+static void tst_small_range() {
+    unsynch_mpz_manager m;
+    scoped_mpz a(m), b(m), c(m), d(m), e(m);
+    int64_t const max_small = (static_cast<int64_t>(1) << 61) - 1;
+    int64_t const vals[] = { 0, 1, -1, 7, INT_MAX, INT_MIN, static_cast<int64_t>(INT_MAX) + 1, 
+                             static_cast<int64_t>(UINT_MAX), static_cast<int64_t>(UINT_MAX) + 1, -static_cast<int64_t>(UINT_MAX) - 1,
+                             3037000500ll, -3037000500ll, max_small, -max_small, max_small + 1, -max_small - 1,
+                             INT64_MAX, INT64_MIN + 1, INT64_MIN };
+    for (int64_t x : vals) {
+        m.set(a, x);
+        m.set(c, std::to_string(x).c_str());
+        ENSURE(m.eq(a, c));
+        ENSURE(m.is_small(a) == m.is_small(c));
+        ENSURE(m.hash(a) == m.hash(c));
+        ENSURE(m.is_int64(a) && m.get_int64(a) == x);
+        m.set(c, a);
+        m.neg(c);
+        m.neg(c);
+        ENSURE(m.eq(a, c) && m.is_small(a) == m.is_small(c));
+        for (int64_t y : vals) {
+            m.set(b, y);
+            // (x + y) - y = x
+            m.add(a, b, c);
+            m.sub(c, b, d);
+            ENSURE(m.eq(d, a) && m.is_small(d) == m.is_small(a));
+            if (y == 0)
+                continue;
+            // (x * y) / y = x
+            m.mul(a, b, c);
+            m.machine_div(c, b, d);
+            ENSURE(m.eq(d, a) && m.is_small(d) == m.is_small(a));
+            // x = (x div y) * y + (x rem y)
+            m.machine_div_rem(a, b, d, e);
+            m.mul(d, b, c);
+            m.add(c, e, c);
+            ENSURE(m.eq(c, a));
+            m.gcd(a, b, c);
+            ENSURE(m.divides(c, a) && m.divides(c, b));
+        }
+    }
+    m.set(a, max_small);
+    m.mul(a, a, c);
+    m.set(d, "5316911983139663487003542222693990401");
+    ENSURE(m.eq(c, d));
+    m.set(a, static_cast<int64_t>(3037000500ll));
+    m.mul(a, a, c);
+    m.set(d, "9223372037000250000");
+    ENSURE(m.eq(c, d));
+    m.mul2k(a, 30, c);
+    m.set(d, "3260954456358912000");
+    ENSURE(m.eq(c, d));
+    m.machine_div2k(c, 30);
+    ENSURE(m.eq(c, a) && m.is_small(c));
+    // powers of two are small exactly when set would make them small.
+    for (unsigned p = 30; p <= 62; ++p) {
+        m.power(mpz(2), p, a);
+        m.set(c, static_cast<uint64_t>(1) << p);
+        ENSURE(m.eq(a, c));
+        ENSURE(m.is_small(a) == m.is_small(c));
+        ENSURE(m.hash(a) == m.hash(c));
+    }
+}
+
 void tst_mpz() {
     disable_trace("mpz");
     enable_trace("mpz_2k");
     tst_pw2();
+    tst_small_range();
     tst5();
     tst_div2k_bug();
     rand_tst_gcd(50, 3, 2);
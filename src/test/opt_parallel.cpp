@@ -0,0 +1,93 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    opt_parallel.cpp
+
+Abstract:
+
+    Test box and pareto optimization on several threads.
+
+--*/
+#include "api/z3.h"
+#include "util/debug.h"
+#include <string>
+#include <vector>
+
+static char const* box_problem =
+    "(declare-const x Int)\n"
+    "(declare-const y Int)\n"
+    "(declare-const z Int)\n"
+    "(assert (and (<= 0 x) (<= 0 y) (<= 0 z)))\n"
+    "(assert (<= (+ x y z) 10))\n"
+    "(assert (<= (+ x (* 2 y)) 14))\n"
+    "(maximize x)\n"
+    "(maximize (+ y z))\n"
+    "(minimize (- x z))\n"
+    "(assert-soft (> x 7) :id goal)\n"
+    "(assert-soft (> y 7) :id goal)\n";
+
+static char const* pareto_problem =
+    "(declare-const x Int)\n"
+    "(declare-const y Int)\n"
+    "(assert (and (<= 0 x) (<= x 6) (<= 0 y) (<= y 6)))\n"
+    "(assert (<= (+ x y) 7))\n"
+    "(maximize x)\n"
+    "(maximize y)\n";
+
+static Z3_optimize mk_optimize(Z3_context ctx, char const* problem, char const* priority, unsigned threads) {
+    Z3_optimize opt = Z3_mk_optimize(ctx);
+    Z3_optimize_inc_ref(ctx, opt);
+    Z3_params p = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, p);
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "priority"), Z3_mk_string_symbol(ctx, priority));
+    Z3_params_set_uint(ctx, p, Z3_mk_string_symbol(ctx, "objective_threads"), threads);
+    Z3_optimize_set_params(ctx, opt, p);
+    Z3_params_dec_ref(ctx, p);
+    Z3_optimize_from_string(ctx, opt, problem);
+    return opt;
+}
+
+static std::vector<std::string> box_values(unsigned threads) {
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_optimize opt = mk_optimize(ctx, box_problem, "box", threads);
+    ENSURE(Z3_optimize_check(ctx, opt, 0, nullptr) == Z3_L_TRUE);
+    Z3_ast_vector objs = Z3_optimize_get_objectives(ctx, opt);
+    Z3_ast_vector_inc_ref(ctx, objs);
+    std::vector<std::string> values;
+    for (unsigned i = 0; i < Z3_ast_vector_size(ctx, objs); ++i) {
+        values.push_back(Z3_ast_to_string(ctx, Z3_optimize_get_lower(ctx, opt, i)));
+        values.push_back(Z3_ast_to_string(ctx, Z3_optimize_get_upper(ctx, opt, i)));
+    }
+    Z3_ast_vector_dec_ref(ctx, objs);
+    Z3_optimize_dec_ref(ctx, opt);
+    Z3_del_context(ctx);
+    return values;
+}
+
+static unsigned pareto_front_size(unsigned threads) {
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_optimize opt = mk_optimize(ctx, pareto_problem, "pareto", threads);
+    unsigned n = 0;
+    while (Z3_optimize_check(ctx, opt, 0, nullptr) == Z3_L_TRUE) {
+        Z3_model mdl = Z3_optimize_get_model(ctx, opt);
+        Z3_model_inc_ref(ctx, mdl);
+        Z3_model_dec_ref(ctx, mdl);
+        ++n;
+    }
+    Z3_optimize_dec_ref(ctx, opt);
+    Z3_del_context(ctx);
+    return n;
+}
+
+void tst_opt_parallel() {
+    std::vector<std::string> seq = box_values(1);
+    std::vector<std::string> par = box_values(3);
+    ENSURE(seq.size() == 8);
+    ENSURE(seq == par);
+
+    // the front of x + y <= 7 within [0,6] x [0,6] has 6 points.
+    ENSURE(pareto_front_size(1) == 6);
+    ENSURE(pareto_front_size(3) == 6);
+}
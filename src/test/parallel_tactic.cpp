@@ -0,0 +1,70 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    parallel_tactic.cpp
+
+Abstract:
+
+    Stress the task queue of the parallel tactic with many small cubes.
+
+--*/
+#include "api/z3.h"
+#include "util/debug.h"
+#include <sstream>
+#include <string>
+
+// pigeons into holes, unsatisfiable if there are more pigeons than holes.
+static std::string mk_pigeon_hole(unsigned pigeons, unsigned holes) {
+    std::ostringstream strm;
+    for (unsigned i = 0; i < pigeons; ++i)
+        for (unsigned j = 0; j < holes; ++j)
+            strm << "(declare-const p" << i << "_" << j << " Bool)\n";
+    for (unsigned i = 0; i < pigeons; ++i) {
+        strm << "(assert (or";
+        for (unsigned j = 0; j < holes; ++j)
+            strm << " p" << i << "_" << j;
+        strm << "))\n";
+    }
+    for (unsigned j = 0; j < holes; ++j)
+        for (unsigned i = 0; i < pigeons; ++i)
+            for (unsigned k = i + 1; k < pigeons; ++k)
+                strm << "(assert (not (and p" << i << "_" << j << " p" << k << "_" << j << ")))\n";
+    return strm.str();
+}
+
+static Z3_lbool check_parallel(unsigned pigeons, unsigned holes) {
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_tactic t = Z3_mk_tactic(ctx, "psat");
+    Z3_tactic_inc_ref(ctx, t);
+    Z3_solver s = Z3_mk_solver_from_tactic(ctx, t);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_ast_vector fmls = Z3_parse_smtlib2_string(ctx, mk_pigeon_hole(pigeons, holes).c_str(), 0, nullptr, nullptr, 0, nullptr, nullptr);
+    Z3_ast_vector_inc_ref(ctx, fmls);
+    for (unsigned i = 0; i < Z3_ast_vector_size(ctx, fmls); ++i)
+        Z3_solver_assert(ctx, s, Z3_ast_vector_get(ctx, fmls, i));
+    Z3_lbool r = Z3_solver_check(ctx, s);
+    Z3_ast_vector_dec_ref(ctx, fmls);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_tactic_dec_ref(ctx, t);
+    Z3_del_context(ctx);
+    return r;
+}
+
+void tst_parallel_tactic() {
+    // cube early and conquer the cubes one by one, so that many small tasks
+    // are created and finished while other workers are adding new ones.
+    Z3_global_param_set("parallel.conquer.batch_size", "1");
+    Z3_global_param_set("parallel.conquer.delay", "0");
+    for (unsigned round = 0; round < 5; ++round) {
+        for (unsigned n = 3; n <= 6; ++n) {
+            Z3_lbool unsat = check_parallel(n + 1, n);
+            Z3_lbool sat = check_parallel(n, n);
+            ENSURE(unsat == Z3_L_FALSE);
+            ENSURE(sat == Z3_L_TRUE);
+        }
+    }
+    Z3_global_param_set("parallel.conquer.batch_size", "100");
+    Z3_global_param_set("parallel.conquer.delay", "10");
+}
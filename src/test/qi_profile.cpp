@@ -0,0 +1,45 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    qi_profile.cpp
+
+Abstract:
+
+    Test the profile of quantifier instantiation exposed over the API.
+
+--*/
+#include "api/z3.h"
+#include "util/debug.h"
+#include <cstring>
+#include <iostream>
+
+static char const* qi_profile_spec =
+    "(declare-fun f (Int) Int)\n"
+    "(declare-const a Int)\n"
+    "(assert (forall ((x Int)) (! (> (f x) x) :pattern ((f x)) :qid ax)))\n"
+    "(assert (< (f a) a))\n";
+
+void tst_qi_profile() {
+    Z3_global_param_set("smt.qi.profile", "true");
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_solver s = Z3_mk_simple_solver(ctx);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_solver_from_string(ctx, s, qi_profile_spec);
+    ENSURE(Z3_solver_check(ctx, s) == Z3_L_FALSE);
+
+    std::string json = Z3_solver_get_qi_profile(ctx, s, "json");
+    std::cout << json;
+    ENSURE(json.find("\"qid\": \"ax\", \"matches\": 1, \"instances\": 1") != std::string::npos);
+    ENSURE(json.find("\"mam\": [\n    {\"head\": \"f\"") != std::string::npos);
+
+    std::string csv = Z3_solver_get_qi_profile(ctx, s, "csv");
+    std::cout << csv;
+    ENSURE(csv.find("kind,name,pattern,matches,instances") == 0);
+    ENSURE(csv.find("pattern,\"ax\",\"{(f x!0)}\",1,1") != std::string::npos);
+
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+    Z3_global_param_reset_all();
+}
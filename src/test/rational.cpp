@@ -22,6 +22,11 @@ Revision History:
 #include "util/trace.h"
 #include "util/ext_gcd.h"
 #include "util/timeit.h"
+#include "util/stopwatch.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <thread>
 
 static void tst1() {
     rational r1(1);
@@ -466,6 +471,84 @@ static void tst12() {
         std::cout << i << ": " << r.get_bit(i) << "\n";
 }
 
+#ifndef SINGLE_THREAD
+// Gaussian elimination over the rationals, the core of a simplex pivot.
+// The entries grow beyond machine words after a few rows.
+static rational eliminate(unsigned seed, unsigned n) {
+    vector<vector<rational>> a;
+    for (unsigned i = 0; i < n; ++i) {
+        a.push_back(vector<rational>());
+        for (unsigned j = 0; j < n; ++j)
+            a[i].push_back(rational(static_cast<int>((seed + 7 * i * i + 13 * j) % 19) - 9, 1 + (i + j + seed) % 5));
+        a[i][i] += rational(n);
+    }
+    for (unsigned k = 0; k < n; ++k) {
+        for (unsigned i = k + 1; i < n; ++i) {
+            rational f = a[i][k] / a[k][k];
+            for (unsigned j = k; j < n; ++j)
+                a[i][j] -= f * a[k][j];
+        }
+    }
+    rational det(1);
+    for (unsigned k = 0; k < n; ++k)
+        det *= a[k][k];
+    return det;
+}
+
+// eliminate on num_threads matrices, on one thread or on one thread per matrix.
+static void eliminate_all(unsigned num_threads, unsigned n, bool parallel, vector<rational>& results) {
+    results.reset();
+    results.resize(num_threads);
+    if (!parallel) {
+        for (unsigned i = 0; i < num_threads; ++i)
+            results[i] = eliminate(i, n);
+        return;
+    }
+    vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i)
+        threads.push_back(std::thread([&, i]() { results[i] = eliminate(i, n); }));
+    for (auto& th : threads)
+        th.join();
+}
+
+// rationals share a single numeral manager, threads must not interfere
+// with each other's temporaries.
+static void tst13() {
+    vector<rational> expected, results;
+    eliminate_all(4, 10, false, expected);
+    eliminate_all(4, 10, true, results);
+    for (unsigned i = 0; i < expected.size(); ++i)
+        ENSURE(results[i] == expected[i]);
+}
+#endif
+
+// row updates r <- r - f * p of a pivot step with coefficients that need
+// more than 32 bits, as produced by bit-vector to integer conversions.
+static void tst14() {
+    unsigned const n = 1000;
+    unsigned const num_rounds = 2000;
+    svector<int64_t> pi, ri;
+    vector<rational> p, r, out;
+    for (unsigned j = 0; j < n; ++j) {
+        pi.push_back(static_cast<int64_t>(rand()) << 20);
+        ri.push_back((static_cast<int64_t>(rand()) << 28) - rand());
+        p.push_back(rational(pi[j], rational::i64()));
+        r.push_back(rational(ri[j], rational::i64()));
+        out.push_back(rational::zero());
+    }
+    {
+        timeit t(true, "pivot rows with 64 bit coefficients");
+        for (unsigned round = 0; round < num_rounds; ++round) {
+            rational f(static_cast<int>(round % 97) - 48);
+            for (unsigned j = 0; j < n; ++j)
+                out[j] = r[j] - f * p[j];
+        }
+    }
+    int64_t f = static_cast<int64_t>((num_rounds - 1) % 97) - 48;
+    for (unsigned j = 0; j < n; ++j)
+        ENSURE(out[j] == rational(ri[j] - f * pi[j], rational::i64()));
+}
+
 
 void tst_rational() {
     TRACE("rational", tout << "starting rational test...\n";);
@@ -492,4 +575,34 @@ void tst_rational() {
     tst10(true);
     tst10(false);
     tst12();
+    tst14();
+#ifndef SINGLE_THREAD
+    tst13();
+#endif
+}
+
+// Usage: test-z3 rational_threads_bench [<threads> [<n>]]
+void tst_rational_threads_bench(char ** argv, int argc, int& i) {
+#ifndef SINGLE_THREAD
+    unsigned num_threads = 4, n = 24;
+    // options of the form key=value are taken by the test driver.
+    if (i + 1 < argc && isdigit(argv[i + 1][0]))
+        num_threads = std::max(1, atoi(argv[++i]));
+    if (i + 1 < argc && isdigit(argv[i + 1][0]))
+        n = std::max(1, atoi(argv[++i]));
+    vector<rational> expected, results;
+    stopwatch sw;
+    sw.start();
+    eliminate_all(num_threads, n, false, expected);
+    sw.stop();
+    double seq_time = sw.get_seconds();
+    sw.reset();
+    sw.start();
+    eliminate_all(num_threads, n, true, results);
+    sw.stop();
+    for (unsigned j = 0; j < num_threads; ++j)
+        ENSURE(results[j] == expected[j]);
+    std::cout << "(rational-threads-bench :threads " << num_threads << " :n " << n
+              << " :sequential " << seq_time << " :parallel " << sw.get_seconds() << ")\n";
+#endif
 }
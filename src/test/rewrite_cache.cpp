@@ -0,0 +1,184 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.cpp
+
+Abstract:
+
+    Test the persistent cache of th_rewriter results.
+
+--*/
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/persistent_rewrite_cache.h"
+#include "ast/arith_decl_plugin.h"
+#include "math/polynomial/algebraic_numbers.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+static expr_ref mk_formula(ast_manager & m) {
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref y(m.mk_const(symbol("y"), a.mk_int()), m);
+    return expr_ref(a.mk_le(a.mk_add(x, a.mk_int(0), a.mk_mul(a.mk_int(2), y)), a.mk_add(y, a.mk_int(3))), m);
+}
+
+static std::string to_string(ast_manager & m, expr * e) {
+    std::ostringstream strm;
+    strm << mk_pp(e, m);
+    return strm.str();
+}
+
+static void tst_cache_file(char const * file) {
+    std::remove(file);
+    std::string expected;
+    {
+        ast_manager m;
+        reg_decl_plugins(m);
+        arith_util a(m);
+        persistent_rewrite_cache cache(m, file, 7);
+        expr_ref t = mk_formula(m), r(m);
+        ENSURE(!cache.find(t, r));
+        expr_ref s(a.mk_le(m.mk_const(symbol("x"), a.mk_int()), a.mk_int(3)), m);
+        cache.insert(t, s);
+        expected = to_string(m, s);
+        ENSURE(cache.find(t, r) && r == s);
+        // unchanged results are recorded as well
+        ENSURE(!cache.find(s, r));
+        cache.insert(s, s);
+        ENSURE(cache.find(s, r) && r == s);
+    }
+    {
+        // the cache is shared across managers through the file
+        ast_manager m;
+        reg_decl_plugins(m);
+        persistent_rewrite_cache cache(m, file, 7);
+        ENSURE(cache.size() == 2);
+        expr_ref r(m);
+        ENSURE(cache.find(mk_formula(m), r));
+        ENSURE(to_string(m, r) == expected);
+        // entries created with a different configuration are not used
+        persistent_rewrite_cache cache2(m, file, 8);
+        ENSURE(!cache2.find(mk_formula(m), r));
+    }
+    {
+        // a file that is not a cache is ignored and left untouched
+        FILE * f = fopen(file, "wb");
+        ENSURE(f);
+        fputs("garbage", f);
+        fclose(f);
+        ast_manager m;
+        reg_decl_plugins(m);
+        persistent_rewrite_cache cache(m, file, 7);
+        expr_ref t = mk_formula(m), r(m);
+        ENSURE(cache.size() == 0);
+        ENSURE(!cache.find(t, r));
+        cache.insert(t, t);
+    }
+    {
+        FILE * f = fopen(file, "rb");
+        ENSURE(f);
+        char buffer[16] = { 0 };
+        ENSURE(fread(buffer, 1, sizeof(buffer), f) == 7);
+        fclose(f);
+        ENSURE(strcmp(buffer, "garbage") == 0);
+    }
+    std::remove(file);
+}
+
+static void tst_shared_store(char const * file) {
+    std::remove(file);
+    ast_manager m1, m2;
+    reg_decl_plugins(m1);
+    reg_decl_plugins(m2);
+    expr_ref r1(m1), r2(m2);
+    persistent_rewrite_cache c1(m1, file, 7);
+    {
+        // caches on the same file share their entries, also across managers.
+        persistent_rewrite_cache c2(m2, file, 7);
+        expr_ref t1 = mk_formula(m1);
+        ENSURE(!c1.find(t1, r1));
+        c1.insert(t1, t1);
+        ENSURE(c2.size() == 1);
+        ENSURE(c2.find(mk_formula(m2), r2));
+        ENSURE(to_string(m2, r2) == to_string(m1, t1));
+        // appends are buffered until the last cache is closed or flushed.
+        FILE * f = fopen(file, "rb");
+        ENSURE(!f);
+    }
+    c1.flush();
+    FILE * f = fopen(file, "rb");
+    ENSURE(f);
+    fclose(f);
+
+    // terms that cannot be serialized are not cached.
+    arith_util a(m1);
+    scoped_anum v(a.am());
+    a.am().set(v, 2);
+    a.am().root(v, 2, v);
+    expr_ref sqrt2(a.mk_numeral(a.am(), v, false), m1);
+    expr_ref t(a.mk_le(sqrt2, m1.mk_const(symbol("x"), a.mk_real())), m1);
+    ENSURE(!c1.find(t, r1));
+    c1.insert(t, t);
+    ENSURE(c1.size() == 1);
+    ENSURE(c1.misses() == 1);
+    std::remove(file);
+}
+
+static void tst_th_rewriter(char const * file) {
+    std::remove(file);
+    params_ref p;
+    p.set_str("cache_file", file);
+    std::string expected;
+    {
+        ast_manager m;
+        reg_decl_plugins(m);
+        th_rewriter rw(m, p);
+        expr_ref r = mk_formula(m);
+        rw(r);
+        expected = to_string(m, r);
+    }
+    {
+        ast_manager m;
+        reg_decl_plugins(m);
+        th_rewriter rw(m, p);
+        expr_ref r = mk_formula(m);
+        rw(r);
+        ENSURE(to_string(m, r) == expected);
+    }
+    {
+        // the entries do not depend on the name of the file.
+        std::string copy = std::string(file) + ".copy";
+        std::ifstream in(file, std::ios::binary);
+        std::ofstream out(copy, std::ios::binary);
+        out << in.rdbuf();
+        out.close();
+        params_ref q;
+        q.set_str("cache_file", copy.c_str());
+        {
+            ast_manager m;
+            reg_decl_plugins(m);
+            th_rewriter rw(m, q);
+            expr_ref r = mk_formula(m);
+            rw(r);
+            ENSURE(to_string(m, r) == expected);
+        }
+        // the result was found in the copy, so nothing was appended to it.
+        std::ifstream in1(file, std::ios::binary | std::ios::ate), in2(copy, std::ios::binary | std::ios::ate);
+        ENSURE(in1.tellg() == in2.tellg());
+        in2.close();
+        std::remove(copy.c_str());
+    }
+    std::remove(file);
+}
+
+void tst_rewrite_cache() {
+    tst_cache_file("tst_rewrite_cache.bin");
+    tst_shared_store("tst_rewrite_cache.bin");
+    tst_th_rewriter("tst_rewrite_cache.bin");
+}
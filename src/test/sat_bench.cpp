@@ -0,0 +1,306 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    sat_bench.cpp
+
+Abstract:
+
+    Microbenchmarks for the SAT solver hot paths: unit propagation and the
+    watch-list traversal, clause garbage collection and defragmentation,
+    and conflict driven search. Instances are generated in-process from a
+    seed, so runs are reproducible.
+
+    Usage: test-z3 sat_bench [seed=<n>] [scale=<n>] [filter=<name>]
+
+    Each benchmark prints a line of the form
+    (sat-bench :name <name> :vars <n> :clauses <n> :time <secs> ...)
+
+--*/
+#include "sat/sat_solver.h"
+#include "util/stopwatch.h"
+#include "util/statistics.h"
+#include "util/memory_manager.h"
+#include <cstring>
+#include <iomanip>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // expose the internal entry points that are measured.
+    class bench_solver : public sat::solver {
+    public:
+        bench_solver(params_ref const& p, reslimit& l): sat::solver(p, l) {}
+        using sat::solver::push;
+        using sat::solver::pop;
+        using sat::solver::gc_glue;
+        using sat::solver::defrag_clauses;
+        unsigned num_learned() const { return m_learned.size(); }
+        size_t clause_memory() const { return cls_allocator().get_allocation_size(); }
+    };
+
+    /**
+       \brief Count hardware cache misses of the current thread, if the
+       platform exposes performance counters.
+    */
+    class cache_miss_counter {
+        int m_fd { -1 };
+    public:
+        cache_miss_counter() {
+#ifdef __linux__
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+        ~cache_miss_counter() {
+#ifdef __linux__
+            if (m_fd >= 0) close(m_fd);
+#endif
+        }
+        bool available() const { return m_fd >= 0; }
+        void start() {
+#ifdef __linux__
+            if (m_fd < 0) return;
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+        unsigned long long stop() {
+            unsigned long long count = 0;
+#ifdef __linux__
+            if (m_fd < 0) return 0;
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &count, sizeof(count)) != sizeof(count))
+                count = 0;
+#endif
+            return count;
+        }
+    };
+
+    struct bench_config {
+        unsigned    m_seed { 0 };
+        unsigned    m_scale { 1 };
+        char const* m_filter { nullptr };
+    };
+
+    struct measurement {
+        stopwatch          m_watch;
+        cache_miss_counter m_misses;
+        unsigned long long m_num_misses { 0 };
+        void start() { m_misses.start(); m_watch.start(); }
+        void stop() { m_watch.stop(); m_num_misses = m_misses.stop(); }
+        double seconds() const { return m_watch.get_seconds(); }
+    };
+
+    typedef void (*generator)(bench_solver& s, random_gen& r, unsigned scale);
+
+    // random_gen produces 15 bits per call.
+    sat::bool_var rand_var(random_gen& r, unsigned num_vars) {
+        unsigned v = (static_cast<unsigned>(r()) << 15) | static_cast<unsigned>(r());
+        return v % num_vars;
+    }
+
+    sat::literal rand_lit(random_gen& r, unsigned num_vars) {
+        return sat::literal(rand_var(r, num_vars), r(2) == 0);
+    }
+
+    void mk_vars(bench_solver& s, unsigned n) {
+        for (unsigned i = 0; i < n; ++i)
+            s.mk_var(false, true);
+    }
+
+    // uniform random 3-SAT at the phase transition.
+    void gen_random3(bench_solver& s, random_gen& r, unsigned scale) {
+        unsigned n = 20000 * scale;
+        mk_vars(s, n);
+        unsigned m = static_cast<unsigned>(4.26 * n);
+        for (unsigned i = 0; i < m; ++i)
+            s.mk_clause(rand_lit(r, n), rand_lit(r, n), rand_lit(r, n));
+    }
+
+    // mostly binary clauses (implication chains) with some longer clauses.
+    void gen_binary(bench_solver& s, random_gen& r, unsigned scale) {
+        unsigned n = 50000 * scale;
+        mk_vars(s, n);
+        for (unsigned i = 0; i < 3 * n; ++i) {
+            sat::bool_var v = rand_var(r, n);
+            s.mk_clause(sat::literal(v, true), rand_lit(r, n));
+        }
+        sat::literal_vector lits;
+        for (unsigned i = 0; i < n / 4; ++i) {
+            lits.reset();
+            unsigned sz = 4 + r(8);
+            for (unsigned j = 0; j < sz; ++j)
+                lits.push_back(rand_lit(r, n));
+            s.mk_clause(lits);
+        }
+    }
+
+    /**
+       \brief Tseitin encoding of a random layered circuit of and/xor gates.
+       It resembles industrial instances: many short clauses with locality
+       between variables of neighboring layers.
+    */
+    void gen_circuit(bench_solver& s, random_gen& r, unsigned scale) {
+        unsigned width = 1000 * scale, depth = 40;
+        mk_vars(s, width * depth);
+        for (unsigned d = 1; d < depth; ++d) {
+            for (unsigned i = 0; i < width; ++i) {
+                sat::literal o(d * width + i, false);
+                unsigned lo = (d - 1) * width;
+                sat::literal a(lo + (i + r(16)) % width, r(2) == 0);
+                sat::literal b(lo + (i + width - r(16)) % width, r(2) == 0);
+                if (r(3) == 0) {
+                    // o = a xor b
+                    s.mk_clause(~o, a, b);
+                    s.mk_clause(~o, ~a, ~b);
+                    s.mk_clause(o, ~a, b);
+                    s.mk_clause(o, a, ~b);
+                }
+                else {
+                    // o = a and b
+                    s.mk_clause(~o, a);
+                    s.mk_clause(~o, b);
+                    s.mk_clause(o, ~a, ~b);
+                }
+            }
+        }
+        // constrain some outputs
+        for (unsigned i = 0; i < width; i += 7)
+            s.mk_clause(sat::literal((depth - 1) * width + i, r(2) == 0), sat::literal((depth - 1) * width + (i + 1) % width, false));
+    }
+
+    void report(char const* name, bench_solver& s, measurement const& m, char const* extra_key, double extra_value) {
+        std::cout << "(sat-bench :name " << name
+                  << " :vars " << s.num_vars()
+                  << " :clauses " << s.num_clauses()
+                  << std::fixed << std::setprecision(3)
+                  << " :time " << m.seconds()
+                  << " :" << extra_key << " " << std::setprecision(0) << extra_value;
+        if (m.m_misses.available())
+            std::cout << " :cache-misses " << m.m_num_misses;
+        std::cout << std::setprecision(2)
+                  << " :memory " << static_cast<double>(memory::get_allocation_size()) / (1024.0 * 1024.0)
+                  << " :max-memory " << static_cast<double>(memory::get_max_used_memory()) / (1024.0 * 1024.0)
+                  << ")" << std::endl;
+    }
+
+    /**
+       \brief Repeatedly decide random literals and propagate until a conflict
+       or all variables are assigned. Measures propagate_core in isolation.
+    */
+    void bench_propagate(char const* name, generator gen, bench_config const& cfg) {
+        reslimit limit;
+        params_ref p;
+        bench_solver s(p, limit);
+        random_gen r(cfg.m_seed);
+        gen(s, r, cfg.m_scale);
+        if (!s.propagate(false))
+            return;
+        unsigned num_rounds = 200;
+        unsigned num_vars = s.num_vars();
+        unsigned props = s.get_stats().m_propagate;
+        measurement m;
+        m.start();
+        for (unsigned round = 0; round < num_rounds; ++round) {
+            for (unsigned i = 0; i < num_vars && !s.inconsistent(); ++i) {
+                sat::literal l = rand_lit(r, num_vars);
+                if (s.value(l) != l_undef)
+                    continue;
+                s.push();
+                s.assign_scoped(l);
+                if (!s.propagate(false))
+                    break;
+            }
+            s.pop(s.scope_lvl());
+        }
+        m.stop();
+        double num_props = s.get_stats().m_propagate - props;
+        report(name, s, m, "props/sec", num_props / std::max(m.seconds(), 1e-6));
+    }
+
+    /**
+       \brief Run search with a conflict budget, then measure garbage
+       collection and defragmentation of the learned clauses.
+    */
+    void bench_search_gc(char const* name, generator gen, bench_config const& cfg) {
+        reslimit limit;
+        params_ref p;
+        p.set_uint("max_conflicts", 20000 * cfg.m_scale);
+        p.set_uint("gc.initial", UINT_MAX); // collect garbage only when measured
+        bench_solver s(p, limit);
+        random_gen r(cfg.m_seed);
+        gen(s, r, cfg.m_scale);
+
+        unsigned props = s.get_stats().m_propagate;
+        measurement m;
+        m.start();
+        s.check();
+        m.stop();
+        double num_props = s.get_stats().m_propagate - props;
+        std::string search_name = std::string(name) + "-search";
+        report(search_name.c_str(), s, m, "props/sec", num_props / std::max(m.seconds(), 1e-6));
+        if (s.inconsistent())
+            return;
+
+        s.pop(s.scope_lvl());
+        unsigned num_learned = s.num_learned();
+        m.start();
+        s.gc_glue();
+        m.stop();
+        std::string gc_name = std::string(name) + "-gc";
+        report(gc_name.c_str(), s, m, "deleted", num_learned - s.num_learned());
+
+        size_t mem = s.clause_memory();
+        m.start();
+        s.defrag_clauses();
+        m.stop();
+        std::string defrag_name = std::string(name) + "-defrag";
+        report(defrag_name.c_str(), s, m, "clause-bytes", static_cast<double>(mem));
+    }
+
+    struct benchmark {
+        char const* m_name;
+        generator   m_gen;
+    };
+}
+
+void tst_sat_bench(char** argv, int argc, int& i) {
+    bench_config cfg;
+    while (i + 1 < argc && strchr(argv[i + 1], '=')) {
+        char const* arg = argv[i + 1];
+        if (strncmp(arg, "seed=", 5) == 0)
+            cfg.m_seed = atoi(arg + 5);
+        else if (strncmp(arg, "scale=", 6) == 0)
+            cfg.m_scale = std::max(1, atoi(arg + 6));
+        else if (strncmp(arg, "filter=", 7) == 0)
+            cfg.m_filter = arg + 7;
+        else
+            std::cout << "unknown option " << arg << "\n";
+        ++i;
+    }
+    benchmark benchmarks[] = {
+        { "random3", gen_random3 },
+        { "binary",  gen_binary },
+        { "circuit", gen_circuit },
+    };
+    for (benchmark const& b : benchmarks) {
+        if (cfg.m_filter && !strstr(b.m_name, cfg.m_filter))
+            continue;
+        bench_propagate(b.m_name, b.m_gen, cfg);
+        bench_search_gc(b.m_name, b.m_gen, cfg);
+    }
+}
@@ -0,0 +1,109 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    sat_parallel.cpp
+
+Abstract:
+
+    Test the pool of shared clauses used by parallel SAT solving.
+
+--*/
+#include "sat/sat_parallel.h"
+#include "util/vector.h"
+#ifndef SINGLE_THREAD
+#include <thread>
+#endif
+
+static sat::literal_vector mk_clause(unsigned owner, unsigned i) {
+    sat::literal_vector lits;
+    unsigned n = 2 + i % 5;
+    for (unsigned j = 0; j < n; ++j)
+        lits.push_back(sat::literal(1000 * owner + i + j, j % 2 == 0));
+    return lits;
+}
+
+// a clause retrieved from the pool was created by mk_clause.
+static bool is_clause(sat::literal_vector const& lits) {
+    if (lits.size() < 2)
+        return false;
+    unsigned base = lits[0].var();
+    for (unsigned j = 0; j < lits.size(); ++j)
+        if (lits[j].var() != base + j || lits[j].sign() != (j % 2 == 0))
+            return false;
+    return lits.size() == 2 + (base % 1000) % 5;
+}
+
+static void tst_sequential() {
+    sat::shared_clause_pool pool;
+    pool.reserve(2, 8);
+    sat::literal_vector lits;
+    ENSURE(!pool.get(0, lits));
+    for (unsigned i = 0; i < 4; ++i) {
+        sat::literal_vector c = mk_clause(0, i);
+        ENSURE(pool.add(0, c.size(), c.data()));
+    }
+    // duplicates are suppressed, independent of the order of literals.
+    sat::literal_vector c = mk_clause(0, 2);
+    std::swap(c[0], c[1]);
+    ENSURE(!pool.add(1, c.size(), c.data()));
+    ENSURE(pool.num_duplicates() == 1);
+
+    // clauses are not returned to their owner.
+    ENSURE(!pool.get(0, lits));
+    for (unsigned i = 0; i < 4; ++i) {
+        ENSURE(pool.get(1, lits));
+        ENSURE(lits == mk_clause(0, i));
+    }
+    ENSURE(!pool.get(1, lits));
+
+    // a consumer that falls behind loses the oldest clauses.
+    for (unsigned i = 4; i < 24; ++i) {
+        sat::literal_vector c = mk_clause(0, i);
+        pool.add(0, c.size(), c.data());
+    }
+    unsigned n = 0;
+    while (pool.get(1, lits)) {
+        ENSURE(lits == mk_clause(0, 16 + n));
+        ++n;
+    }
+    ENSURE(n == 8);
+}
+
+#ifndef SINGLE_THREAD
+static void tst_concurrent() {
+    unsigned num_threads = 4, num_clauses = 20000;
+    sat::shared_clause_pool pool;
+    pool.reserve(num_threads, 64);
+    vector<unsigned> num_received(num_threads, 0u), num_invalid(num_threads, 0u);
+    vector<std::thread> threads;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            sat::literal_vector lits;
+            for (unsigned i = 0; i < num_clauses; ++i) {
+                sat::literal_vector c = mk_clause(t, i % 997);
+                pool.add(t, c.size(), c.data());
+                while (pool.get(t, lits)) {
+                    ++num_received[t];
+                    if (!is_clause(lits) || lits[0].var() / 1000 == t)
+                        ++num_invalid[t];
+                }
+            }
+        }));
+    }
+    for (auto& th : threads)
+        th.join();
+    for (unsigned t = 0; t < num_threads; ++t) {
+        std::cout << "thread " << t << " received " << num_received[t] << "\n";
+        ENSURE(num_invalid[t] == 0);
+    }
+}
+#endif
+
+void tst_sat_parallel() {
+    tst_sequential();
+#ifndef SINGLE_THREAD
+    tst_concurrent();
+#endif
+}
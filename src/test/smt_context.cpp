@@ -6,6 +6,7 @@ Copyright (c) 2015 Microsoft Corporation
 
 #include "smt/smt_context.h"
 #include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
 
 void tst_smt_context()
 {
@@ -34,4 +35,19 @@ void tst_smt_context()
     }
 
     ctx.check();
+
+    // axioms of div are instantiated lazily when relevancy is disabled.
+    {
+        smt_params lazy_params;
+        lazy_params.m_relevancy_lvl = 0;
+        lazy_params.m_relevancy_lazy_axioms = true;
+        arith_util a(m);
+        smt::context lazy_ctx(m, lazy_params);
+        app_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+        expr_ref d(a.mk_idiv(x, a.mk_int(2)), m);
+        lazy_ctx.assert_expr(a.mk_gt(x, a.mk_int(0)));
+        lazy_ctx.assert_expr(a.mk_ge(d, x));
+        ENSURE(lazy_ctx.check() == l_false);
+        ENSURE(lazy_ctx.relevancy_lvl() == 1);
+    }
 }
@@ -0,0 +1,82 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    spacer_lemma_db.cpp
+
+Abstract:
+
+    Test warm-starting spacer from a lemma database.
+
+--*/
+#include "api/z3.h"
+#include "util/debug.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static char const* lemma_db_file = "spacer_lemma_db_test.ldb";
+
+static std::string mk_rules(char const* step) {
+    return std::string(
+        "(declare-rel inv (Int Int Int))\n"
+        "(declare-rel err ())\n"
+        "(declare-var x Int)\n"
+        "(declare-var y Int)\n"
+        "(declare-var z Int)\n"
+        "(rule (=> (and (= x 0) (= y 0) (= z 0)) (inv x y z)))\n"
+        "(rule (=> (inv x y z) (inv (+ x 1) ") + step + " (+ z x))))\n"
+        "(rule (=> (and (inv x y z) (not (= y (* 2 x)))) err))\n"
+        "(query err)\n";
+}
+
+/**
+   \brief Query err with the lemma database, and return the number of
+   lemmas of the database that were seeded into the frames.
+*/
+static Z3_lbool query_with_db(char const* step, unsigned& num_seeded) {
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_fixedpoint fp = Z3_mk_fixedpoint(ctx);
+    Z3_fixedpoint_inc_ref(ctx, fp);
+    Z3_params p = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, p);
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "engine"), Z3_mk_string_symbol(ctx, "spacer"));
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "spacer.lemma_db"), Z3_mk_string_symbol(ctx, lemma_db_file));
+    Z3_fixedpoint_set_params(ctx, fp, p);
+    Z3_ast_vector queries = Z3_fixedpoint_from_string(ctx, fp, mk_rules(step).c_str());
+    Z3_ast_vector_inc_ref(ctx, queries);
+    ENSURE(Z3_ast_vector_size(ctx, queries) == 1);
+    Z3_lbool r = Z3_fixedpoint_query(ctx, fp, Z3_ast_vector_get(ctx, queries, 0));
+
+    num_seeded = 0;
+    Z3_stats st = Z3_fixedpoint_get_statistics(ctx, fp);
+    Z3_stats_inc_ref(ctx, st);
+    for (unsigned i = 0; i < Z3_stats_size(ctx, st); ++i)
+        if (strcmp(Z3_stats_get_key(ctx, st, i), "SPACER lemma db seeded") == 0 && Z3_stats_is_uint(ctx, st, i))
+            num_seeded = Z3_stats_get_uint_value(ctx, st, i);
+    Z3_stats_dec_ref(ctx, st);
+    Z3_ast_vector_dec_ref(ctx, queries);
+    Z3_params_dec_ref(ctx, p);
+    Z3_fixedpoint_dec_ref(ctx, fp);
+    Z3_del_context(ctx);
+    return r;
+}
+
+void tst_spacer_lemma_db() {
+    std::remove(lemma_db_file);
+    unsigned num_seeded = 0;
+    // the first run creates the database.
+    ENSURE(query_with_db("(+ y 2)", num_seeded) == Z3_L_FALSE);
+    ENSURE(num_seeded == 0);
+    // the second run is warm-started with the lemmas of the first run.
+    ENSURE(query_with_db("(+ y 2)", num_seeded) == Z3_L_FALSE);
+    std::cout << "seeded lemmas: " << num_seeded << "\n";
+    ENSURE(num_seeded > 0);
+    // after a change of the rules the lemmas no longer hold, and the
+    // counterexample is still found.
+    ENSURE(query_with_db("(+ y 3)", num_seeded) == Z3_L_TRUE);
+    ENSURE(query_with_db("(+ y 3)", num_seeded) == Z3_L_TRUE);
+    std::remove(lemma_db_file);
+}
@@ -0,0 +1,42 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    spacer_parallel.cpp
+
+Abstract:
+
+    Test spacer with several workers sharing lemmas.
+
+--*/
+#include "api/z3.h"
+#include "util/debug.h"
+#include <iostream>
+#include <string>
+
+static char const* spacer_parallel_rules =
+    "(declare-fun inv (Int Int Int) Bool)\n"
+    "(assert (forall ((x Int) (y Int) (z Int)) (=> (and (= x 0) (= y 0) (= z 0)) (inv x y z))))\n"
+    "(assert (forall ((x Int) (y Int) (z Int)) (=> (inv x y z) (inv (+ x 1) (+ y 2) (+ z x)))))\n";
+
+static Z3_lbool check_horn(char const* query) {
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_solver s = Z3_mk_solver_for_logic(ctx, Z3_mk_string_symbol(ctx, "HORN"));
+    Z3_solver_inc_ref(ctx, s);
+    Z3_solver_from_string(ctx, s, (std::string(spacer_parallel_rules) + query).c_str());
+    Z3_lbool r = Z3_solver_check(ctx, s);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+    return r;
+}
+
+void tst_spacer_parallel() {
+    Z3_global_param_set("fp.engine", "spacer");
+    Z3_global_param_set("fp.spacer.threads", "3");
+    // y = 2x is inductive, the horn clauses have a model.
+    ENSURE(check_horn("(assert (forall ((x Int) (y Int) (z Int)) (=> (and (inv x y z) (not (= y (* 2 x)))) false)))\n") == Z3_L_TRUE);
+    // z reaches 10 after 5 steps.
+    ENSURE(check_horn("(assert (forall ((x Int) (y Int) (z Int)) (=> (and (inv x y z) (= z 10)) false)))\n") == Z3_L_FALSE);
+    Z3_global_param_reset_all();
+}
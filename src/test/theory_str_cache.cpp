@@ -0,0 +1,64 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    theory_str_cache.cpp
+
+Abstract:
+
+    Test that the regex automata and the concat axioms of theory_str are
+    reused across scopes.
+
+--*/
+#include "api/z3.h"
+#include "util/debug.h"
+#include <cstring>
+#include <iostream>
+
+static char const* str_problem =
+    "(declare-const x String)\n"
+    "(declare-const y String)\n"
+    "(assert (str.in_re x (re.+ (str.to_re \"ab\"))))\n"
+    "(assert (= y (str.++ x \"c\")))\n"
+    "(assert (= (str.len x) 4))\n";
+
+static unsigned get_stat(Z3_context ctx, Z3_stats st, char const* key) {
+    for (unsigned i = 0; i < Z3_stats_size(ctx, st); ++i)
+        if (strcmp(Z3_stats_get_key(ctx, st, i), key) == 0 && Z3_stats_is_uint(ctx, st, i))
+            return Z3_stats_get_uint_value(ctx, st, i);
+    return 0;
+}
+
+void tst_theory_str_cache() {
+    Z3_context ctx = Z3_mk_context(nullptr);
+    Z3_solver s = Z3_mk_solver(ctx);
+    Z3_solver_inc_ref(ctx, s);
+    Z3_params p = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, p);
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "smt.string_solver"), Z3_mk_string_symbol(ctx, "z3str3"));
+    Z3_solver_set_params(ctx, s, p);
+    Z3_ast_vector fmls = Z3_parse_smtlib2_string(ctx, str_problem, 0, nullptr, nullptr, 0, nullptr, nullptr);
+    Z3_ast_vector_inc_ref(ctx, fmls);
+    // the same constraints are checked in two scopes, the second check
+    // reuses what the first one built.
+    for (unsigned round = 0; round < 2; ++round) {
+        Z3_solver_push(ctx, s);
+        for (unsigned i = 0; i < Z3_ast_vector_size(ctx, fmls); ++i)
+            Z3_solver_assert(ctx, s, Z3_ast_vector_get(ctx, fmls, i));
+        ENSURE(Z3_solver_check(ctx, s) == Z3_L_TRUE);
+        Z3_solver_pop(ctx, s, 1);
+    }
+    Z3_stats st = Z3_solver_get_statistics(ctx, s);
+    Z3_stats_inc_ref(ctx, st);
+    unsigned aut_hits = get_stat(ctx, st, "str automaton cache hits");
+    unsigned axiom_hits = get_stat(ctx, st, "str axiom cache hits");
+    std::cout << "automaton cache hits: " << aut_hits << ", axiom cache hits: " << axiom_hits << "\n";
+    ENSURE(aut_hits > 0);
+    ENSURE(axiom_hits > 0);
+    Z3_stats_dec_ref(ctx, st);
+    Z3_ast_vector_dec_ref(ctx, fmls);
+    Z3_params_dec_ref(ctx, p);
+    Z3_solver_dec_ref(ctx, s);
+    Z3_del_context(ctx);
+}
@@ -0,0 +1,220 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    trail.cpp
+
+Abstract:
+
+    Test the typed trail stack and compare it with a stack of region
+    allocated trail objects on deep incremental sessions.
+
+    Usage: test-z3 trail_bench [depth=<n>] [width=<n>] [rounds=<n>]
+
+--*/
+#include "util/trail.h"
+#include "util/stopwatch.h"
+#include "util/debug.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+    struct trail_key {
+        unsigned m_id;
+        unsigned hash() const { return m_id; }
+    };
+
+    struct trail_state {
+        unsigned_vector       m_values;
+        bool_vector           m_flags;
+        svector<unsigned>     m_stack;
+        vector<unsigned_vector> m_lists;
+        svector<trail_key>    m_keys;
+        obj_map<trail_key, unsigned> m_map;
+
+        trail_state(unsigned n) {
+            m_values.resize(n, 0);
+            m_flags.resize(n, false);
+            m_lists.resize(4);
+            for (unsigned i = 0; i < n; ++i)
+                m_keys.push_back({ i });
+        }
+
+        bool operator==(trail_state const& other) const {
+            if (m_values != other.m_values || m_flags != other.m_flags || m_stack != other.m_stack)
+                return false;
+            for (unsigned i = 0; i < m_lists.size(); ++i)
+                if (m_lists[i] != other.m_lists[i])
+                    return false;
+            return m_map.size() == other.m_map.size();
+        }
+    };
+
+    class generic_trail {
+        ptr_vector<trail> m_trail;
+        unsigned_vector   m_lim;
+        region            m_region;
+    public:
+        template<typename T>
+        void push(T const& t) { m_trail.push_back(new (m_region) T(t)); }
+        void push_scope() { m_region.push_scope(); m_lim.push_back(m_trail.size()); }
+        void pop_scope(unsigned n) {
+            unsigned new_lvl = m_lim.size() - n;
+            undo_trail_stack(m_trail, m_lim[new_lvl]);
+            m_lim.shrink(new_lvl);
+            m_region.pop_scope(n);
+        }
+    };
+
+    class typed_trail_scopes {
+        typed_trail     m_trail;
+        unsigned_vector m_lim;
+    public:
+        void push(value_trail<unsigned> const& t) { m_trail.push_value(t.get_value(), t.get_old_value()); }
+        void push(value_trail<bool> const& t) { m_trail.push_value(t.get_value(), t.get_old_value()); }
+        template<typename T, bool CallDestructors>
+        void push(push_back_trail<T, CallDestructors> const& t) { m_trail.push_back(t.get_vector()); }
+        template<typename V>
+        void push(push_back_vector<V> const& t) { m_trail.push_back(t.get_vector()); }
+        template<typename D, typename R>
+        void push(insert_obj_map<D, R> const& t) { m_trail.push_insert(t.get_map(), t.get_obj()); }
+        void push_scope() { m_lim.push_back(m_trail.size()); }
+        void pop_scope(unsigned n) {
+            unsigned new_lvl = m_lim.size() - n;
+            m_trail.undo(m_lim[new_lvl]);
+            m_lim.shrink(new_lvl);
+        }
+    };
+
+    /**
+       \brief Apply the updates of one scope, mixing the trail kinds that are
+       most common in smt::context.
+    */
+    template<typename Trail>
+    void update(Trail& t, trail_state& s, unsigned scope, unsigned width) {
+        unsigned n = s.m_values.size();
+        for (unsigned i = 0; i < width; ++i) {
+            unsigned k = (scope * 31 + i * 17) % n;
+            switch (i % 5) {
+            case 0:
+                t.push(value_trail<unsigned>(s.m_values[k], scope + i));
+                break;
+            case 1:
+                t.push(value_trail<bool>(s.m_flags[k], !s.m_flags[k]));
+                break;
+            case 2:
+                s.m_stack.push_back(k);
+                t.push(push_back_trail<unsigned, false>(s.m_stack));
+                break;
+            case 3:
+                s.m_lists[k % 4].push_back(i);
+                t.push(push_back_vector<unsigned_vector>(s.m_lists[k % 4]));
+                break;
+            case 4:
+                if (!s.m_map.contains(&s.m_keys[k])) {
+                    s.m_map.insert(&s.m_keys[k], i);
+                    t.push(insert_obj_map<trail_key, unsigned>(s.m_map, &s.m_keys[k]));
+                }
+                break;
+            }
+        }
+    }
+
+    /**
+       \brief Run rounds of a deep incremental session: open depth scopes with
+       width updates each, then backtrack in steps of varying length.
+    */
+    template<typename Trail>
+    double run_session(trail_state& s, unsigned depth, unsigned width, unsigned rounds) {
+        Trail t;
+        stopwatch sw;
+        sw.start();
+        for (unsigned r = 0; r < rounds; ++r) {
+            unsigned lvl = 0;
+            for (; lvl < depth; ++lvl) {
+                t.push_scope();
+                update(t, s, lvl + r, width);
+            }
+            while (lvl > 0) {
+                unsigned n = std::min(lvl, 1 + (lvl + r) % 7);
+                t.pop_scope(n);
+                lvl -= n;
+            }
+        }
+        sw.stop();
+        return sw.get_seconds();
+    }
+}
+
+static void tst_typed_trail_order() {
+    // undoing restores the state before every scope, interleaving all kinds.
+    trail_state s(50), s0(50);
+    typed_trail_scopes t;
+    vector<trail_state> snapshots;
+    for (unsigned lvl = 0; lvl < 20; ++lvl) {
+        snapshots.push_back(s);
+        t.push_scope();
+        update(t, s, lvl, 13);
+    }
+    for (unsigned lvl = 20; lvl-- > 0; ) {
+        t.pop_scope(1);
+        ENSURE(s == snapshots[lvl]);
+    }
+    ENSURE(s == s0);
+    ENSURE(s.m_map.empty());
+}
+
+static void tst_typed_trail_shrink() {
+    // consecutive push backs on the same vector are undone together,
+    // also when a scope starts in the middle of them.
+    typed_trail t;
+    unsigned_vector v;
+    unsigned x = 0;
+    for (unsigned i = 0; i < 10; ++i) {
+        v.push_back(i);
+        t.push_back(v);
+    }
+    unsigned lim = t.size();
+    for (unsigned i = 0; i < 10; ++i) {
+        v.push_back(i);
+        t.push_back(v);
+    }
+    t.push_value(x, x);
+    x = 5;
+    ENSURE(t.size() == 21);
+    t.undo(lim);
+    ENSURE(v.size() == 10 && x == 0);
+    t.shrink(5);
+    ENSURE(t.size() == 5 && v.size() == 10);
+    t.undo(0);
+    ENSURE(v.size() == 5);
+}
+
+void tst_trail() {
+    tst_typed_trail_order();
+    tst_typed_trail_shrink();
+}
+
+void tst_trail_bench(char** argv, int argc, int& i) {
+    unsigned depth = 2000, width = 100, rounds = 20;
+    while (i + 1 < argc && strchr(argv[i + 1], '=')) {
+        char const* arg = argv[i + 1];
+        if (strncmp(arg, "depth=", 6) == 0)
+            depth = std::max(1, atoi(arg + 6));
+        else if (strncmp(arg, "width=", 6) == 0)
+            width = std::max(1, atoi(arg + 6));
+        else if (strncmp(arg, "rounds=", 7) == 0)
+            rounds = std::max(1, atoi(arg + 7));
+        else
+            std::cout << "unknown option " << arg << "\n";
+        ++i;
+    }
+    trail_state s1(10000), s2(10000);
+    double generic = run_session<generic_trail>(s1, depth, width, rounds);
+    double typed = run_session<typed_trail_scopes>(s2, depth, width, rounds);
+    ENSURE(s1 == s2);
+    std::cout << "(trail-bench :depth " << depth << " :width " << width << " :rounds " << rounds
+              << " :generic " << generic << " :typed " << typed << ")\n";
+}
@@ -0,0 +1,114 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    mapped_file.cpp
+
+Abstract:
+
+    Sequential read access to files through memory mapping.
+
+--*/
+#ifndef _WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "util/mapped_file.h"
+
+mapped_file::mapped_file(char const * name, size_t window_size):
+    m_name(name),
+    m_window_size(window_size) {
+#ifndef _WINDOWS
+    // windows start at multiples of the window size, which must be page aligned.
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    m_window_size = std::max(page_size, (m_window_size + page_size - 1) / page_size * page_size);
+    m_fd = open(name, O_RDONLY);
+    if (m_fd >= 0) {
+        struct stat st;
+        if (fstat(m_fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            m_file_size = st.st_size;
+            m_open = true;
+            return;
+        }
+        close(m_fd);
+        m_fd = -1;
+    }
+#endif
+    m_stream.open(name, std::ios::binary);
+    m_open = !m_stream.fail();
+    if (m_open)
+        m_buffer.resize(static_cast<unsigned>(std::min(m_window_size, static_cast<size_t>(1 << 20))));
+}
+
+mapped_file::~mapped_file() {
+    unmap();
+#ifndef _WINDOWS
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+}
+
+void mapped_file::unmap() {
+#ifndef _WINDOWS
+    if (m_window)
+        munmap(m_window, m_mapped);
+#endif
+    m_window = nullptr;
+    m_mapped = 0;
+}
+
+bool mapped_file::next(char const *& begin, char const *& end) {
+    if (!m_open)
+        return false;
+#ifndef _WINDOWS
+    if (m_fd >= 0) {
+        unmap();
+        if (m_offset >= m_file_size)
+            return false;
+        size_t sz = static_cast<size_t>(std::min(static_cast<uint64_t>(m_window_size), m_file_size - m_offset));
+        void * p = mmap(nullptr, sz, PROT_READ, MAP_PRIVATE, m_fd, static_cast<off_t>(m_offset));
+        if (p == MAP_FAILED) {
+            // continue with buffered reads from the current offset.
+            m_stream.open(m_name, std::ios::binary);
+            m_stream.seekg(static_cast<std::streamoff>(m_offset));
+            close(m_fd);
+            m_fd = -1;
+            m_buffer.resize(static_cast<unsigned>(std::min(m_window_size, static_cast<size_t>(1 << 20))));
+            return next(begin, end);
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(p, sz, MADV_SEQUENTIAL);
+#endif
+        m_window = static_cast<char *>(p);
+        m_mapped = sz;
+        m_offset += sz;
+        begin = m_window;
+        end = m_window + sz;
+        return true;
+    }
+#endif
+    if (!m_stream)
+        return false;
+    m_stream.read(m_buffer.data(), m_buffer.size());
+    size_t n = static_cast<size_t>(m_stream.gcount());
+    if (n == 0)
+        return false;
+    begin = m_buffer.data();
+    end = begin + n;
+    return true;
+}
+
+mapped_file_streambuf::int_type mapped_file_streambuf::underflow() {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    char const * begin = nullptr, * end = nullptr;
+    if (!m_file.next(begin, end))
+        return traits_type::eof();
+    // the get area is never written to.
+    char * b = const_cast<char *>(begin);
+    setg(b, b, const_cast<char *>(end));
+    return traits_type::to_int_type(*gptr());
+}
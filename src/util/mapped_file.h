@@ -0,0 +1,66 @@
+/*++
+Copyright (c) 2024 Microsoft Corporation
+
+Module Name:
+
+    mapped_file.h
+
+Abstract:
+
+    Sequential read access to files through memory mapping.
+
+    The file is mapped in windows of a fixed size. A window is unmapped
+    when the next one is mapped, so the memory used for reading is bounded
+    by the window size independently of the size of the file.
+    When the file cannot be mapped (e.g., it is a pipe, or the platform
+    does not support mmap), windows are filled by buffered reads.
+
+--*/
+#pragma once
+
+#include <streambuf>
+#include <fstream>
+#include <string>
+#include "util/vector.h"
+
+class mapped_file {
+    std::string    m_name;
+    size_t         m_window_size;
+    int            m_fd { -1 };
+    uint64_t       m_file_size { 0 };
+    uint64_t       m_offset { 0 };      // file offset of the next window
+    char *         m_window { nullptr }; // currently mapped window
+    size_t         m_mapped { 0 };
+    std::ifstream  m_stream;            // used if the file cannot be mapped
+    svector<char>  m_buffer;
+    bool           m_open { false };
+
+    void unmap();
+public:
+    static const size_t default_window_size = 64 * 1024 * 1024;
+
+    mapped_file(char const * name, size_t window_size = default_window_size);
+    ~mapped_file();
+
+    bool is_open() const { return m_open; }
+
+    char const * name() const { return m_name.c_str(); }
+
+    /**
+       \brief Make the next window of the file available in [begin, end).
+       The previous window is released. Return false at the end of the file.
+    */
+    bool next(char const *& begin, char const *& end);
+};
+
+/**
+   \brief Stream buffer that exposes the windows of a mapped file
+   without copying them.
+*/
+class mapped_file_streambuf : public std::streambuf {
+    mapped_file & m_file;
+protected:
+    int_type underflow() override;
+public:
+    mapped_file_streambuf(mapped_file & f): m_file(f) {}
+};
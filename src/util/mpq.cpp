@@ -380,7 +380,7 @@ template<bool SYNCH>
 void mpq_manager<SYNCH>::rat_mul(mpq const & a, mpq const & b, mpq & c) {
     STRACE("rat_mpq", tout << "[mpq] " << to_string(a) << " * " << to_string(b) << " == ";); 
     if (SYNCH) {
-        mpz g1, g2, tmp1, tmp2;
+        mpz_stack g1, g2, tmp1, tmp2;
         rat_mul(a, b, c, g1, g2, tmp1, tmp2);
         del(g1);
         del(g2);
@@ -414,7 +414,7 @@ template<bool SYNCH>
 void mpq_manager<SYNCH>::rat_sub(mpq const & a, mpq const & b, mpq & c) {
     STRACE("rat_mpq", tout << "[mpq] " << to_string(a) << " - " << to_string(b) << " == ";); 
     if (SYNCH) {
-        mpz tmp1, tmp2, tmp3, g;
+        mpz_stack tmp1, tmp2, tmp3, g;
         lin_arith_op<true>(a, b, c, g, tmp1, tmp2, tmp3);
         del(tmp1);
         del(tmp2);
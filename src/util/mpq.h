@@ -55,7 +55,7 @@ class mpq_manager : public mpz_manager<SYNCH> {
 
     void normalize(mpq & a) {
         if (SYNCH) {
-            mpz tmp;
+            mpz_stack tmp;
             gcd(a.m_num, a.m_den, tmp);
             if (is_one(tmp)) {
                 del(tmp);
@@ -79,7 +79,7 @@ class mpq_manager : public mpz_manager<SYNCH> {
     void rat_add(mpq const & a, mpz const & b, mpq & c) {
         STRACE("rat_mpq", tout << "[mpq] " << to_string(a) << " + " << to_string(b) << " == ";); 
         if (SYNCH) {
-            mpz tmp1;
+            mpz_stack tmp1;
             mul(b, a.m_den, tmp1);
             set(c.m_den, a.m_den);
             add(a.m_num, tmp1, c.m_num);
@@ -135,34 +135,31 @@ mpz_manager<SYNCH>::mpz_manager():
     else {
         m_init_cell_capacity = 6;
     }
-    set(m_int_min, -static_cast<int64_t>(INT_MIN));
 #else
     // GMP
-    mpz_init(m_tmp);
-    mpz_init(m_tmp2);
+    mpz_t tmp;
+    mpz_init(tmp);
     mpz_init(m_two32);
     mpz_set_ui(m_two32, UINT_MAX);
-    mpz_set_ui(m_tmp, 1);
-    mpz_add(m_two32, m_two32, m_tmp);
+    mpz_add_ui(m_two32, m_two32, 1);
     mpz_init(m_uint64_max);
     unsigned max_l = static_cast<unsigned>(UINT64_MAX);
     unsigned max_h = static_cast<unsigned>(UINT64_MAX >> 32);
     mpz_set_ui(m_uint64_max, max_h);
     mpz_mul(m_uint64_max, m_two32, m_uint64_max);
-    mpz_set_ui(m_tmp, max_l);
-    mpz_add(m_uint64_max, m_uint64_max, m_tmp);
+    mpz_add_ui(m_uint64_max, m_uint64_max, max_l);
     mpz_init(m_int64_max);
     mpz_init(m_int64_min);
 
     max_l = static_cast<unsigned>(INT64_MAX % static_cast<int64_t>(UINT_MAX));
     max_h = static_cast<unsigned>(INT64_MAX / static_cast<int64_t>(UINT_MAX));
     mpz_set_ui(m_int64_max, max_h);
-    mpz_set_ui(m_tmp, UINT_MAX);
-    mpz_mul(m_int64_max, m_tmp, m_int64_max);
-    mpz_set_ui(m_tmp, max_l);
-    mpz_add(m_int64_max, m_tmp, m_int64_max);
+    mpz_set_ui(tmp, UINT_MAX);
+    mpz_mul(m_int64_max, tmp, m_int64_max);
+    mpz_add_ui(m_int64_max, m_int64_max, max_l);
     mpz_neg(m_int64_min, m_int64_max);
     mpz_sub_ui(m_int64_min, m_int64_min, 1);
+    mpz_clear(tmp);
 #endif
     
     mpz one(1);
@@ -173,11 +170,7 @@ mpz_manager<SYNCH>::mpz_manager():
 template<bool SYNCH>
 mpz_manager<SYNCH>::~mpz_manager() {
     del(m_two64);
-#ifndef _MP_GMP
-    del(m_int_min);
-#else
-    mpz_clear(m_tmp);
-    mpz_clear(m_tmp2);
+#ifdef _MP_GMP
     mpz_clear(m_two32);
     mpz_clear(m_uint64_max);
     mpz_clear(m_int64_max);
@@ -320,11 +313,11 @@ void mpz_manager<SYNCH>::set_big_i64(mpz & c, int64_t v) {
         _v   = v;
     }
     mpz_set_ui(*c.m_ptr, static_cast<unsigned>(_v));
-    MPZ_BEGIN_CRITICAL();
-    mpz_set_ui(m_tmp,    static_cast<unsigned>(_v >> 32));
-    mpz_mul(m_tmp, m_tmp, m_two32);
-    mpz_add(*c.m_ptr, *c.m_ptr, m_tmp);
-    MPZ_END_CRITICAL();
+    mpz_t tmp;
+    mpz_init_set_ui(tmp, static_cast<unsigned>(_v >> 32));
+    mpz_mul(tmp, tmp, m_two32);
+    mpz_add(*c.m_ptr, *c.m_ptr, tmp);
+    mpz_clear(tmp);
     if (sign)
         mpz_neg(*c.m_ptr, *c.m_ptr);
 #endif
@@ -361,11 +354,11 @@ void mpz_manager<SYNCH>::set_big_ui64(mpz & c, uint64_t v) {
     }
     c.m_kind = mpz_large;
     mpz_set_ui(*c.m_ptr, static_cast<unsigned>(v));
-    MPZ_BEGIN_CRITICAL();
-    mpz_set_ui(m_tmp,    static_cast<unsigned>(v >> 32));
-    mpz_mul(m_tmp, m_tmp, m_two32);
-    mpz_add(*c.m_ptr, *c.m_ptr, m_tmp);
-    MPZ_END_CRITICAL();
+    mpz_t tmp;
+    mpz_init_set_ui(tmp, static_cast<unsigned>(v >> 32));
+    mpz_mul(tmp, tmp, m_two32);
+    mpz_add(*c.m_ptr, *c.m_ptr, tmp);
+    mpz_clear(tmp);
 #endif
 }
 
@@ -376,7 +369,18 @@ mpz_manager<SYNCH>::ensure_mpz_t::ensure_mpz_t(mpz const& a) {
     if (is_small(a)) {
         m_result = &m_local;
         mpz_init(m_local);
-        mpz_set_si(m_local, a.m_val);
+        int64_t v = i64(a);
+        if (LONG_MIN <= v && v <= LONG_MAX) {
+            mpz_set_si(m_local, static_cast<long>(v));
+        }
+        else {
+            uint64_t u = static_cast<uint64_t>(v < 0 ? -v : v);
+            mpz_set_ui(m_local, static_cast<unsigned>(u >> 32));
+            mpz_mul_2exp(m_local, m_local, 32);
+            mpz_add_ui(m_local, m_local, static_cast<unsigned>(u));
+            if (v < 0)
+                mpz_neg(m_local, m_local);
+        }
     }
     else {
         m_result = a.m_ptr;
@@ -404,10 +408,10 @@ void mpz_manager<SYNCH>::set(mpz_cell& src, mpz & a, int sign, unsigned sz) {
         return;
     }
     
-    unsigned d = src.m_digits[0];
-    if (i == 1 && d <= INT_MAX) {
+    int64_t d;
+    if (is_small_digits(i, src.m_digits, d)) {
         // src fits is a fixnum
-        a.m_val = sign < 0 ? -static_cast<int>(d) : static_cast<int>(d);
+        a.m_val = sign < 0 ? -d : d;
         a.m_kind = mpz_small;
         return;
     }
@@ -448,10 +452,9 @@ void mpz_manager<SYNCH>::set_digits(mpz & target, unsigned sz, digit_t const * d
     // remove zero digits
     while (sz > 0 && digits[sz - 1] == 0)
         sz--;
-    if (sz == 0)
-        set(target, 0);
-    else if (sz == 1)
-        set(target, digits[0]);
+    int64_t v;
+    if (is_small_digits(sz, digits, v))
+        set(target, v);
     else {
 #ifndef _MP_GMP
         target.m_val = 1; // number is positive.
@@ -488,14 +491,11 @@ void mpz_manager<SYNCH>::set_digits(mpz & target, unsigned sz, digit_t const * d
         mpz_set_ui(*target.m_ptr, digits[sz - 1]);
         SASSERT(sz > 0);
         unsigned i = sz - 1;
-        MPZ_BEGIN_CRITICAL();
         while (i > 0) {
             --i;
             mpz_mul_2exp(*target.m_ptr, *target.m_ptr, 32);
-            mpz_set_ui(m_tmp, digits[i]);
-            mpz_add(*target.m_ptr, *target.m_ptr, m_tmp);
+            mpz_add_ui(*target.m_ptr, *target.m_ptr, digits[i]);
         }
-        MPZ_END_CRITICAL();
 #endif        
     }
 }
@@ -504,7 +504,7 @@ template<bool SYNCH>
 void mpz_manager<SYNCH>::mul(mpz const & a, mpz const & b, mpz & c) {
     STRACE("mpz", tout << "[mpz] " << to_string(a) << " * " << to_string(b) << " == ";); 
     if (is_small(a) && is_small(b)) {
-        set_i64(c, i64(a) * i64(b));
+        mul_small(a, b, c);
     }
     else {
         big_mul(a, b, c);
@@ -522,7 +522,7 @@ void mpz_manager<SYNCH>::addmul(mpz const & a, mpz const & b, mpz const & c, mpz
         sub(a, c, d);
     }
     else {
-        mpz tmp;
+        mpz_stack tmp;
         mul(b,c,tmp);
         add(a,tmp,d);
         del(tmp);
@@ -540,7 +540,7 @@ void mpz_manager<SYNCH>::submul(mpz const & a, mpz const & b, mpz const & c, mpz
         add(a, c, d);
     }
     else {
-        mpz tmp;
+        mpz_stack tmp;
         mul(b,c,tmp);
         sub(a,tmp,d);
         del(tmp);
@@ -645,11 +645,6 @@ void mpz_manager<SYNCH>::mod(mpz const & a, mpz const & b, mpz & c) {
 template<bool SYNCH>
 void mpz_manager<SYNCH>::neg(mpz & a) {
     STRACE("mpz", tout << "[mpz] 0 - " << to_string(a) << " == ";); 
-    if (is_small(a) && a.m_val == INT_MIN) {
-        // neg(INT_MIN) is not a small int
-        set_big_i64(a, - static_cast<long long>(INT_MIN)); 
-        return;
-    }
 #ifndef _MP_GMP
     a.m_val = -a.m_val;
 #else
@@ -666,14 +661,8 @@ void mpz_manager<SYNCH>::neg(mpz & a) {
 template<bool SYNCH>
 void mpz_manager<SYNCH>::abs(mpz & a) {
     if (is_small(a)) {
-        if (a.m_val < 0) {
-            if (a.m_val == INT_MIN) {
-                // abs(INT_MIN) is not a small int
-                set_big_i64(a, - static_cast<long long>(INT_MIN)); 
-            }
-            else
-                a.m_val = -a.m_val;
-        }
+        if (a.m_val < 0)
+            a.m_val = -a.m_val;
     }
     else {
 #ifndef _MP_GMP
@@ -876,14 +865,13 @@ void mpz_manager<SYNCH>::big_rem(mpz const & a, mpz const & b, mpz & c) {
 
 template<bool SYNCH>
 void mpz_manager<SYNCH>::gcd(mpz const & a, mpz const & b, mpz & c) {
-    static_assert(sizeof(a.m_val) == sizeof(int), "size mismatch");
     static_assert(sizeof(mpz) <= 16, "mpz size overflow");
-    if (is_small(a) && is_small(b) && a.m_val != INT_MIN && b.m_val != INT_MIN) {
-        int _a = a.m_val;
-        int _b = b.m_val;
+    if (is_small(a) && is_small(b)) {
+        int64_t _a = a.m_val;
+        int64_t _b = b.m_val;
         if (_a < 0) _a = -_a;
         if (_b < 0) _b = -_b;
-        unsigned r = u_gcd(_a, _b);
+        uint64_t r = u64_gcd(_a, _b);
         set(c, r);
     }
     else {
@@ -1054,7 +1042,7 @@ void mpz_manager<SYNCH>::gcd(mpz const & a, mpz const & b, mpz & c) {
             SASSERT(ge(a1, b1));
             if (is_small(b1)) {
                 if (is_small(a1)) {
-                    unsigned r = u_gcd(a1.m_val, b1.m_val);
+                    uint64_t r = u64_gcd(i64(a1), i64(b1));
                     set(c, r);
                     break;
                 }
@@ -1625,15 +1613,13 @@ uint64_t mpz_manager<SYNCH>::get_uint64(mpz const & a) const {
         return mpz_get_ui(*a.m_ptr);
     }
     else {
-        MPZ_BEGIN_CRITICAL();
-        mpz_manager * _this = const_cast<mpz_manager*>(this);
-        mpz_set(_this->m_tmp, *a.m_ptr);
-        mpz_mod(_this->m_tmp, m_tmp, m_two32);
-        uint64_t r = static_cast<uint64_t>(mpz_get_ui(m_tmp));
-        mpz_set(_this->m_tmp, *a.m_ptr);
-        mpz_div(_this->m_tmp, m_tmp, m_two32);
-        r += static_cast<uint64_t>(mpz_get_ui(m_tmp)) << static_cast<uint64_t>(32);
-        MPZ_END_CRITICAL();
+        mpz_t tmp;
+        mpz_init(tmp);
+        mpz_mod(tmp, *a.m_ptr, m_two32);
+        uint64_t r = static_cast<uint64_t>(mpz_get_ui(tmp));
+        mpz_div(tmp, *a.m_ptr, m_two32);
+        r += static_cast<uint64_t>(mpz_get_ui(tmp)) << static_cast<uint64_t>(32);
+        mpz_clear(tmp);
         return r;
     }
 #endif
@@ -1658,13 +1644,13 @@ int64_t mpz_manager<SYNCH>::get_int64(mpz const & a) const {
         return mpz_get_si(*a.m_ptr);
     }
     else {
-        MPZ_BEGIN_CRITICAL();
-        mpz_manager * _this = const_cast<mpz_manager*>(this);
-        mpz_mod(_this->m_tmp, *a.m_ptr, m_two32);
-        int64_t r = static_cast<int64_t>(mpz_get_ui(m_tmp));
-        mpz_div(_this->m_tmp, *a.m_ptr, m_two32);
-        r += static_cast<int64_t>(mpz_get_si(m_tmp)) << static_cast<int64_t>(32);
-        MPZ_END_CRITICAL();
+        mpz_t tmp;
+        mpz_init(tmp);
+        mpz_mod(tmp, *a.m_ptr, m_two32);
+        int64_t r = static_cast<int64_t>(mpz_get_ui(tmp));
+        mpz_div(tmp, *a.m_ptr, m_two32);
+        r += static_cast<int64_t>(mpz_get_si(tmp)) << static_cast<int64_t>(32);
+        mpz_clear(tmp);
         return r;
     }
 #endif
@@ -1697,7 +1683,7 @@ double mpz_manager<SYNCH>::get_double(mpz const & a) const {
 template<bool SYNCH>
 void mpz_manager<SYNCH>::display(std::ostream & out, mpz const & a) const {
     if (is_small(a)) {
-        out << a.m_val;
+        out << i64(a);
     }
     else {
 #ifndef _MP_GMP
@@ -1748,7 +1734,10 @@ void mpz_manager<SYNCH>::display_hex(std::ostream & out, mpz const & a, unsigned
     fmt.copyfmt(out);
     out << std::hex;
     if (is_small(a)) {
-        out << std::setw(num_bits/4) << std::setfill('0') << get_uint64(a);
+        uint64_t v = get_uint64(a);
+        if (num_bits < 64)
+            v &= (static_cast<uint64_t>(1) << num_bits) - 1;
+        out << std::setw(num_bits/4) << std::setfill('0') << v;
     } else {
 #ifndef _MP_GMP
         digit_t *ds = digits(a);
@@ -1848,14 +1837,14 @@ std::string mpz_manager<SYNCH>::to_string(mpz const & a) const {
 template<bool SYNCH>
 unsigned mpz_manager<SYNCH>::hash(mpz const & a) {
     if (is_small(a))
-        return a.m_val;
+        return hash_i64(i64(a));
 #ifndef _MP_GMP
     unsigned sz = size(a);
     if (sz == 1)
         return static_cast<unsigned>(digits(a)[0]);
     return string_hash(reinterpret_cast<char*>(digits(a)), sz * sizeof(digit_t), 17);
 #else
-    return mpz_get_si(*a.m_ptr);
+    return hash_i64(mpz_get_si(*a.m_ptr));
 #endif
 }
 
@@ -1871,8 +1860,9 @@ void mpz_manager<SYNCH>::power(mpz const & a, unsigned p, mpz & b) {
 #ifndef _MP_GMP
     if (is_small(a)) {
         if (a.m_val == 2) {
-            if (p < 8 * sizeof(int) - 1) {
-                b.m_val = 1 << p;
+            // 2^60 is the largest power of two in the range of small numbers.
+            if (p < 61) {
+                b.m_val = static_cast<int64_t>(1) << p;
                 b.m_kind = mpz_small;
             }
             else {
@@ -1926,8 +1916,9 @@ bool mpz_manager<SYNCH>::is_power_of_two(mpz const & a, unsigned & shift) {
     if (is_nonpos(a))
         return false;
     if (is_small(a)) {
-        if (::is_power_of_two(a.m_val)) {
-            shift = ::log2((unsigned)a.m_val);
+        uint64_t v = static_cast<uint64_t>(i64(a));
+        if (!(v & (v - 1))) {
+            shift = uint64_log2(v);
             return true;
         }
         else {
@@ -1971,27 +1962,12 @@ void mpz_manager<SYNCH>::ensure_capacity(mpz & a, unsigned capacity) {
         capacity = m_init_cell_capacity;
     
     if (is_small(a)) {
-        int val = a.m_val;
+        int64_t val = a.m_val;
         allocate_if_needed(a, capacity);
         a.m_kind = mpz_large;
         SASSERT(a.m_ptr->m_capacity >= capacity);
-        if (val == INT_MIN) {
-            unsigned intmin_sz = m_int_min.m_ptr->m_size;
-            for (unsigned i = 0; i < intmin_sz; i++)
-                a.m_ptr->m_digits[i] = m_int_min.m_ptr->m_digits[i];
-            a.m_val = -1;
-            a.m_ptr->m_size = m_int_min.m_ptr->m_size;
-        }
-        else if (val < 0) {
-            a.m_ptr->m_digits[0] = -val;
-            a.m_val = -1;
-            a.m_ptr->m_size = 1;
-        }
-        else {
-            a.m_ptr->m_digits[0] =  val;
-            a.m_val = 1;
-            a.m_ptr->m_size = 1;
-        }
+        set_abs_digits(val, a.m_ptr);
+        a.m_val = val < 0 ? -1 : 1;
     }
     else if (a.m_ptr->m_capacity < capacity) {
         mpz_cell * new_cell = allocate(capacity);
@@ -2023,10 +1999,10 @@ void mpz_manager<SYNCH>::normalize(mpz & a) {
         return;
     }
     
-    if (i == 1 && ds[0] <= INT_MAX) {
+    int64_t val;
+    if (is_small_digits(i, ds, val)) {
         // a is small
-        int val = a.m_val < 0 ? -static_cast<int>(ds[0]) : static_cast<int>(ds[0]);
-        a.m_val = val;
+        a.m_val = a.m_val < 0 ? -val : val;
         a.m_kind = mpz_small;
         return;
     }
@@ -2040,10 +2016,9 @@ void mpz_manager<SYNCH>::machine_div2k(mpz & a, unsigned k) {
     if (k == 0 || is_zero(a))
         return;
     if (is_small(a)) {
-        if (k < 32) {
-            int64_t twok = 1ull << ((int64_t)k);
-            int64_t val = a.m_val;
-            a.m_val = (int)(val/twok);
+        if (k < 62) {
+            int64_t twok = static_cast<int64_t>(1) << k;
+            a.m_val = i64(a) / twok;
         }
         else {
             a.m_val = 0;
@@ -2097,11 +2072,12 @@ void mpz_manager<SYNCH>::machine_div2k(mpz & a, unsigned k) {
     normalize(a);
 #else
     ensure_mpz_t a1(a);
-    MPZ_BEGIN_CRITICAL();
-    mpz_tdiv_q_2exp(m_tmp, a1(), k);
+    mpz_t tmp;
+    mpz_init(tmp);
+    mpz_tdiv_q_2exp(tmp, a1(), k);
     mk_big(a);
-    mpz_swap(*a.m_ptr, m_tmp);
-    MPZ_END_CRITICAL();
+    mpz_swap(*a.m_ptr, tmp);
+    mpz_clear(tmp);
 #endif    
 }
 
@@ -2109,7 +2085,7 @@ template<bool SYNCH>
 void mpz_manager<SYNCH>::mul2k(mpz & a, unsigned k) {
     if (k == 0 || is_zero(a))
         return;
-    if (is_small(a) && k < 32) {
+    if (is_small(a) && k < 62 && (a.m_val < 0 ? -i64(a) : i64(a)) <= (max_small >> k)) {
         set_i64(a, i64(a) * (static_cast<int64_t>(1) << k));
         return;
     }
@@ -2117,7 +2093,7 @@ void mpz_manager<SYNCH>::mul2k(mpz & a, unsigned k) {
     TRACE("mpz_mul2k", tout << "mul2k\na: " << to_string(a) << "\nk: " << k << "\n";);
     unsigned word_shift  = k / (8 * sizeof(digit_t));
     unsigned bit_shift   = k % (8 * sizeof(digit_t));
-    unsigned old_sz      = is_small(a) ? 1 : a.m_ptr->m_size;
+    unsigned old_sz      = is_small(a) ? sizeof(uint64_t) / sizeof(digit_t) : a.m_ptr->m_size;
     unsigned new_sz      = old_sz + word_shift + 1;
     ensure_capacity(a, new_sz);
     TRACE("mpz_mul2k", tout << "word_shift: " << word_shift << "\nbit_shift: " << bit_shift << "\nold_sz: " << old_sz << "\nnew_sz: " << new_sz 
@@ -2177,7 +2153,11 @@ unsigned mpz_manager<SYNCH>::power_of_two_multiple(mpz const & a) {
         return 0;
     if (is_small(a)) {
         unsigned r = 0;
-        int v      = a.m_val;
+        int64_t v  = a.m_val;
+        if (v % (static_cast<int64_t>(1) << 32) == 0) {
+            r += 32;
+            v /= (static_cast<int64_t>(1) << 32);
+        }
 #define COUNT_DIGIT_RIGHT_ZEROS()               \
         if (v % (1 << 16) == 0) {               \
             r += 16;                            \
@@ -2233,7 +2213,7 @@ unsigned mpz_manager<SYNCH>::log2(mpz const & a) {
     if (is_nonpos(a))
         return 0;
     if (is_small(a))
-        return ::log2((unsigned)a.m_val);
+        return uint64_log2(static_cast<uint64_t>(i64(a)));
 #ifndef _MP_GMP
     static_assert(sizeof(digit_t) == 8 || sizeof(digit_t) == 4, "");
     mpz_cell * c     = a.m_ptr;
@@ -2255,7 +2235,7 @@ unsigned mpz_manager<SYNCH>::mlog2(mpz const & a) {
     if (is_nonneg(a))
         return 0;
     if (is_small(a))
-        return ::log2((unsigned)-a.m_val);
+        return uint64_log2(static_cast<uint64_t>(-i64(a)));
 #ifndef _MP_GMP
     static_assert(sizeof(digit_t) == 8 || sizeof(digit_t) == 4, "");
     mpz_cell * c     = a.m_ptr;
@@ -2266,10 +2246,8 @@ unsigned mpz_manager<SYNCH>::mlog2(mpz const & a) {
     else
         return (sz - 1)*32 + ::log2(static_cast<unsigned>(ds[sz-1]));
 #else
-    MPZ_BEGIN_CRITICAL();
-    mpz_neg(m_tmp, *a.m_ptr);
-    unsigned r = mpz_sizeinbase(m_tmp, 2);
-    MPZ_END_CRITICAL();
+    // the size in base 2 does not depend on the sign.
+    unsigned r = mpz_sizeinbase(*a.m_ptr, 2);
     SASSERT(r > 0);
     return r - 1;
 #endif
@@ -2434,14 +2412,11 @@ template<bool SYNCH>
 bool mpz_manager<SYNCH>::decompose(mpz const & a, svector<digit_t> & digits) {
     digits.reset();
     if (is_small(a)) {
-        if (a.m_val < 0) {
-            digits.push_back(-a.m_val);
-            return true;
-        }
-        else {
-            digits.push_back(a.m_val);
-            return false;
-        }
+        uint64_t v = static_cast<uint64_t>(a.m_val < 0 ? -i64(a) : i64(a));
+        digits.push_back(static_cast<digit_t>(v));
+        if (sizeof(digit_t) < sizeof(uint64_t) && (v >> 32) != 0)
+            digits.push_back(static_cast<digit_t>(v >> 32));
+        return a.m_val < 0;
     }
     else {
 #ifndef _MP_GMP
@@ -2453,16 +2428,18 @@ bool mpz_manager<SYNCH>::decompose(mpz const & a, svector<digit_t> & digits) {
         return a.m_val < 0;
 #else
     bool r = is_neg(a);
-    MPZ_BEGIN_CRITICAL();
-    mpz_set(m_tmp, *a.m_ptr);
-    mpz_abs(m_tmp, m_tmp);
-    while (mpz_sgn(m_tmp) != 0) {
-      mpz_tdiv_r_2exp(m_tmp2, m_tmp, 32);
-      unsigned v = mpz_get_ui(m_tmp2);
+    mpz_t tmp, tmp2;
+    mpz_init(tmp);
+    mpz_init(tmp2);
+    mpz_abs(tmp, *a.m_ptr);
+    while (mpz_sgn(tmp) != 0) {
+      mpz_tdiv_r_2exp(tmp2, tmp, 32);
+      unsigned v = mpz_get_ui(tmp2);
       digits.push_back(v);
-      mpz_tdiv_q_2exp(m_tmp, m_tmp, 32);
+      mpz_tdiv_q_2exp(tmp, tmp, 32);
     }
-    MPZ_END_CRITICAL();
+    mpz_clear(tmp);
+    mpz_clear(tmp2);
     return r;
 #endif
     }
@@ -2472,9 +2449,9 @@ template<bool SYNCH>
 bool mpz_manager<SYNCH>::get_bit(mpz const & a, unsigned index) {
     if (is_small(a)) {
         SASSERT(a.m_val >= 0);
-        if (index >= 8*sizeof(digit_t))
+        if (index >= 62)
             return false;
-        return 0 != (a.m_val & (1ull << (digit_t)index));
+        return 0 != (i64(a) & (static_cast<int64_t>(1) << index));
     }
     unsigned i = index / (sizeof(digit_t)*8);
     unsigned o = index % (sizeof(digit_t)*8);
@@ -75,9 +75,12 @@ class mpz_cell {
    \brief Multi-precision integer.
    
    If m_kind == mpz_small, it is a small number and the value is stored in m_val.
+                           Small numbers are in the range [-(2^61 - 1), 2^61 - 1],
+                           m_val shares a 64 bit word with m_kind and m_owner.
    If m_kind == mpz_large,   the value is stored in m_ptr and m_ptr != nullptr.
                            m_val contains the sign (-1 negative, 1 positive)   
                            under winodws, m_ptr points to a mpz_cell that store the value. 
+   A number is small if and only if it is in the range of small numbers.
 */
 
 enum mpz_kind { mpz_small = 0, mpz_large = 1};
@@ -89,9 +92,9 @@ class mpz {
 #else
     typedef mpz_t mpz_type;
 #endif
-    int        m_val; 
-    unsigned   m_kind:1;
-    unsigned   m_owner:1;
+    uint64_t   m_kind:1;
+    uint64_t   m_owner:1;
+    int64_t    m_val:62;
     mpz_type * m_ptr;
     friend class mpz_manager<true>;
     friend class mpz_manager<false>;
@@ -102,10 +105,10 @@ class mpz {
     friend class mpbq_manager;
     friend class mpz_stack;
 public:
-    mpz(int v):m_val(v), m_kind(mpz_small), m_owner(mpz_self), m_ptr(nullptr) {}
-    mpz():m_val(0), m_kind(mpz_small), m_owner(mpz_self), m_ptr(nullptr) {}
-    mpz(mpz_type* ptr): m_val(0), m_kind(mpz_small), m_owner(mpz_ext), m_ptr(ptr) { SASSERT(ptr);}
-    mpz(mpz && other) noexcept : m_val(other.m_val), m_kind(other.m_kind), m_owner(other.m_owner), m_ptr(nullptr) {
+    mpz(int v):m_kind(mpz_small), m_owner(mpz_self), m_val(v), m_ptr(nullptr) {}
+    mpz():m_kind(mpz_small), m_owner(mpz_self), m_val(0), m_ptr(nullptr) {}
+    mpz(mpz_type* ptr): m_kind(mpz_small), m_owner(mpz_ext), m_val(0), m_ptr(ptr) { SASSERT(ptr);}
+    mpz(mpz && other) noexcept : m_kind(other.m_kind), m_owner(other.m_owner), m_val(other.m_val), m_ptr(nullptr) {
         std::swap(m_ptr, other.m_ptr);
     }
 
@@ -116,7 +119,7 @@ public:
     }
 
     void swap(mpz & other) { 
-        std::swap(m_val, other.m_val);
+        int64_t v = m_val; m_val = other.m_val; other.m_val = v;
         std::swap(m_ptr, other.m_ptr);
         unsigned o = m_owner; m_owner = other.m_owner; other.m_owner = o;
         unsigned k = m_kind; m_kind = other.m_kind; other.m_kind = k;
@@ -141,19 +144,10 @@ inline void swap(mpz & m1, mpz & m2) { m1.swap(m2); }
 template<bool SYNCH = true>
 class mpz_manager {
     mutable small_object_allocator  m_allocator;
-#ifndef SINGLE_THREAD
-    mutable std::recursive_mutex    m_lock;
-#define MPZ_BEGIN_CRITICAL() if (SYNCH) m_lock.lock()
-#define MPZ_END_CRITICAL()   if (SYNCH) m_lock.unlock()
-#else
-#define MPZ_BEGIN_CRITICAL() {}
-#define MPZ_END_CRITICAL()   {}
-#endif
     mutable mpn_manager             m_mpn_manager;
 
 #ifndef _MP_GMP
     unsigned                m_init_cell_capacity;
-    mpz                     m_int_min;
     
     static unsigned cell_size(unsigned capacity) { 
         return sizeof(mpz_cell) + sizeof(digit_t) * capacity; 
@@ -194,7 +188,6 @@ class mpz_manager {
 
 #else
     // GMP code
-    mutable mpz_t     m_tmp, m_tmp2;
     mutable mpz_t     m_two32;
     mpz_t  *  m_arg[2];
     mutable mpz_t     m_uint64_max;
@@ -247,13 +240,32 @@ class mpz_manager {
     mpz                     m_two64;
 
 
-    static int64_t i64(mpz const & a) { return static_cast<int64_t>(a.m_val); }
+    static const int64_t max_small = (static_cast<int64_t>(1) << 61) - 1;
+
+    static bool fits_small(int64_t v) { return -max_small <= v && v <= max_small; }
+
+    static int64_t i64(mpz const & a) { return a.m_val; }
+
+    // return true if the number stored in the first sz digits of ds fits in a small number.
+    static bool is_small_digits(unsigned sz, digit_t const * ds, int64_t & v) {
+        if (sz * sizeof(digit_t) > sizeof(uint64_t))
+            return false;
+        uint64_t r = sz == 0 ? 0 : static_cast<uint64_t>(ds[0]);
+        if (sz == 2)
+            r |= static_cast<uint64_t>(ds[1]) << 32;
+        if (r > static_cast<uint64_t>(max_small))
+            return false;
+        v = static_cast<int64_t>(r);
+        return true;
+    }
+
+    static unsigned hash_i64(int64_t v) { return static_cast<unsigned>(v) ^ static_cast<unsigned>(static_cast<uint64_t>(v) >> 32); }
 
     void set_big_i64(mpz & c, int64_t v);
 
     void set_i64(mpz & c, int64_t v) {
-        if (v >= INT_MIN && v <= INT_MAX) {
-            c.m_val = static_cast<int>(v); 
+        if (fits_small(v)) {
+            c.m_val = v; 
             c.m_kind = mpz_small;
         }
         else {
@@ -261,6 +273,23 @@ class mpz_manager {
         }
     }
 
+    // c <- a * b for small a and b. The product of two small numbers may not fit in 64 bits.
+    void mul_small(mpz const & a, mpz const & b, mpz & c) {
+        int64_t r;
+#if defined(__GNUC__) || defined(__clang__)
+        if (!__builtin_mul_overflow(i64(a), i64(b), &r)) {
+            set_i64(c, r);
+            return;
+        }
+#else
+        if (-INT_MAX <= i64(a) && i64(a) <= INT_MAX && -INT_MAX <= i64(b) && i64(b) <= INT_MAX) {
+            set_i64(c, i64(a) * i64(b));
+            return;
+        }
+#endif
+        big_mul(a, b, c);
+    }
+
     void set_big_ui64(mpz & c, uint64_t v);
 
 
@@ -309,24 +338,22 @@ class mpz_manager {
         mpz_cell const* cell() { return m_cell; }
     };
 
+    // store the absolute value of the small number v in cell, which has capacity for at least 64 bits.
+    static void set_abs_digits(int64_t a, mpz_cell * cell) {
+        uint64_t v = static_cast<uint64_t>(a < 0 ? -a : a);
+        cell->m_digits[0] = static_cast<digit_t>(v);
+        cell->m_size = 1;
+        if (sizeof(digit_t) < sizeof(uint64_t) && (v >> 32) != 0) {
+            cell->m_digits[1] = static_cast<digit_t>(v >> 32);
+            cell->m_size = 2;
+        }
+    }
+
     void get_sign_cell(mpz const & a, int & sign, mpz_cell * & cell, mpz_cell* reserve) {
         if (is_small(a)) {
-            if (a.m_val == INT_MIN) {
-                sign = -1;
-                cell = m_int_min.m_ptr;
-            }
-            else {
-                cell = reserve;
-                cell->m_size = 1;
-                if (a.m_val < 0) {
-                    sign = -1;
-                    cell->m_digits[0] = -a.m_val;
-                }
-                else {
-                    sign = 1;
-                    cell->m_digits[0] = a.m_val;
-                }
-            }
+            cell = reserve;
+            sign = a.m_val < 0 ? -1 : 1;
+            set_abs_digits(i64(a), cell);
         }
         else {
             sign = a.m_val;
@@ -451,10 +478,10 @@ public:
 
     static int sign(mpz const & a) {
 #ifndef _MP_GMP
-        return a.m_val;
+        return static_cast<int>(a.m_val > 0) - static_cast<int>(a.m_val < 0);
 #else
         if (is_small(a))
-            return a.m_val;
+            return static_cast<int>(a.m_val > 0) - static_cast<int>(a.m_val < 0);
         else
             return mpz_sgn(*a.m_ptr);
 #endif
@@ -545,10 +572,8 @@ public:
     }
 
     void set(mpz & a, unsigned val) {
-        if (val <= INT_MAX)
-            set(a, static_cast<int>(val));
-        else
-            set(a, static_cast<int64_t>(static_cast<uint64_t>(val)));
+        a.m_val = val;
+        a.m_kind = mpz_small;
     }
 
     void set(mpz & a, char const * val);
@@ -558,8 +583,8 @@ public:
     }
 
     void set(mpz & a, uint64_t val) {
-        if (val < INT_MAX) {
-            a.m_val = static_cast<int>(val);
+        if (val <= static_cast<uint64_t>(max_small)) {
+            a.m_val = static_cast<int64_t>(val);
             a.m_kind = mpz_small;
         }
         else {
@@ -579,10 +604,7 @@ public:
     void reset(mpz & a);
 
     void swap(mpz & a, mpz & b) {
-        std::swap(a.m_val, b.m_val);
-        std::swap(a.m_ptr, b.m_ptr);
-        auto o = a.m_owner; a.m_owner = b.m_owner; b.m_owner = o;
-        auto k = a.m_kind; a.m_kind = b.m_kind; b.m_kind = k;
+        a.swap(b);
     }
 
     bool is_uint64(mpz const & a) const;
@@ -25,6 +25,8 @@ struct lock_guard {
   lock_guard(mutex &) {}
 };
 
+typedef mutex recursive_mutex;
+
 #define DECLARE_MUTEX(name) mutex *name = nullptr
 #define DECLARE_INIT_MUTEX(name) mutex *name = nullptr
 #define ALLOC_MUTEX(name) (void)0
@@ -37,6 +39,7 @@ struct lock_guard {
 template<typename T> using atomic = std::atomic<T>;
 typedef std::mutex mutex;
 typedef std::lock_guard<std::mutex> lock_guard;
+typedef std::recursive_mutex recursive_mutex;
 
 #define DECLARE_MUTEX(name) mutex *name = nullptr
 #define DECLARE_INIT_MUTEX(name) mutex *name = new mutex
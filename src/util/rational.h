@@ -114,8 +114,7 @@ public:
     }
 
     bool is_int32() const {
-        if (is_small() && is_int()) return true; 
-        // we don't assume that if it is small, then it is int32.
+        // small numbers do not necessarily fit in 32 bits.
         if (!is_int64()) return false;
         int64_t v = get_int64();
         return INT_MIN <= v && v <= INT_MAX;
@@ -54,6 +54,9 @@ public:
     void undo() override {
         m_value = m_old_value;
     }
+
+    T & get_value() const { return m_value; }
+    T const & get_old_value() const { return m_old_value; }
 };
 
 
@@ -179,6 +182,8 @@ public:
     insert_obj_map(obj_map<D,R>& t, D* o) : m_map(t), m_obj(o) {}
     ~insert_obj_map() override {}
     void undo() override { m_map.remove(m_obj); }
+    obj_map<D,R> & get_map() const { return m_map; }
+    D * get_obj() const { return m_obj; }
 };
 
 template<typename D, typename R>
@@ -238,6 +243,8 @@ public:
     void undo() override {
         m_vector.pop_back();
     }
+
+    V & get_vector() const { return m_vector; }
 };
 
 template<typename T>
@@ -304,6 +311,8 @@ public:
     void undo() override {
         m_vector.pop_back();
     }
+
+    vector<T, CallDestructors> & get_vector() const { return m_vector; }
 };
 
 template<typename T, bool CallDestructors=true>
@@ -458,3 +467,123 @@ public:
     }
 };
 
+/**
+   \brief Undo stack that keeps the most common kinds of trail objects as
+   typed entries of a single array instead of allocating them in a region:
+   updates of unsigned and Boolean values, push backs on vectors, and inserts
+   into obj_maps. Other trail objects are kept as pointers and undone using
+   trail::undo.
+
+   Entries are undone in the reverse order they were pushed, dispatching on
+   their kind instead of calling a virtual method. Consecutive push backs on
+   the same vector share an entry and are undone together.
+   The size of the stack counts every update pushed, so it can be used to
+   record scopes as for ptr_vector<trail>.
+*/
+class typed_trail {
+    enum kind : unsigned char { GENERIC, UNSIGNED_VALUE, BOOL_VALUE, PUSH_BACK, MAP_INSERT };
+
+    struct entry {
+        void *   m_ptr;      // trail object, value, vector or map
+        void *   m_obj;      // object inserted into the map
+        void (*m_undo)(void * ptr, void * obj, unsigned n);
+        unsigned m_value;    // old value or number of push backs
+        kind     m_kind;
+    };
+
+    unsigned       m_size { 0 };
+    svector<entry> m_entries;
+
+    template<typename V>
+    static void pop_back_vector(void * v, void *, unsigned n) {
+        V & vec = *static_cast<V *>(v);
+        while (n-- > 0)
+            vec.pop_back();
+    }
+
+    template<typename D, typename R>
+    static void remove_obj(void * m, void * obj, unsigned) {
+        static_cast<obj_map<D, R> *>(m)->remove(static_cast<D *>(obj));
+    }
+
+    template<bool Undo>
+    void pop_entries(unsigned old_size) {
+        SASSERT(old_size <= m_size);
+        unsigned n = m_size - old_size;
+        unsigned i = m_entries.size();
+        while (n > 0) {
+            entry & e = m_entries[--i];
+            if (e.m_kind == PUSH_BACK && e.m_value > n) {
+                // a scope was opened between push backs on the same vector.
+                if (Undo)
+                    e.m_undo(e.m_ptr, nullptr, n);
+                e.m_value -= n;
+                ++i;
+                break;
+            }
+            if (Undo) {
+                switch (e.m_kind) {
+                case GENERIC:        static_cast<trail *>(e.m_ptr)->undo(); break;
+                case UNSIGNED_VALUE: *static_cast<unsigned *>(e.m_ptr) = e.m_value; break;
+                case BOOL_VALUE:     *static_cast<bool *>(e.m_ptr) = e.m_value != 0; break;
+                case PUSH_BACK:      e.m_undo(e.m_ptr, nullptr, e.m_value); break;
+                case MAP_INSERT:     e.m_undo(e.m_ptr, e.m_obj, 1); break;
+                }
+            }
+            n -= e.m_kind == PUSH_BACK ? e.m_value : 1;
+        }
+        m_entries.shrink(i);
+        m_size = old_size;
+    }
+
+    void push_entry(kind k, void * ptr, unsigned value) {
+        m_entries.push_back({ ptr, nullptr, nullptr, value, k });
+        ++m_size;
+    }
+
+public:
+
+    unsigned size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    void push_ptr(trail * t) { push_entry(GENERIC, t, 0); }
+
+    /**
+       \brief Record the old value of v. It is restored on undo.
+    */
+    void push_value(unsigned & v, unsigned old_value) { push_entry(UNSIGNED_VALUE, &v, old_value); }
+
+    void push_value(bool & v, bool old_value) { push_entry(BOOL_VALUE, &v, old_value); }
+
+    /**
+       \brief Record that an element was pushed on v. It is removed on undo.
+    */
+    template<typename V>
+    void push_back(V & v) {
+        ++m_size;
+        if (!m_entries.empty() && m_entries.back().m_kind == PUSH_BACK && m_entries.back().m_ptr == &v)
+            m_entries.back().m_value++;
+        else
+            m_entries.push_back({ &v, nullptr, &pop_back_vector<V>, 1, PUSH_BACK });
+    }
+
+    /**
+       \brief Record that obj was inserted into m. It is removed on undo.
+    */
+    template<typename D, typename R>
+    void push_insert(obj_map<D, R> & m, D * obj) {
+        ++m_size;
+        m_entries.push_back({ &m, obj, &remove_obj<D, R>, 1, MAP_INSERT });
+    }
+
+    /**
+       \brief Undo updates until the size of the stack is old_size.
+    */
+    void undo(unsigned old_size) { pop_entries<true>(old_size); }
+
+    /**
+       \brief Remove updates until the size of the stack is old_size without undoing them.
+    */
+    void shrink(unsigned old_size) { pop_entries<false>(old_size); }
+};